@@ -0,0 +1,692 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme-bench.cc
+///
+
+// ACME MICRO-BENCHMARKS
+//
+// Usage: acme-bench [options]
+//   --filter TEXT       run only the benchmarks whose name contains TEXT
+//   --samples N         number of timed samples per benchmark (default 7)
+//   --time MS           target time per sample in milliseconds (default 20)
+//   --output FILE       write the results to FILE (CSV)
+//   --baseline FILE     compare the results with a stored CSV baseline
+//   --threshold X       relative slowdown flagged as regression (default 0.10)
+//   --road-max N        largest generated road mesh in triangles (default 100000),
+//                       sizes are 10k, 100k, 1M and 10M triangles up to N
+//   --counters          read the hardware performance counters (Linux perf_event)
+//
+// Results are printed as CSV (name,size,samples,ops,ns_per_op,median_ns,stddev_ns,ops_per_s),
+// times are per operation in nanoseconds. With --counters the rows also report cycles,
+// instructions, L1 data cache read misses, last level cache misses and branch misses per
+// operation, counted in user space over the timed samples (empty when a counter is not
+// available, e.g. perf_event_paranoid too high or no PMU in a virtual machine). With a baseline, benchmarks whose median is
+// slower than the baseline median by more than the threshold (and by more than twice
+// the standard deviation) are reported on standard error and the program exits with
+// status 1.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+#include "acme_workload.hh"
+
+using namespace acme;
+
+// Benchmark result
+struct result
+{
+  std::string name; // Benchmark name
+  integer size;     // Data size (number of primitives, 1 for kernels)
+  integer samples;  // Number of timed samples
+  integer ops;      // Operations per sample
+  real ns_per_op;   // Mean time per operation [ns]
+  real median_ns;   // Median time per operation [ns]
+  real stddev_ns;   // Standard deviation of the time per operation [ns]
+  real ops_per_s;   // Throughput [ops/s]
+  real counts[5];   // Hardware counters per operation (NaN if not available)
+};
+
+// Benchmark options
+struct options
+{
+  std::string filter;        // Name filter
+  integer samples = 7;       // Timed samples per benchmark
+  real time = 20.0;          // Target time per sample [ms]
+  std::string output;        // Output CSV file
+  std::string baseline;      // Baseline CSV file
+  real threshold = 0.10;     // Relative regression threshold
+  integer road_max = 100000; // Largest road mesh [triangles]
+  bool counters = false;     // Read the hardware performance counters
+};
+
+static options opts;
+static std::vector<result> results;
+static volatile real sink = 0.0; // Keeps the benchmarked work observable
+
+// Hardware performance counters (Linux perf_event), opened once for the calling thread
+class counters
+{
+public:
+  static integer const COUNTERS = 5; // Number of counters
+
+  // Counter names (CSV columns)
+  static char const *
+  name(integer i)
+  {
+    static char const *names[COUNTERS] = {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+    return names[i];
+  }
+
+  counters(void)
+  {
+    for (integer i = 0; i < COUNTERS; ++i)
+      this->m_fd[i] = -1;
+#ifdef __linux__
+    uint32_t types[COUNTERS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+    uint64_t configs[COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                  PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                                  PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (integer i = 0; i < COUNTERS; ++i)
+    {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = types[i];
+      attr.config = configs[i];
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      this->m_fd[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+  }
+
+  ~counters(void)
+  {
+#ifdef __linux__
+    for (integer i = 0; i < COUNTERS; ++i)
+      if (this->m_fd[i] >= 0)
+        close(this->m_fd[i]);
+#endif
+  }
+
+  // Check if at least one counter is available
+  bool
+  isAvailable(void) const
+  {
+    for (integer i = 0; i < COUNTERS; ++i)
+      if (this->m_fd[i] >= 0)
+        return true;
+    return false;
+  }
+
+  // Reset and start the counters
+  void
+  start(void)
+  {
+#ifdef __linux__
+    for (integer i = 0; i < COUNTERS; ++i)
+      if (this->m_fd[i] >= 0)
+      {
+        ioctl(this->m_fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(this->m_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+  }
+
+  // Stop the counters and get their values (scaled when multiplexed, NaN if not available)
+  void
+  stop(real counts[COUNTERS])
+  {
+    for (integer i = 0; i < COUNTERS; ++i)
+    {
+      counts[i] = QUIET_NAN;
+#ifdef __linux__
+      if (this->m_fd[i] < 0)
+        continue;
+      ioctl(this->m_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+      uint64_t values[3]; // Value, time enabled and time running
+      if (read(this->m_fd[i], values, sizeof(values)) == sizeof(values) && values[2] > 0)
+        counts[i] = real(values[0]) * real(values[1]) / real(values[2]);
+#endif
+    }
+  }
+
+private:
+  int m_fd[COUNTERS]; // Counter file descriptors (-1 if not available)
+};
+
+static counters *hardware = nullptr; // Hardware counters (with --counters)
+
+// Print the CSV header
+void
+header(std::ostream &stream)
+{
+  stream << "name,size,samples,ops,ns_per_op,median_ns,stddev_ns,ops_per_s";
+  if (opts.counters)
+    for (integer i = 0; i < counters::COUNTERS; ++i)
+      stream << "," << counters::name(i) << "_per_op";
+  stream << std::endl;
+}
+
+// Print a result as a CSV row
+void
+print(std::ostream &stream, result const &r)
+{
+  stream
+      << r.name << "," << r.size << "," << r.samples << "," << r.ops << ","
+      << r.ns_per_op << "," << r.median_ns << "," << r.stddev_ns << "," << r.ops_per_s;
+  if (opts.counters)
+    for (integer i = 0; i < counters::COUNTERS; ++i)
+    {
+      stream << ",";
+      if (!std::isnan(r.counts[i]))
+        stream << r.counts[i];
+    }
+  stream << std::endl;
+}
+
+// Time a benchmark body (called with the operation index, returns a value to sink)
+template <typename body_fn>
+void
+run(std::string const &name, integer size, body_fn body)
+{
+  if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos)
+    return;
+  typedef std::chrono::steady_clock clock;
+
+  // Calibrate the operations per sample on the target sample time
+  integer ops = 1;
+  real acc = 0.0;
+  for (;;)
+  {
+    clock::time_point start = clock::now();
+    for (integer i = 0; i < ops; ++i)
+      acc += body(i);
+    real ms = std::chrono::duration<real, std::milli>(clock::now() - start).count();
+    if (ms >= opts.time || ops >= (1 << 28))
+      break;
+    ops = ms <= 0.0 ? 2 * ops : std::max(2 * ops, integer(ops * 1.2 * opts.time / ms));
+  }
+
+  // Timed samples (counted as a whole by the hardware counters)
+  real counts[counters::COUNTERS];
+  std::vector<real> ns(opts.samples);
+  if (hardware != nullptr)
+    hardware->start();
+  for (integer s = 0; s < opts.samples; ++s)
+  {
+    clock::time_point start = clock::now();
+    for (integer i = 0; i < ops; ++i)
+      acc += body(i);
+    ns[s] = std::chrono::duration<real, std::nano>(clock::now() - start).count() / ops;
+  }
+  if (hardware != nullptr)
+    hardware->stop(counts);
+  else
+    std::fill(counts, counts + counters::COUNTERS, QUIET_NAN);
+  sink = sink + acc;
+
+  real mean = 0.0;
+  for (integer s = 0; s < opts.samples; ++s)
+    mean += ns[s];
+  mean /= opts.samples;
+  real variance = 0.0;
+  for (integer s = 0; s < opts.samples; ++s)
+    variance += (ns[s] - mean) * (ns[s] - mean);
+  variance /= opts.samples > 1 ? opts.samples - 1 : 1;
+
+  result r;
+  r.name = name;
+  r.size = size;
+  r.samples = opts.samples;
+  r.ops = ops;
+  r.ns_per_op = mean;
+  std::sort(ns.begin(), ns.end());
+  r.median_ns = ns[opts.samples / 2];
+  r.stddev_ns = std::sqrt(variance);
+  r.ops_per_s = mean > 0.0 ? 1.0e9 / mean : 0.0;
+  for (integer i = 0; i < counters::COUNTERS; ++i)
+    r.counts[i] = counts[i] / (real(ops) * opts.samples);
+  results.push_back(r);
+  print(std::cout, r);
+}
+
+// Terrain of 2*n*n triangles on a wavy grid
+void
+terrain(collection &terrain_out, integer n)
+{
+  terrain_out.clear();
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point p0(i, j, 0.2 * std::sin(0.3 * i) * std::cos(0.2 * j));
+      point p1(i + 1, j, 0.2 * std::sin(0.3 * (i + 1)) * std::cos(0.2 * j));
+      point p2(i + 1, j + 1, 0.2 * std::sin(0.3 * (i + 1)) * std::cos(0.2 * (j + 1)));
+      point p3(i, j + 1, 0.2 * std::sin(0.3 * i) * std::cos(0.2 * (j + 1)));
+      terrain_out.push_back(std::make_shared<triangle>(p0, p1, p2));
+      terrain_out.push_back(std::make_shared<triangle>(p0, p2, p3));
+    }
+}
+
+// Pseudo-random query position in [0, n) (deterministic)
+real
+position(integer i, integer n, integer salt)
+{
+  unsigned int h = static_cast<unsigned int>(i) * 2654435761u + static_cast<unsigned int>(salt) * 40503u;
+  h ^= h >> 15;
+  return n * (h % 65536) / 65536.0;
+}
+
+// Pairwise intersection kernels through the entity dispatcher
+void
+kernels(void)
+{
+  // General configuration: entities crossing each other near the origin
+  std::vector<std::pair<std::string, entity::ptr>> general;
+  general.push_back(std::make_pair("point", entity::ptr(new point(0.0, 0.0, 0.0))));
+  general.push_back(std::make_pair("line", entity::ptr(new line(point(0.0, 0.0, 0.0), vec3(1.0, 0.3, 0.2)))));
+  general.push_back(std::make_pair("ray", entity::ptr(new ray(point(0.0, 0.0, 1.0), vec3(0.1, 0.2, -1.0)))));
+  general.push_back(std::make_pair("plane", entity::ptr(new plane(point(0.0, 0.0, 0.0), vec3(0.0, 0.0, 1.0)))));
+  general.push_back(std::make_pair("segment", entity::ptr(new segment(point(-1.0, -0.5, -1.0), point(1.0, 0.5, 1.0)))));
+  general.push_back(std::make_pair("triangle", entity::ptr(new triangle(point(-1.0, -1.0, 0.1), point(1.0, -1.0, -0.1), point(0.0, 1.0, 0.0)))));
+  general.push_back(std::make_pair("disk", entity::ptr(new disk(1.0, point(0.0, 0.0, 0.0), vec3(0.0, 1.0, 0.2)))));
+  general.push_back(std::make_pair("ball", entity::ptr(new ball(1.0, point(0.0, 0.0, 0.0)))));
+
+  // Coplanar configuration: entities laying on the z = 0 plane
+  std::vector<std::pair<std::string, entity::ptr>> coplanar;
+  coplanar.push_back(std::make_pair("point", entity::ptr(new point(0.1, 0.1, 0.0))));
+  coplanar.push_back(std::make_pair("line", entity::ptr(new line(point(0.0, 0.0, 0.0), vec3(1.0, 0.3, 0.0)))));
+  coplanar.push_back(std::make_pair("ray", entity::ptr(new ray(point(-2.0, 0.0, 0.0), vec3(1.0, 0.1, 0.0)))));
+  coplanar.push_back(std::make_pair("plane", entity::ptr(new plane(point(0.0, 0.0, 0.0), vec3(0.0, 0.0, 1.0)))));
+  coplanar.push_back(std::make_pair("segment", entity::ptr(new segment(point(-1.0, -0.5, 0.0), point(1.0, 0.5, 0.0)))));
+  coplanar.push_back(std::make_pair("triangle", entity::ptr(new triangle(point(-1.0, -1.0, 0.0), point(1.0, -1.0, 0.0), point(0.0, 1.0, 0.0)))));
+  coplanar.push_back(std::make_pair("disk", entity::ptr(new disk(0.8, point(0.2, 0.0, 0.0), vec3(0.0, 0.0, 1.0)))));
+
+  // Collinear configuration: entities laying on the x axis
+  std::vector<std::pair<std::string, entity::ptr>> collinear;
+  collinear.push_back(std::make_pair("line", entity::ptr(new line(point(0.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0)))));
+  collinear.push_back(std::make_pair("ray", entity::ptr(new ray(point(-1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0)))));
+  collinear.push_back(std::make_pair("segment", entity::ptr(new segment(point(-0.5, 0.0, 0.0), point(1.5, 0.0, 0.0)))));
+
+  std::vector<std::pair<std::string, std::vector<std::pair<std::string, entity::ptr>> *>> configurations;
+  configurations.push_back(std::make_pair("general", &general));
+  configurations.push_back(std::make_pair("coplanar", &coplanar));
+  configurations.push_back(std::make_pair("collinear", &collinear));
+
+  for (size_t c = 0; c < configurations.size(); ++c)
+  {
+    std::vector<std::pair<std::string, entity::ptr>> const &entities = *configurations[c].second;
+    for (size_t i = 0; i < entities.size(); ++i)
+      for (size_t j = 0; j < entities.size(); ++j)
+      {
+        entity const *entity0 = entities[i].second.get();
+        entity const *entity1 = entities[j].second.get();
+
+        // Skip the pairs not supported by the dispatcher
+        bool supported = true;
+#ifdef ACME_NO_EXCEPTIONS
+        clearStatus();
+        delete intersection(entity0, entity1);
+        supported = lastStatus() == STATUS_OK;
+#else
+        try
+        {
+          delete intersection(entity0, entity1);
+        }
+        catch (std::exception const &)
+        {
+          supported = false;
+        }
+#endif
+        if (!supported)
+          continue;
+
+        run("intersection/" + configurations[c].first + "/" + entities[i].first + "-" + entities[j].first, 1,
+            [entity0, entity1](integer) {
+              entity *entity_out = intersection(entity0, entity1);
+              real level = entity_out->level();
+              delete entity_out;
+              return level;
+            });
+      }
+  }
+
+  // Typed kernels used by the collection queries (no dispatch and no allocation)
+  triangle Triangle(point(-1.0, -1.0, 0.1), point(1.0, -1.0, -0.1), point(0.0, 1.0, 0.0));
+  triangleRecord Record(Triangle);
+  ray Ray(point(0.0, 0.0, 1.0), vec3(0.1, 0.2, -1.0));
+  segment Segment(point(-0.2, -0.1, -1.0), point(0.2, 0.1, 1.0));
+  ball Ball(0.5, point(0.0, 0.0, 0.3));
+  run("kernel/ray-triangle", 1, [&](integer) { point p; return real(intersection(Ray, Triangle, p)); });
+  run("kernel/ray-triangleRecord", 1, [&](integer) { point p; return real(intersection(Ray, Record, p)); });
+  point Point(0.1, 0.1, 0.0);
+  run("kernel/point-triangle", 1, [&](integer) { point p; return real(intersection(Point, Triangle, p)); });
+  run("kernel/segment-triangle", 1, [&](integer) { point p; return real(intersection(Segment, Triangle, p)); });
+  run("kernel/ball-triangle-swept", 1, [&](integer) {
+    real time;
+    point p;
+    vec3 n;
+    return real(intersection(Ball, vec3(0.0, 0.0, -1.0), Triangle, time, p, n)) + time;
+  });
+}
+
+// Axis-aligned box operations
+void
+boxes(void)
+{
+  aabb Box0(-1.0, -1.0, -1.0, 1.0, 1.0, 1.0);
+  aabb Box1(0.5, 0.5, 0.5, 2.0, 2.0, 2.0);
+  point Origin(-2.0, 0.1, 0.2);
+  vec3 Inverse = vec3(1.0, 0.1, 0.05).cwiseInverse();
+  run("aabb/intersects-aabb", 1, [&](integer) { return real(Box0.intersects(Box1)); });
+  run("aabb/intersects-ray", 1, [&](integer) {
+    real t_entry, t_exit;
+    return real(Box0.intersects(Origin, Inverse, t_entry, t_exit)) + t_entry;
+  });
+  run("aabb/exteriorDistance", 1, [&](integer) { return Box0.exteriorDistance(Origin); });
+
+  integer sizes[] = {16, 256, 4096};
+  for (integer size : sizes)
+  {
+    aabb::vecptr ptrVecbox;
+    for (integer i = 0; i < size; ++i)
+    {
+      real x = position(i, 100, 1), y = position(i, 100, 2), z = position(i, 100, 3);
+      ptrVecbox.push_back(std::make_shared<aabb>(x, y, z, x + 1.0, y + 1.0, z + 1.0, i, 0));
+    }
+    aabb Merged;
+    run("aabb/merged", size, [&](integer) { Merged.merged(ptrVecbox); return Merged.max(0); });
+  }
+}
+
+// AABB tree build, tree-vs-tree and collection shape queries
+void
+trees(void)
+{
+  // The AABB tree has a single build strategy (longest axis midpoint split)
+  integer grids[] = {16, 64, 256};
+  for (integer n : grids)
+  {
+    collection Terrain;
+    terrain(Terrain, n);
+    integer size = Terrain.size();
+    aabb::vecptr ptrVecbox;
+    Terrain.clamp(ptrVecbox);
+    run("AABBtree/build/midpoint", size, [&](integer) {
+      AABBtree Tree;
+      Tree.build(ptrVecbox);
+      return real(Tree.isEmpty());
+    });
+    Terrain.buildAABBtree();
+
+    // Tree-vs-tree with a translated copy of the terrain
+    collection Shifted(Terrain);
+    Shifted.translate(vec3(0.3, 0.3, 0.0));
+    Shifted.buildAABBtree();
+    aabb::vecpairid Pairs;
+    run("AABBtree/tree-vs-tree", size, [&](integer) {
+      Terrain.ptrAABBtree()->intersection(*Shifted.ptrAABBtree(), Pairs);
+      return real(Pairs.size());
+    });
+
+    // Shape queries through the collection AABB tree
+    context Context;
+    integer id;
+    point Point;
+    run("collection/ray", size, [&](integer i) {
+      ray Ray(point(position(i, n, 1), position(i, n, 2), 2.0), vec3(0.1, 0.1, -1.0));
+      return real(Terrain.intersection(Ray, id, Point, Context));
+    });
+    run("collection/segment", size, [&](integer i) {
+      real x = position(i, n, 3), y = position(i, n, 4);
+      segment Segment(point(x, y, 1.0), point(x + 0.5, y + 0.5, -1.0));
+      return real(Terrain.intersection(Segment, id, Point, Context));
+    });
+    real depth;
+    vec3 Normal;
+    std::vector<integer> Ids;
+    run("collection/ball", size, [&](integer i) {
+      ball Ball(0.5, point(position(i, n, 5), position(i, n, 6), 0.2));
+      Terrain.intersection(Ball, depth, Normal, Ids, Point, Context);
+      return real(Ids.size());
+    });
+    std::vector<segment> Segments;
+    std::vector<vec3> Normals;
+    run("collection/disk", size, [&](integer i) {
+      disk Disk(0.5, point(position(i, n, 7), position(i, n, 8), 0.1), vec3(0.0, 1.0, 0.0));
+      Terrain.intersection(Disk, Segments, Ids, Normals, Context);
+      return real(Segments.size());
+    });
+    real time;
+    run("collection/ball-swept", size, [&](integer i) {
+      ball Ball(0.3, point(position(i, n, 9), position(i, n, 10), 1.0));
+      return real(Terrain.intersection(Ball, vec3(0.5, 0.0, -1.5), time, id, Normal, Point, Context));
+    });
+  }
+}
+
+// Road scaling: mesh generation, tree build and vehicle workload replay
+void
+roads(void)
+{
+  integer sizes[] = {10000, 100000, 1000000, 10000000};
+  for (integer target : sizes)
+  {
+    if (target > opts.road_max)
+      break;
+    road Road(1, 2000.0);
+    Road.features(100, 2);
+    Road.fit(target);
+    integer size = Road.size();
+    collection Terrain;
+    run("road/generate", size, [&](integer) {
+      Terrain.clear();
+      Road.generate(Terrain);
+      return real(Terrain.size());
+    });
+    run("road/build", size, [&](integer) {
+      Terrain.markDirty();
+      Terrain.buildAABBtree();
+      return real(Terrain.ptrAABBtree()->isEmpty());
+    });
+
+    // 1% of the triangles move up and down at each step
+    run("road/refit-1%", size, [&](integer i) {
+      vec3 Lift(0.0, 0.0, i % 2 == 0 ? 0.01 : -0.01);
+      for (integer j = (i / 2) % 100; j < size; j += 100)
+        Terrain.modify(j)->translate(Lift);
+      Terrain.refitAABBtree();
+      return real(Terrain.countDirty());
+    });
+
+    // Replay of four tires and a sensor fan per frame
+    workload Workload;
+    Workload.generate(Road, 1000, 16, 1);
+    context Context;
+    std::vector<segment> Segments;
+    std::vector<integer> Ids;
+    std::vector<vec3> Normals;
+    integer id;
+    point Point;
+    run("road/tires-frame", size, [&](integer i) {
+      integer frame = i % Workload.frames();
+      real segments = 0.0;
+      for (integer w = 0; w < 4; ++w)
+      {
+        Terrain.intersection(Workload.tire(frame, w), Segments, Ids, Normals, Context);
+        segments += Segments.size();
+      }
+      return segments;
+    });
+    run("road/sensor-ray", size, [&](integer i) {
+      integer frame = (i / Workload.rays()) % Workload.frames();
+      return real(Terrain.intersection(Workload.sensor(frame, i % Workload.rays()), id, Point, Context));
+    });
+  }
+}
+
+// Load a baseline CSV file (name and size to median time per operation and deviation)
+bool
+load(std::string const &file, std::map<std::string, std::pair<real, real>> &baseline)
+{
+  std::ifstream stream(file);
+  if (!stream)
+    return false;
+  std::string row;
+  while (std::getline(stream, row))
+  {
+    std::vector<std::string> fields;
+    std::stringstream fields_stream(row);
+    std::string field;
+    while (std::getline(fields_stream, field, ','))
+      fields.push_back(field);
+    if (fields.size() < 8 || fields[0] == "name")
+      continue;
+    baseline[fields[0] + "," + fields[1]] = std::make_pair(std::atof(fields[5].c_str()), std::atof(fields[6].c_str()));
+  }
+  return true;
+}
+
+// Main function
+int main(int argc, char const *argv[])
+{
+  for (integer i = 1; i < argc; ++i)
+  {
+    std::string arg(argv[i]);
+    bool value = i + 1 < argc;
+    if (arg == "--filter" && value)
+      opts.filter = argv[++i];
+    else if (arg == "--samples" && value)
+      opts.samples = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--time" && value)
+      opts.time = std::atof(argv[++i]);
+    else if (arg == "--output" && value)
+      opts.output = argv[++i];
+    else if (arg == "--baseline" && value)
+      opts.baseline = argv[++i];
+    else if (arg == "--threshold" && value)
+      opts.threshold = std::atof(argv[++i]);
+    else if (arg == "--road-max" && value)
+      opts.road_max = std::atoi(argv[++i]);
+    else if (arg == "--counters")
+      opts.counters = true;
+    else
+    {
+      std::cerr
+          << "Usage: acme-bench [--filter TEXT] [--samples N] [--time MS]"
+          << " [--output FILE] [--baseline FILE] [--threshold X] [--road-max N] [--counters]" << std::endl;
+      return 2;
+    }
+  }
+
+  counters Hardware;
+  if (opts.counters)
+  {
+    if (Hardware.isAvailable())
+      hardware = &Hardware;
+    else
+      std::cerr << "acme-bench: hardware counters not available, the counter columns are left empty" << std::endl;
+  }
+
+  header(std::cout);
+  kernels();
+  boxes();
+  trees();
+  roads();
+
+  if (!opts.output.empty())
+  {
+    std::ofstream stream(opts.output);
+    header(stream);
+    for (size_t i = 0; i < results.size(); ++i)
+      print(stream, results[i]);
+  }
+
+  // Regressions against the baseline
+  integer regressions = 0;
+  if (!opts.baseline.empty())
+  {
+    std::map<std::string, std::pair<real, real>> baseline;
+    if (!load(opts.baseline, baseline))
+    {
+      std::cerr << "acme-bench: cannot read baseline " << opts.baseline << std::endl;
+      return 2;
+    }
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      result const &r = results[i];
+      std::stringstream key;
+      key << r.name << "," << r.size;
+      std::map<std::string, std::pair<real, real>>::const_iterator it = baseline.find(key.str());
+      if (it == baseline.end())
+        continue;
+      real base = it->second.first;
+      real noise = 2.0 * std::max(r.stddev_ns, it->second.second);
+      if (r.median_ns > base * (1.0 + opts.threshold) && r.median_ns - base > noise)
+      {
+        std::cerr
+            << "REGRESSION " << key.str() << ": " << r.median_ns << " ns/op (baseline "
+            << base << " ns/op, +" << 100.0 * (r.median_ns / base - 1.0) << "%)" << std::endl;
+        ++regressions;
+      }
+    }
+    std::cerr << "acme-bench: " << regressions << " regressions against " << opts.baseline << std::endl;
+  }
+
+  return regressions == 0 ? 0 : 1;
+}
+
+///
+/// eof: acme-bench.cc
+///
@@ -0,0 +1,195 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme-replay.cc
+///
+
+// ACME QUERY TRACE REPLAY
+//
+// Usage: acme-replay TRACE [options]
+//   --repeat N          executions of each query, the fastest is kept (default 1)
+//   --tolerance X       tolerance on the result summary values (default 1e-9)
+//   --slowest N         list the N slowest recorded queries (default 10)
+//   --output FILE       write the per query timings to FILE (CSV)
+//
+// The trace is written by an acme::recorder set on a collection. The replay rebuilds
+// the recorded collection snapshot, re-executes every query in the recorded order,
+// compares the results with the recorded ones and reports the recorded and replayed
+// timings per query kind (query,samples,recorded_median_ns,recorded_max_ns,
+// replay_median_ns,replay_max_ns,mismatches) followed by the slowest recorded queries.
+// The per query CSV (index,query,recorded_ns,replay_ns,match) turns a recorded slow
+// frame into a regression benchmark. The program exits with status 1 on mismatches.
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_recorder.hh"
+
+using namespace acme;
+
+// Median of a vector (sorted in place)
+real
+median(std::vector<real> &values)
+{
+  if (values.empty())
+    return 0.0;
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// Main function
+int main(int argc, char const *argv[])
+{
+  std::string trace;
+  integer repeat = 1;
+  real tolerance = 1.0e-9;
+  integer slowest = 10;
+  std::string output;
+  bool usage = argc < 2;
+  for (integer i = 1; i < argc; ++i)
+  {
+    std::string arg(argv[i]);
+    bool value = i + 1 < argc;
+    if (arg == "--repeat" && value)
+      repeat = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--tolerance" && value)
+      tolerance = std::atof(argv[++i]);
+    else if (arg == "--slowest" && value)
+      slowest = std::max(0, std::atoi(argv[++i]));
+    else if (arg == "--output" && value)
+      output = argv[++i];
+    else if (trace.empty() && arg.compare(0, 2, "--") != 0)
+      trace = arg;
+    else
+      usage = true;
+  }
+  if (usage || trace.empty())
+  {
+    std::cerr
+        << "Usage: acme-replay TRACE [--repeat N] [--tolerance X] [--slowest N] [--output FILE]" << std::endl;
+    return 2;
+  }
+
+  collection Snapshot;
+  std::vector<recorder::entry> Entries;
+  if (!recorder::load(trace, Snapshot, Entries))
+  {
+    std::cerr << "acme-replay: cannot read trace " << trace << " (" << Entries.size() << " queries read)" << std::endl;
+    return 2;
+  }
+  std::cerr
+      << "acme-replay: " << Snapshot.size() << " entities, " << Entries.size() << " queries" << std::endl;
+
+  // Re-execute the queries in the recorded order
+  context Context;
+  std::vector<recorder::entry> Replayed(Entries.size());
+  std::vector<bool> matches(Entries.size());
+  integer mismatches = 0;
+  for (size_t i = 0; i < Entries.size(); ++i)
+  {
+    recorder::entry Result;
+    for (integer k = 0; k < repeat; ++k)
+    {
+      recorder::execute(Snapshot, Entries[i], Result, Context);
+      if (k == 0 || Result.duration < Replayed[i].duration)
+        Replayed[i] = Result;
+    }
+    matches[i] = recorder::compare(Entries[i], Replayed[i], tolerance);
+    if (!matches[i] && mismatches++ < 10)
+      std::cerr
+          << "MISMATCH query " << i << " (" << recorder::name(Entries[i].kind) << "): recorded hit "
+          << Entries[i].hit << " id " << Entries[i].id << " count " << Entries[i].count
+          << ", replayed hit " << Replayed[i].hit << " id " << Replayed[i].id << " count " << Replayed[i].count << std::endl;
+  }
+
+  // Timings per query kind
+  std::cout << "query,samples,recorded_median_ns,recorded_max_ns,replay_median_ns,replay_max_ns,mismatches" << std::endl;
+  for (integer q = 0; q < recorder::QUERIES; ++q)
+  {
+    std::vector<real> recorded, replayed;
+    integer different = 0;
+    for (size_t i = 0; i < Entries.size(); ++i)
+    {
+      if (Entries[i].kind != q)
+        continue;
+      recorded.push_back(real(Entries[i].duration));
+      replayed.push_back(real(Replayed[i].duration));
+      different += !matches[i];
+    }
+    if (recorded.empty())
+      continue;
+    real recorded_max = *std::max_element(recorded.begin(), recorded.end());
+    real replayed_max = *std::max_element(replayed.begin(), replayed.end());
+    std::cout
+        << recorder::name(static_cast<recorder::query>(q)) << "," << recorded.size() << ","
+        << median(recorded) << "," << recorded_max << "," << median(replayed) << "," << replayed_max << ","
+        << different << std::endl;
+  }
+
+  // Slowest recorded queries
+  std::vector<size_t> order(Entries.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&Entries](size_t i, size_t j) { return Entries[i].duration > Entries[j].duration; });
+  if (slowest > 0 && !order.empty())
+  {
+    std::cout << std::endl
+              << "index,query,recorded_ns,replay_ns,match" << std::endl;
+    for (size_t k = 0; k < order.size() && k < size_t(slowest); ++k)
+    {
+      size_t i = order[k];
+      std::cout
+          << i << "," << recorder::name(Entries[i].kind) << "," << Entries[i].duration << ","
+          << Replayed[i].duration << "," << matches[i] << std::endl;
+    }
+  }
+
+  if (!output.empty())
+  {
+    std::ofstream stream(output);
+    stream << "index,query,recorded_ns,replay_ns,match" << std::endl;
+    for (size_t i = 0; i < Entries.size(); ++i)
+      stream
+          << i << "," << recorder::name(Entries[i].kind) << "," << Entries[i].duration << ","
+          << Replayed[i].duration << "," << matches[i] << std::endl;
+  }
+
+  std::cerr << "acme-replay: " << mismatches << " mismatches" << std::endl;
+  return mismatches == 0 ? 0 : 1;
+}
+
+///
+/// eof: acme-replay.cc
+///
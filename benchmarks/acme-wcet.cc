@@ -0,0 +1,367 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme-wcet.cc
+///
+
+// ACME WORST-CASE EXECUTION TIME HARNESS
+//
+// Usage: acme-wcet [options]
+//   --filter TEXT       run only the queries whose name contains TEXT
+//   --cache MODE        cache state before each query: warm, cold or both (default both)
+//   --size N            road mesh size in triangles (default 100000)
+//   --frames N          workload frames (default 2000)
+//   --seed N            road and workload seed (default 1)
+//   --cpu N             pin the process to CPU N (Linux)
+//   --lock              lock the process memory (mlockall) to avoid page faults
+//   --flush-mb N        size of the buffer written to evict the caches (default 64 MB)
+//   --bound US          latency bound in microseconds for every query
+//   --bound NAME=US     latency bound in microseconds for the named query
+//   --output FILE       write the results to FILE (CSV)
+//
+// The harness generates a road and a vehicle workload, then times every single query
+// (sensor rays and segments, tire disks, balls and swept tires) of the workload. With
+// warm caches the workload is replayed once before the measurement; with cold caches
+// a buffer larger than the last level cache is written before each query, outside the
+// timed region. Results are printed as CSV (query,cache,samples,min_ns,median_ns,
+// mean_ns,p99_ns,p999_ns,max_ns,jitter_ns,stddev_ns,over_bound), where jitter is the
+// spread between the fastest and the slowest execution. Queries exceeding their bound
+// are reported on standard error and the program exits with status 1.
+//
+// For measurements on a real-time rig run the harness on an isolated CPU (isolcpus)
+// with a real-time scheduling policy, e.g. chrt -f 80 acme-wcet --cpu 3 --lock.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_utils.hh"
+#include "acme_workload.hh"
+
+using namespace acme;
+
+// Query latency statistics
+struct result
+{
+  std::string name;  // Query name
+  std::string cache; // Cache state (warm or cold)
+  integer samples;   // Number of timed queries
+  real min_ns;       // Minimum latency [ns]
+  real median_ns;    // Median latency [ns]
+  real mean_ns;      // Mean latency [ns]
+  real p99_ns;       // 99th percentile latency [ns]
+  real p999_ns;      // 99.9th percentile latency [ns]
+  real max_ns;       // Maximum latency [ns]
+  real jitter_ns;    // Latency spread (maximum - minimum) [ns]
+  real stddev_ns;    // Latency standard deviation [ns]
+  integer over;      // Queries exceeding the bound
+};
+
+// Harness options
+struct options
+{
+  std::string filter;                 // Query name filter
+  bool warm = true;                   // Measure with warm caches
+  bool cold = true;                   // Measure with cold caches
+  integer size = 100000;              // Road mesh size [triangles]
+  integer frames = 2000;              // Workload frames
+  integer seed = 1;                   // Road and workload seed
+  integer cpu = -1;                   // Pinned CPU (negative = not pinned)
+  bool lock = false;                  // Lock the process memory
+  integer flush_mb = 64;              // Cache eviction buffer size [MB]
+  real bound = INFTY;                 // Latency bound for every query [us]
+  std::map<std::string, real> bounds; // Latency bounds of the named queries [us]
+  std::string output;                 // Output CSV file
+};
+
+static options opts;
+static std::vector<result> results;
+static std::vector<unsigned char> flush_buffer; // Cache eviction buffer
+static volatile real sink = 0.0;                // Keeps the measured work observable
+
+// Evict the caches by writing the whole eviction buffer
+void
+flush(void)
+{
+  unsigned char acc = 0;
+  for (size_t i = 0; i < flush_buffer.size(); i += 64)
+  {
+    flush_buffer[i] = static_cast<unsigned char>(flush_buffer[i] + 1);
+    acc ^= flush_buffer[i];
+  }
+  sink = sink + acc;
+}
+
+// Get a percentile of sorted latencies
+real
+percentile(std::vector<real> const &sorted, real q)
+{
+  size_t k = static_cast<size_t>(std::ceil(q * sorted.size()));
+  return sorted[std::min(sorted.size(), std::max(size_t(1), k)) - 1];
+}
+
+// Time every query of a workload (called with the query index, returns a value to sink)
+template <typename query_fn>
+void
+measure(std::string const &name, integer queries, query_fn query)
+{
+  if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos)
+    return;
+  typedef std::chrono::steady_clock clock;
+  real bound = opts.bounds.count(name) > 0 ? opts.bounds[name] : opts.bound;
+
+  for (integer mode = 0; mode < 2; ++mode)
+  {
+    bool cold = mode == 1;
+    if ((cold && !opts.cold) || (!cold && !opts.warm))
+      continue;
+
+    // Warm up: replay the whole workload once
+    real acc = 0.0;
+    if (!cold)
+      for (integer i = 0; i < queries; ++i)
+        acc += query(i);
+
+    std::vector<real> ns(queries);
+    for (integer i = 0; i < queries; ++i)
+    {
+      if (cold)
+        flush();
+      clock::time_point start = clock::now();
+      acc += query(i);
+      ns[i] = std::chrono::duration<real, std::nano>(clock::now() - start).count();
+    }
+    sink = sink + acc;
+
+    result r;
+    r.name = name;
+    r.cache = cold ? "cold" : "warm";
+    r.samples = queries;
+    r.over = 0;
+    r.mean_ns = 0.0;
+    for (integer i = 0; i < queries; ++i)
+    {
+      r.mean_ns += ns[i];
+      r.over += ns[i] > 1.0e3 * bound;
+    }
+    r.mean_ns /= queries;
+    r.stddev_ns = 0.0;
+    for (integer i = 0; i < queries; ++i)
+      r.stddev_ns += (ns[i] - r.mean_ns) * (ns[i] - r.mean_ns);
+    r.stddev_ns = std::sqrt(r.stddev_ns / (queries > 1 ? queries - 1 : 1));
+    std::sort(ns.begin(), ns.end());
+    r.min_ns = ns.front();
+    r.median_ns = percentile(ns, 0.5);
+    r.p99_ns = percentile(ns, 0.99);
+    r.p999_ns = percentile(ns, 0.999);
+    r.max_ns = ns.back();
+    r.jitter_ns = r.max_ns - r.min_ns;
+    results.push_back(r);
+    std::cout
+        << r.name << "," << r.cache << "," << r.samples << "," << r.min_ns << "," << r.median_ns << ","
+        << r.mean_ns << "," << r.p99_ns << "," << r.p999_ns << "," << r.max_ns << ","
+        << r.jitter_ns << "," << r.stddev_ns << "," << r.over << std::endl;
+    if (r.over > 0)
+      std::cerr
+          << "OUTLIER " << r.name << " (" << r.cache << "): " << r.over << " queries over "
+          << bound << " us, maximum " << 1.0e-3 * r.max_ns << " us" << std::endl;
+  }
+}
+
+// Main function
+int main(int argc, char const *argv[])
+{
+  for (integer i = 1; i < argc; ++i)
+  {
+    std::string arg(argv[i]);
+    bool value = i + 1 < argc;
+    if (arg == "--filter" && value)
+      opts.filter = argv[++i];
+    else if (arg == "--cache" && value)
+    {
+      std::string mode(argv[++i]);
+      opts.warm = mode == "warm" || mode == "both";
+      opts.cold = mode == "cold" || mode == "both";
+    }
+    else if (arg == "--size" && value)
+      opts.size = std::max(1000, std::atoi(argv[++i]));
+    else if (arg == "--frames" && value)
+      opts.frames = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--seed" && value)
+      opts.seed = std::atoi(argv[++i]);
+    else if (arg == "--cpu" && value)
+      opts.cpu = std::atoi(argv[++i]);
+    else if (arg == "--lock")
+      opts.lock = true;
+    else if (arg == "--flush-mb" && value)
+      opts.flush_mb = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--bound" && value)
+    {
+      std::string bound(argv[++i]);
+      size_t equal = bound.find('=');
+      if (equal == std::string::npos)
+        opts.bound = std::atof(bound.c_str());
+      else
+        opts.bounds[bound.substr(0, equal)] = std::atof(bound.c_str() + equal + 1);
+    }
+    else if (arg == "--output" && value)
+      opts.output = argv[++i];
+    else
+    {
+      std::cerr
+          << "Usage: acme-wcet [--filter TEXT] [--cache warm|cold|both] [--size N] [--frames N] [--seed N]"
+          << " [--cpu N] [--lock] [--flush-mb N] [--bound US] [--bound NAME=US] [--output FILE]" << std::endl;
+      return 2;
+    }
+  }
+  if (!opts.warm && !opts.cold)
+  {
+    std::cerr << "acme-wcet: cache mode must be warm, cold or both" << std::endl;
+    return 2;
+  }
+
+  // Execution environment
+  if (opts.cpu >= 0)
+  {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(opts.cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    {
+      std::cerr << "acme-wcet: cannot pin the process to CPU " << opts.cpu << std::endl;
+      return 2;
+    }
+#else
+    std::cerr << "acme-wcet: CPU pinning is only supported on Linux" << std::endl;
+#endif
+  }
+  if (opts.lock)
+  {
+#ifdef __linux__
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+      std::cerr << "acme-wcet: cannot lock the process memory, page faults may show up as outliers" << std::endl;
+#else
+    std::cerr << "acme-wcet: memory locking is only supported on Linux" << std::endl;
+#endif
+  }
+  if (opts.cold)
+    flush_buffer.assign(size_t(opts.flush_mb) << 20, 0);
+
+  // Road and vehicle workload
+  road Road(opts.seed, 2000.0);
+  Road.features(100, 2);
+  Road.fit(opts.size);
+  collection Terrain;
+  Road.generate(Terrain);
+  Terrain.buildAABBtree();
+  workload Workload;
+  Workload.generate(Road, opts.frames, 16, opts.seed);
+  std::cerr
+      << "acme-wcet: " << Terrain.size() << " triangles, " << Workload.frames() << " frames, "
+      << "cpu " << opts.cpu << ", lock " << opts.lock << std::endl;
+
+  context Context;
+  integer id;
+  point Point;
+  vec3 Normal;
+  real depth, time;
+  std::vector<segment> Segments;
+  std::vector<integer> Ids;
+  std::vector<vec3> Normals;
+  integer rays = Workload.rays();
+  integer tires = 4 * Workload.frames();
+
+  std::cout << "query,cache,samples,min_ns,median_ns,mean_ns,p99_ns,p999_ns,max_ns,jitter_ns,stddev_ns,over_bound" << std::endl;
+  measure("ray", rays * Workload.frames(), [&](integer i) {
+    return real(Terrain.intersection(Workload.sensor(i / rays, i % rays), id, Point, Context));
+  });
+  measure("segment", rays * Workload.frames(), [&](integer i) {
+    ray const &Ray = Workload.sensor(i / rays, i % rays);
+    segment Segment(Ray.origin(), Ray.origin() + 50.0 * Ray.direction().normalized());
+    return real(Terrain.intersection(Segment, id, Point, Context));
+  });
+  measure("disk", tires, [&](integer i) {
+    Terrain.intersection(Workload.tire(i / 4, i % 4), Segments, Ids, Normals, Context);
+    return real(Segments.size());
+  });
+  measure("ball", tires, [&](integer i) {
+    disk const &Tire = Workload.tire(i / 4, i % 4);
+    Terrain.intersection(ball(Tire.radius(), Tire.center()), depth, Normal, Ids, Point, Context);
+    return depth;
+  });
+  measure("ball-swept", tires, [&](integer i) {
+    disk const &Tire = Workload.tire(i / 4, i % 4);
+    ball Ball(Tire.radius(), Tire.center() + vec3(0.0, 0.0, 0.1));
+    return real(Terrain.intersection(Ball, vec3(0.0, 0.0, -0.2), time, id, Normal, Point, Context));
+  });
+  measure("disk-swept", tires, [&](integer i) {
+    disk Tire(Workload.tire(i / 4, i % 4));
+    Tire.center().z() += 0.1;
+    return real(Terrain.intersection(Tire, vec3(0.2, 0.0, -0.2), 0.4 * Tire.normal(), 0.01,
+                                     time, id, Normal, Point, Context));
+  });
+
+  if (!opts.output.empty())
+  {
+    std::ofstream stream(opts.output);
+    stream << "query,cache,samples,min_ns,median_ns,mean_ns,p99_ns,p999_ns,max_ns,jitter_ns,stddev_ns,over_bound" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      result const &r = results[i];
+      stream
+          << r.name << "," << r.cache << "," << r.samples << "," << r.min_ns << "," << r.median_ns << ","
+          << r.mean_ns << "," << r.p99_ns << "," << r.p999_ns << "," << r.max_ns << ","
+          << r.jitter_ns << "," << r.stddev_ns << "," << r.over << std::endl;
+    }
+  }
+
+  integer outliers = 0;
+  for (size_t i = 0; i < results.size(); ++i)
+    outliers += results[i].over > 0;
+  return outliers == 0 ? 0 : 1;
+}
+
+///
+/// eof: acme-wcet.cc
+///
@@ -32,6 +32,29 @@
 #ifndef INCLUDE_ACME
 #define INCLUDE_ACME
 
+// Exception-free mode (ACME_NO_EXCEPTIONS): errors set the thread-local status (see
+// acme::lastStatus) and the function returns its fallback value, while failed
+// assertions print the message and abort
+#ifdef ACME_NO_EXCEPTIONS
+#ifndef ACME_ERROR
+#define ACME_ERROR(MSG)                       \
+  {                                           \
+    acme::setStatus(acme::STATUS_ERROR, MSG); \
+  }
+#endif
+#ifndef ACME_ASSERT
+#define ACME_ASSERT(COND, MSG)         \
+  if (!(COND))                         \
+  {                                    \
+    std::cerr << MSG << std::endl;     \
+    std::abort();                      \
+  }
+#endif
+#define ACME_NOEXCEPT noexcept
+#else
+#define ACME_NOEXCEPT
+#endif
+
 // Print acme errors
 #ifndef ACME_ERROR
 #define ACME_ERROR(MSG)                  \
@@ -49,15 +72,28 @@
   ACME_ERROR(MSG)
 #endif
 
+// Check for acme errors in debug builds only (bounds checks on hot paths), enabled
+// by ACME_DEBUG or DEBUG (CMake debug configuration)
+#ifndef ACME_ASSERT_DEBUG
+#if defined(ACME_DEBUG) || defined(DEBUG)
+#define ACME_ASSERT_DEBUG(COND, MSG) ACME_ASSERT(COND, MSG)
+#else
+#define ACME_ASSERT_DEBUG(COND, MSG)
+#endif
+#endif
+
 // Standard libraries
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
 
 // Eigen libraries
@@ -146,12 +182,47 @@ namespace acme
   static mat4 const ONES_MAT4 = mat4::Constant(1.0);      //!< Ones mat4 type
   static mat4 const IDENTITY_MAT4 = mat4::Identity();     //!< Identity mat4 type
 
-  static vec2 THROWAWAY_VEC2 = vec2(NAN_VEC2); //!< Throwaway vec2 type static non-const object
-  static vec3 THROWAWAY_VEC3 = vec3(NAN_VEC3); //!< Throwaway vec3 type static non-const object
-  static vec4 THROWAWAY_VEC4 = vec4(NAN_VEC4); //!< Throwaway vec4 type static non-const object
-  static mat2 THROWAWAY_MAT2 = mat2(NAN_MAT2); //!< Throwaway mat2 type static non-const object
-  static mat3 THROWAWAY_MAT3 = mat3(NAN_MAT3); //!< Throwaway mat3 type static non-const object
-  static mat4 THROWAWAY_MAT4 = mat4(NAN_MAT4); //!< Throwaway mat4 type static non-const object
+  static thread_local vec2 THROWAWAY_VEC2 = vec2(NAN_VEC2); //!< Throwaway vec2 type static thread-local non-const object
+  static thread_local vec3 THROWAWAY_VEC3 = vec3(NAN_VEC3); //!< Throwaway vec3 type static thread-local non-const object
+  static thread_local vec4 THROWAWAY_VEC4 = vec4(NAN_VEC4); //!< Throwaway vec4 type static thread-local non-const object
+  static thread_local mat2 THROWAWAY_MAT2 = mat2(NAN_MAT2); //!< Throwaway mat2 type static thread-local non-const object
+  static thread_local mat3 THROWAWAY_MAT3 = mat3(NAN_MAT3); //!< Throwaway mat3 type static thread-local non-const object
+  static thread_local mat4 THROWAWAY_MAT4 = mat4(NAN_MAT4); //!< Throwaway mat4 type static thread-local non-const object
+
+  /*\
+   |   ____  _        _             
+   |  / ___|| |_ __ _| |_ _   _ ___ 
+   |  \___ \| __/ _` | __| | | / __|
+   |   ___) | || (_| | |_| |_| \__ \
+   |  |____/ \__\__,_|\__|\__,_|___/
+   |                                
+  \*/
+
+  //! Error status codes
+  enum status
+  {
+    STATUS_OK = 0,   //!< No error
+    STATUS_ERROR = 1 //!< Error reported (unsupported case or invalid input)
+  };
+
+  //! Set the thread-local error status (used by ACME_ERROR in exception-free mode)
+  void
+  setStatus(
+      status status_in,   //!< Input status code
+      char const *message //!< Input error message
+  ) ACME_NOEXCEPT;
+
+  //! Get the thread-local error status of the last reported error
+  status
+  lastStatus(void) ACME_NOEXCEPT;
+
+  //! Get the thread-local message of the last reported error
+  char const *
+  lastError(void) ACME_NOEXCEPT;
+
+  //! Reset the thread-local error status
+  void
+  clearStatus(void) ACME_NOEXCEPT;
 
 } // namespace acme
 
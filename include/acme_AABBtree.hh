@@ -39,9 +39,14 @@
 /// file: acme_aabbTree.hh
 ///
 
+#ifndef INCLUDE_ACME_AABBTREE
+#define INCLUDE_ACME_AABBTREE
+
 #include "acme.hh"
 #include "acme_aabb.hh"
 #include "acme_math.hh"
+#include "acme_memory.hh"
+#include "acme_ray.hh"
 
 namespace acme
 {
@@ -58,15 +63,22 @@ namespace acme
   //! Axis-aligned bouding box tree class container
   /**
    * Axis-aligned bouding box AABB tree.
+   *
+   * Thread safety: const traversals only read the tree and append to the output lists
+   * given by the caller, so they may run concurrently while no thread builds or clears it.
+   *
+   * Nodes, inner boxes and children lists are allocated from the tree memory resource
+   * (default resource if not given), which must outlive the tree.
   */
   class AABBtree
   {
   public:
-    typedef std::shared_ptr<AABBtree> ptr; //!< Shared ointer to AABB tree object
-    typedef std::vector<ptr> vecptr;       //!< Vector of pointers to AABB tree objects
+    typedef std::shared_ptr<AABBtree> ptr;           //!< Shared ointer to AABB tree object
+    typedef std::vector<ptr, allocator<ptr>> vecptr; //!< Vector of pointers to AABB tree objects
 
   private:
-    aabb::ptr m_ptrbox; //!< Pointer to AABB tree
+    memoryResource *m_resource; //!< Memory resource for nodes and boxes
+    aabb::ptr m_ptrbox;         //!< Pointer to AABB tree
     AABBtree::vecptr m_children;
 
     AABBtree(AABBtree const &tree);
@@ -78,6 +90,15 @@ namespace acme
     //! AABB tree class constructor
     AABBtree();
 
+    //! AABB tree class constructor
+    explicit AABBtree(
+        memoryResource *resource //!< Input memory resource for nodes and boxes
+    );
+
+    //! Get memory resource for nodes and boxes
+    memoryResource *
+    resource(void) const;
+
     //! Clear AABB tree data
     void
     clear(void);
@@ -86,6 +107,10 @@ namespace acme
     bool
     isEmpty(void) const;
 
+    //! Get AABB tree root box const reference
+    aabb const &
+    box(void) const;
+
     //! Build AABB tree given a list of boxes
     void
     build(
@@ -155,6 +180,52 @@ namespace acme
       return false;
     }
 
+    //! Select all the leaf boxes that satisfy a predicate \n
+    //! The predicate is evaluated on the inner boxes too, so it must be conservative
+    //! (true for a box if it could be true for any of its leaf boxes).
+    template <typename selector>
+    void
+    select(
+        selector function,          //!< Function to check if an aabb is selected
+        aabb::vecptr &candidateList //!< Output list of selected leaf boxes
+    ) const
+    {
+      if (this->isEmpty() || !function(*this->m_ptrbox))
+        return;
+      if (this->m_children.empty())
+      {
+        candidateList.push_back(this->m_ptrbox);
+      }
+      else
+      {
+        typename AABBtree::vecptr::const_iterator it;
+        for (it = this->m_children.begin(); it != this->m_children.end(); ++it)
+          (*it)->select(function, candidateList);
+      }
+    }
+
+    //! Select all the leaf boxes ids that satisfy a predicate (see above)
+    template <typename selector>
+    void
+    select(
+        selector function,        //!< Function to check if an aabb is selected
+        aabb::vecid &candidateList //!< Output list of selected leaf boxes ids
+    ) const
+    {
+      if (this->isEmpty() || !function(*this->m_ptrbox))
+        return;
+      if (this->m_children.empty())
+      {
+        candidateList.push_back(this->m_ptrbox->id());
+      }
+      else
+      {
+        typename AABBtree::vecptr::const_iterator it;
+        for (it = this->m_children.begin(); it != this->m_children.end(); ++it)
+          (*it)->select(function, candidateList);
+      }
+    }
+
     //! Compute all the intersection candidates of AABB trees
     void
     intersection(
@@ -163,6 +234,71 @@ namespace acme
         bool swap_tree = false              //!< If true exchange the tree in computation
     ) const;
 
+    //! Compute all the intersection candidates of AABB trees (leaf boxes ids only)
+    void
+    intersection(
+        AABBtree const &tree,              //!< AABB tree used to check collision
+        aabb::vecpairid &intersectionList, //!< List of pair of overlapping leaf boxes ids
+        bool swap_tree = false             //!< If true exchange the tree in computation
+    ) const;
+
+    //! Compute all the overlapping leaf boxes pairs of the tree with itself \n
+    //! Each pair is listed once and leaf boxes are not paired with themselves.
+    void
+    intersection(
+        aabb::vecpairptr &intersectionList //!< List of pair aabb that overlaps
+    ) const;
+
+    //! Compute all the leaf boxes hit by a ray
+    void
+    intersection(
+        ray const &ray_in,           //!< Input ray
+        aabb::vecptr &candidateList, //!< Output list of hit leaf boxes
+        real t_max = INFTY           //!< Maximum ray parameter
+    ) const;
+
+    //! Compute all the leaf boxes hit by a ray (ray entry parameter and leaf box id) \n
+    //! Leaf boxes pointers are not copied, so no shared pointer reference count is touched.
+    void
+    intersection(
+        ray const &ray_in,                                 //!< Input ray
+        std::vector<std::pair<real, integer>> &candidateList, //!< Output list of ray entry parameters and leaf boxes ids
+        real t_max = INFTY                                 //!< Maximum ray parameter
+    ) const;
+
+    //! Compute the leaf boxes hit by a ray with a budget of visited nodes \n
+    //! Each visited node consumes one unit of the budget and the traversal stops when
+    //! it is exhausted, so the candidate list may be partial (negative = unlimited).
+    void
+    intersection(
+        ray const &ray_in,                                    //!< Input ray
+        std::vector<std::pair<real, integer>> &candidateList, //!< Output list of ray entry parameters and leaf boxes ids
+        real t_max,                                           //!< Maximum ray parameter
+        integer &nodes                                        //!< Input/output nodes budget left
+    ) const;
+
+    //! Get all the leaf boxes in depth-first order
+    void
+    leaves(
+        aabb::vecptr &leafList //!< Output list of leaf boxes
+    ) const;
+
+    //! Refit the tree boxes after some leaf boxes have been updated in place \n
+    //! Only the ancestors of the changed leaf boxes (flagged by leaf box id) are merged
+    //! again, the tree topology is kept. Return true if the root box has been updated.
+    bool
+    refit(
+        std::vector<bool> const &changed //!< Input changed flags indexed by leaf box id
+    );
+
+    //! Get memory footprint of the tree nodes, boxes and children vectors \n
+    //! Components are named after the given prefix ("tree/nodes", "tree/boxes",
+    //! "tree/leaf boxes", "tree/children"), overheads are shared with other footprints.
+    footprint
+    memoryUsage(
+        std::string const &name = "tree" //!< Input component names prefix
+    ) const;
+
   private:
     //! Find the candidate at minimum distance from point
     void selectMinimumDistance(
@@ -187,10 +323,33 @@ namespace acme
         aabb::vecptr &candidateList //!< Output candidate list
     );
 
+    //! Select the leaf boxes hit by a ray given its origin and inverse direction
+    static void
+    selectRayCandidates(
+        point const &origin,        //!< Input ray origin
+        vec3 const &inv_direction,  //!< Input ray component-wise inverse direction
+        real t_max,                 //!< Input maximum ray parameter
+        AABBtree const &tree,       //!< Input tree
+        aabb::vecptr &candidateList //!< Output candidate list
+    );
+
+    //! Select the leaf boxes ids hit by a ray given its origin and inverse direction
+    static void
+    selectRayCandidates(
+        point const &origin,                                  //!< Input ray origin
+        vec3 const &inv_direction,                            //!< Input ray component-wise inverse direction
+        real t_max,                                           //!< Input maximum ray parameter
+        AABBtree const &tree,                                 //!< Input tree
+        std::vector<std::pair<real, integer>> &candidateList, //!< Output candidate list
+        integer &nodes                                        //!< Input/output nodes budget left
+    );
+
   }; // class AABBtree
 
 } // namespace acme
 
+#endif
+
 ///
 /// eof: acme_aabbTree.hh
 ///
\ No newline at end of file
@@ -58,6 +58,9 @@ namespace acme
     typedef std::pair<ptr, ptr> pairptr;     //!< Pair of pointers to const aabb objects used in AABBtree routines
     typedef std::vector<ptr> vecptr;         //!< Vector of pointers to const aabb objects used in AABBtree routines
     typedef std::vector<pairptr> vecpairptr; //!< Vector of pairs of pointers to const aabb objects used in AABBtree routines
+    typedef std::pair<integer, integer> pairid; //!< Pair of aabb ids used in AABBtree routines
+    typedef std::vector<integer> vecid;         //!< Vector of aabb ids used in AABBtree routines
+    typedef std::vector<pairid> vecpairid;      //!< Vector of pairs of aabb ids used in AABBtree routines
 
   private:
     point m_min;   //!< Box maximum point
@@ -191,6 +194,17 @@ namespace acme
         aabb const &aabb_in //!< Input
     ) const;
 
+    //! Detect if a ray collides with the box (slab test) \n
+    //! The ray is given by its origin and by the component-wise inverse of its direction,
+    //! so that the same inverse can be reused on all the boxes of a tree traversal.
+    bool
+    intersects(
+        point const &origin,       //!< Input ray origin
+        vec3 const &inv_direction, //!< Input ray component-wise inverse direction
+        real &t_entry,             //!< Output ray parameter at box entry (clamped to 0)
+        real &t_exit               //!< Output ray parameter at box exit
+    ) const;
+
     //! Build aabb with a vector of pointers to boxes
     void
     merged(
@@ -261,7 +275,7 @@ namespace acme
   }; //class aabb
 
   static aabb const NAN_AABB = aabb(NAN_POINT, NAN_POINT, 0, 0); //!< Not-a-Number static const aabb object
-  static aabb THROWAWAY_AABB = aabb(NAN_AABB);                   //!< Throwaway static non-const aabb object
+  static thread_local aabb THROWAWAY_AABB = aabb(NAN_AABB);                   //!< Throwaway static thread-local non-const aabb object
 
 } // namespace acme
 
@@ -207,7 +207,7 @@ namespace acme
   }; // class ball
 
   static ball const NAN_BALL = ball(QUIET_NAN, NAN_POINT); //!< Not-a-Number static const ball object
-  static ball THROWAWAY_BALL = ball(NAN_BALL);           //!< Throwaway static non-const ball object
+  static thread_local ball THROWAWAY_BALL = ball(NAN_BALL);           //!< Throwaway static thread-local non-const ball object
 
 } // namespace acme
 
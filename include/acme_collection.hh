@@ -32,16 +32,22 @@
 #ifndef INCLUDE_ACME_COLLECTION
 #define INCLUDE_ACME_COLLECTION
 
+#include <algorithm>
 #include <map>
 
 #include "acme.hh"
 #include "acme_AABBtree.hh"
+#include "acme_context.hh"
 #include "acme_entity.hh"
 #include "acme_intersection.hh"
+#include "acme_triangleBlock.hh"
+#include "acme_triangleRecord.hh"
 
 namespace acme
 {
 
+  class recorder;
+
   /*\
    |             _ _           _   _              
    |    ___ ___ | | | ___  ___| |_(_) ___  _ __  
@@ -54,12 +60,113 @@ namespace acme
   //! Collection class container
   /**
    * Collection of entity objects in 3D space.
+   *
+   * Thread safety: const queries only read the collection and may run concurrently
+   * as long as no thread modifies it (modifiers, build methods and non-const access).
+   * Defaulted output arguments are thread-local throwaway objects; the overloads
+   * taking a context use its scratch buffers, one context per thread.
    */
   class collection
   {
   private:
-    entity::vecptr m_entities; //!< Vector of shared pointers to entity objects
-    AABBtree::ptr m_AABBtree;  //!< Collection AABB tree pointer
+    //! Entity types (indexes slots)
+    enum type
+    {
+      TYPE_NONE = 0,
+      TYPE_POINT,
+      TYPE_LINE,
+      TYPE_RAY,
+      TYPE_PLANE,
+      TYPE_SEGMENT,
+      TYPE_TRIANGLE,
+      TYPE_DISK,
+      TYPE_BALL,
+      TYPES
+    };
+
+    memoryResource *m_resource;           //!< Memory resource for entities, trees and boxes
+    recorder *m_recorder;                 //!< Query trace recorder (nullptr if not recording)
+    entity::vecptr m_entities;            //!< Vector of shared pointers to entity objects
+    std::vector<integer> m_indexes[TYPES]; //!< Entity indexes grouped by type (insertion order)
+    bool m_indexed;                       //!< Entity indexes validity flag
+    AABBtree::ptr m_AABBtree;             //!< Collection AABB tree pointer
+    aabb::vecptr m_bounds;                //!< Cached entity boxes (AABB tree leaves)
+    std::vector<bool> m_changed;          //!< Cached entity boxes out of date flags
+    std::vector<integer> m_dirty;         //!< Entities whose cached box is out of date
+
+    std::vector<triangleRecord> m_records; //!< Precomputed triangle records (one per entity)
+    triangleBlock::vec m_blocks;           //!< Triangle blocks in AABB tree leaves order
+    size_t m_blocksSize;                   //!< Collection size when the triangle blocks were built
+    std::vector<integer> m_lanes;          //!< Entities blocks lanes (block * LANES + lane, -1 if none)
+    aabb::vecptr m_blocksBounds;           //!< Triangle blocks boxes (blocks AABB tree leaves)
+    AABBtree::ptr m_blocksAABBtree;        //!< Triangle blocks AABB tree pointer
+
+    //! Get the nearest hit of a ray with the collection triangles within a ray parameter bound
+    bool
+    nearestHit(
+        ray const &ray_in, //!< Input ray
+        real t_max,        //!< Input maximum ray parameter
+        integer &id,       //!< Output nearest hit entity index
+        real &t,           //!< Output nearest hit ray parameter
+        context &scratch,  //!< Query context (scratch buffers)
+        real tolerance     //!< Tolerance
+    ) const;
+
+    //! Get entity type
+    static integer
+    typeOf(
+        entity const &entity_in //!< Input entity
+    );
+
+    //! Update the cached entity boxes of dirty and new entities \n
+    //! Boxes are updated in place (and thus in the AABB tree leaves) or replaced by new
+    //! ones if the AABB tree is going to be rebuilt.
+    void
+    updateBounds(
+        bool in_place //!< Update the cached boxes in place
+    );
+
+    //! Clear the cached entity boxes and the dirty entities set
+    void
+    clearBounds(void);
+
+    //! Clear the triangle blocks and their AABB tree
+    void
+    clearBlocks(void);
+
+    //! Update the triangle blocks lanes of the dirty entities and refit the blocks AABB
+    //! tree (blocks are rebuilt if a dirty entity changed from or to a triangle)
+    void
+    refitBlocks(
+        std::vector<integer> const &dirty //!< Input dirty entities
+    );
+
+    //! Count entities of a type (from indexes if valid, otherwise by a full scan)
+    integer
+    countType(
+        integer type //!< Input entity type
+    ) const;
+
+    //! Remove all the entities that satisfy a predicate \n
+    //! Entities are erased, indexes are rebuilt and the AABB trees, triangle records
+    //! and blocks are cleared (entity indexes change).
+    template <typename predicate>
+    void
+    removeIf(
+        predicate function //!< Function to check if an entity is removed
+    )
+    {
+      entity::vecptr::iterator end = std::remove_if(
+          this->m_entities.begin(), this->m_entities.end(), function);
+      if (end == this->m_entities.end())
+        return;
+      this->m_entities.erase(end, this->m_entities.end());
+      this->buildIndexes();
+      this->m_AABBtree->clear();
+      this->clearBounds();
+      this->m_records.clear();
+      this->clearBlocks();
+    }
 
   public:
     //! Collection class destructor
@@ -79,10 +186,34 @@ namespace acme
         entity::vecptr &entities //!< Vector of shared pointers to entity objects
     );
 
+    //! Collection class constructor \n
+    //! Entities created by emplace_back, AABB trees nodes and boxes are allocated from
+    //! the memory resource, which must outlive the collection and its trees.
+    explicit collection(
+        memoryResource *resource //!< Input memory resource
+    );
+
+    //! Get memory resource for entities, trees and boxes
+    memoryResource *
+    resource(void) const;
+
+    //! Set query trace recorder (nullptr to stop recording) \n
+    //! Ray, segment, disk, ball, swept ball and swept disk queries are appended to the
+    //! recorder trace while it is open. Copies of the collection share the recorder.
+    void
+    setRecorder(
+        recorder *recorder_in //!< Input query trace recorder
+    );
+
+    //! Get query trace recorder
+    recorder *
+    getRecorder(void) const;
+
     //! Clear all collection object data
     void clear(void);
 
-    //! Resize collection shared pointer vector
+    //! Resize collection shared pointer vector \n
+    //! New entities are null shared pointers, they are indexed once set (see set).
     void
     resize(
         size_t size //!< Input size
@@ -94,13 +225,42 @@ namespace acme
         entity::ptr entity //!< Input shared pointer to entity
     );
 
-    //! Get i-th entity object shared pointer reference
-    entity::ptr &
-    operator[](
+    //! Construct a new entity from the collection memory resource and add it at the
+    //! end of the collection shared pointer vector
+    template <typename T, typename... Args>
+    std::shared_ptr<T>
+    emplace_back(
+        Args &&...args //!< Input entity constructor arguments
+    )
+    {
+      std::shared_ptr<T> entity_out(std::allocate_shared<T>(allocator<T>(this->m_resource), std::forward<Args>(args)...));
+      this->push_back(entity_out);
+      return entity_out;
+    }
+
+    //! Get i-th entity object shared pointer const reference to modify the entity \n
+    //! The entity is marked dirty, so that its cached box is updated by the next AABB
+    //! tree build or refit.
+    entity::ptr const &
+    modify(
         size_t i //!< Input i-th value
     );
 
-    //! Get i-th entity object shared pointer const reference
+    //! Replace the i-th entity \n
+    //! The entity type indexes are updated, the entity is marked dirty and its
+    //! triangle record (if built) is rebuilt. A null entity is stored but not indexed.
+    void
+    set(
+        size_t i,           //!< Input i-th value
+        entity::ptr entity //!< Input shared pointer to entity
+    );
+
+    //! Get i-th entity object shared pointer const reference \n
+    //! An entity modified through the pointer must be marked dirty (see modify and
+    //! markDirty), while it is replaced through set so that the entity type indexes
+    //! are kept valid. There is no non-const element access: former code assigning
+    //! an entity (c[i] = entity) must call c.set(i, entity), and code modifying an
+    //! entity through c[i] should call c.modify(i) to keep the AABB tree refit valid.
     entity::ptr const &
     operator[](
         size_t i //!< Input i-th value
@@ -405,6 +565,24 @@ namespace acme
     integer
     countNonClampable(void) const;
 
+    //! Build entity type indexes \n
+    //! Indexes are kept up to date by push_back, set, resize and remove methods, so a
+    //! rebuild is never needed by the collection itself. Without valid indexes, type
+    //! queries scan the whole collection. Null entities are not indexed.
+    void
+    buildIndexes(void);
+
+    //! Check whether the entity type indexes are valid
+    bool
+    hasIndexes(void) const;
+
+    //! Get the indexes of the entities of a type (as given by entity::type()) in insertion order
+    void
+    indexes(
+        std::string const &type,      //!< Input entity type
+        std::vector<integer> &indexes //!< Output entity indexes
+    ) const;
+
     //! Get collection size (number of entities)
     integer
     size(void) const;
@@ -421,13 +599,90 @@ namespace acme
         aabb::vecptr &boxes //!< Vector of shered pointer to collection objects aabbs
     ) const;
 
-    //! Build collection AABB tree
-    void buildAABBtree(void);
+    //! Build collection AABB tree (and optionally the triangle records) \n
+    //! The boxes of all the entities are computed again, so entities modified without
+    //! being marked dirty are taken into account (the dirty set only drives the refit).
+    void
+    buildAABBtree(
+        bool records = false //!< Build also the triangle records
+    );
+
+    //! Refit collection AABB tree to the dirty entities \n
+    //! The cached boxes of the dirty entities are updated in place and only their tree
+    //! ancestors are merged again, as well as their triangle records and blocks lanes
+    //! (if built) and the blocks tree. The tree is built from scratch if it is empty or
+    //! the collection size has changed. Tree quality degrades with large displacements and,
+    //! as collection copies share the AABB tree, a refit is seen by all of them.
+    void
+    refitAABBtree(void);
+
+    //! Mark i-th entity as dirty (its cached box is out of date) \n
+    //! Needed when the entity is modified through a shared pointer not obtained with
+    //! modify (e.g. element access or a pointer kept by another collection).
+    void
+    markDirty(
+        size_t i //!< Input i-th value
+    );
+
+    //! Mark all the collection entities as dirty
+    void
+    markDirty(void);
+
+    //! Check whether the i-th entity cached box is out of date (or not yet computed)
+    bool
+    isDirty(
+        size_t i //!< Input i-th value
+    ) const;
+
+    //! Count entities whose cached box is out of date (or not yet computed)
+    integer
+    countDirty(void) const;
+
+    //! Build collection precomputed triangle records \n
+    //! Non-triangle entities get a degenerated record. Records must be rebuilt
+    //! whenever the collection entities are modified.
+    void
+    buildRecords(void);
+
+    //! Check whether the collection triangle records are built and up to date with collection size
+    bool
+    hasRecords(void) const;
+
+    //! Get i-th triangle record const reference
+    triangleRecord const &
+    record(
+        size_t i //!< Input i-th value
+    ) const ACME_NOEXCEPT;
+
+    //! Build collection triangle blocks and their AABB tree \n
+    //! Triangles are packed in blocks following the collection AABB tree leaves order
+    //! (the tree is built if empty). Blocks are dropped when entities are added or the
+    //! AABB tree is rebuilt, and must be rebuilt whenever the entities are modified.
+    void
+    buildBlocks(void);
+
+    //! Check whether the collection triangle blocks are built and up to date with
+    //! collection size and dirty entities
+    bool
+    hasBlocks(void) const;
+
+    //! Get memory footprint of the collection \n
+    //! Entities are broken down by type ("entities/triangle", ...), the collection
+    //! containers ("collection/...") and AABB trees ("tree/...", "blocks tree/...") by
+    //! component, while shared pointer control blocks, vtable pointers and vectors slack
+    //! are reported as "overhead/...". Entities shared with other collections are counted,
+    //! cached entity boxes are counted once as AABB tree leaf boxes.
+    footprint
+    memoryUsage(void) const;
 
     //! Return collection AABB tree shared pointer
     AABBtree::ptr const &
     ptrAABBtree(void);
 
+    //! Return collection AABB tree shared pointer (const version)
+    AABBtree::ptr const &
+    ptrAABBtree(void) const;
+
     //! Intersect the collection with an external collection
     bool
     intersection(
@@ -455,13 +710,255 @@ namespace acme
         collection &entities //!< Intersected entities vector list
     ) const;
 
-    //! Intersect all
-    void
+    //! Intersect the collection with an external collection (entity indexes only) \n
+    //! Candidates are pairs of entity indexes (this collection, external collection).
+    //! Entity shared pointers are not copied and the output storage is reused.
+    bool
     intersection(
-        collection &entities,    //!< Intersection candidates
+        collection const &entities,  //!< External entities collection
+        aabb::vecpairid &candidates //!< Output pairs of candidate entity indexes
+    ) const;
+
+    //! Intersect the collection AABB tree with an external AABB tree (entity indexes only) \n
+    //! Candidates are sorted and listed once. The output storage is reused.
+    bool
+    intersection(
+        AABBtree::ptr const &AABBtree, //!< External AABBtree object pointer
+        aabb::vecid &candidates        //!< Output candidate entity indexes
+    ) const;
+
+    //! Intersect the collection AABB tree with an external AABB tree (entity indexes only) \n
+    //! Reentrant version using the context scratch buffers.
+    bool
+    intersection(
+        AABBtree::ptr const &AABBtree, //!< External AABBtree object pointer
+        aabb::vecid &candidates,       //!< Output candidate entity indexes
+        context &scratch               //!< Query context (scratch buffers)
+    ) const;
+
+    //! Intersect the collection AABB tree with external boxes (entity indexes only) \n
+    //! Each box is selected through the collection AABB tree (no temporary tree is
+    //! built). Candidates are sorted and listed once. The output storage is reused.
+    bool
+    intersection(
+        aabb::vecptr const &boxes, //!< External aabb object pointer vector
+        aabb::vecid &candidates    //!< Output candidate entity indexes
+    ) const;
+
+    //! Intersect the collection AABB tree with an external box (entity indexes only) \n
+    //! The output storage is reused.
+    bool
+    intersection(
+        aabb const &box,        //!< External aabb object
+        aabb::vecid &candidates //!< Output candidate entity indexes
+    ) const;
+
+    //! Intersect the collection triangles with a ray and get the nearest hit \n
+    //! Triangle blocks are used if built, otherwise the collection AABB tree is
+    //! traversed and the triangle records (if built) or triangles are tested.
+    bool
+    intersection(
+        ray const &ray_in,                  //!< Input ray
+        integer &id,                        //!< Output nearest hit entity index
+        point &point_out = THROWAWAY_POINT, //!< Output nearest hit point
+        real tolerance = EPSILON            //!< Tolerance
+    ) const;
+
+    //! Intersect the collection triangles with a ray and get the nearest hit \n
+    //! Reentrant version using the context scratch buffers and query budget.
+    bool
+    intersection(
+        ray const &ray_in,       //!< Input ray
+        integer &id,             //!< Output nearest hit entity index
+        point &point_out,        //!< Output nearest hit point
+        context &scratch,        //!< Query context (scratch buffers)
         real tolerance = EPSILON //!< Tolerance
     ) const;
 
+    //! Intersect the collection triangles with a segment and get the hit nearest to
+    //! the first segment vertex
+    bool
+    intersection(
+        segment const &segment_in,          //!< Input segment
+        integer &id,                        //!< Output nearest hit entity index
+        point &point_out = THROWAWAY_POINT, //!< Output nearest hit point
+        real tolerance = EPSILON            //!< Tolerance
+    ) const;
+
+    //! Intersect the collection triangles with a segment and get the hit nearest to
+    //! the first segment vertex \n
+    //! Reentrant version using the context scratch buffers and query budget.
+    bool
+    intersection(
+        segment const &segment_in, //!< Input segment
+        integer &id,               //!< Output nearest hit entity index
+        point &point_out,          //!< Output nearest hit point
+        context &scratch,          //!< Query context (scratch buffers)
+        real tolerance = EPSILON   //!< Tolerance
+    ) const;
+
+    //! Intersect the collection triangles with a disk and get the contact polyline \n
+    //! Candidates are gathered through the AABB tree with an exact disk/box test. The
+    //! contact segments are cleaned from degenerated and duplicated segments, then
+    //! ordered and oriented so that consecutive segments share their endpoints (one
+    //! polyline after another). Collinear consecutive segments laying on the same plane
+    //! are merged into one segment (with the first segment triangle index). Output vectors
+    //! are cleared but their storage is reused.
+    bool
+    intersection(
+        disk const &disk_in,            //!< Input disk
+        std::vector<segment> &segments, //!< Output ordered contact segments
+        std::vector<integer> &ids,      //!< Output segments triangle indexes
+        std::vector<vec3> &normals,     //!< Output segments triangle unit normals
+        real tolerance = EPSILON        //!< Tolerance
+    ) const;
+
+    //! Intersect the collection triangles with a disk and get the contact polyline \n
+    //! Reentrant version using the context scratch buffers and query budget.
+    bool
+    intersection(
+        disk const &disk_in,            //!< Input disk
+        std::vector<segment> &segments, //!< Output ordered contact segments
+        std::vector<integer> &ids,      //!< Output segments triangle indexes
+        std::vector<vec3> &normals,     //!< Output segments triangle unit normals
+        context &scratch,               //!< Query context (scratch buffers)
+        real tolerance = EPSILON        //!< Tolerance
+    ) const;
+
+    //! Intersect the collection triangles with a ball and get the penetration \n
+    //! Candidates are gathered through the AABB tree with the ball bounding box, then
+    //! each triangle is tested against the ball through its closest point. Depth is the
+    //! maximum penetration, normal is the penetration-weighted mean of the contact
+    //! directions (from the triangle towards the ball center) and point is the deepest
+    //! contact point. Faces front side is given by their normal (vertex order): once
+    //! the ball center has passed through a face, the triangles whose planes have the
+    //! center behind contribute their face normal and a depth of the radius plus the
+    //! center distance from their plane. Output ids vector is cleared but its storage
+    //! is reused.
+    bool
+    intersection(
+        ball const &ball_in,                //!< Input ball
+        real &depth,                        //!< Output maximum penetration depth
+        vec3 &normal,                       //!< Output contact unit normal
+        std::vector<integer> &ids,          //!< Output penetrating triangles indexes
+        point &point_out = THROWAWAY_POINT, //!< Output deepest contact point
+        real tolerance = EPSILON            //!< Tolerance
+    ) const;
+
+    //! Intersect the collection triangles with a ball and get the penetration \n
+    //! Reentrant version using the context scratch buffers and query budget.
+    bool
+    intersection(
+        ball const &ball_in,       //!< Input ball
+        real &depth,               //!< Output maximum penetration depth
+        vec3 &normal,              //!< Output contact unit normal
+        std::vector<integer> &ids, //!< Output penetrating triangles indexes
+        point &point_out,          //!< Output deepest contact point
+        context &scratch,          //!< Query context (scratch buffers)
+        real tolerance = EPSILON   //!< Tolerance
+    ) const;
+
+    //! Sweep a ball through the collection triangles and get the first impact \n
+    //! The ball center moves linearly by the displacement over the unit time interval.
+    //! Candidates are gathered through the AABB tree with the box swept by the ball,
+    //! then the earliest impact among them is kept. Time is in [0, 1] and normal points
+    //! from the triangle towards the ball center at impact.
+    bool
+    intersection(
+        ball const &ball_in,                //!< Input ball at the start of the motion
+        vec3 const &displacement,           //!< Input ball center displacement
+        real &time,                         //!< Output time of first impact
+        integer &id,                        //!< Output first impact triangle index
+        vec3 &normal,                       //!< Output contact unit normal
+        point &point_out = THROWAWAY_POINT, //!< Output contact point
+        real tolerance = EPSILON            //!< Tolerance
+    ) const;
+
+    //! Sweep a ball through the collection triangles and get the first impact \n
+    //! Reentrant version using the context scratch buffers and query budget.
+    bool
+    intersection(
+        ball const &ball_in,      //!< Input ball at the start of the motion
+        vec3 const &displacement, //!< Input ball center displacement
+        real &time,               //!< Output time of first impact
+        integer &id,              //!< Output first impact triangle index
+        vec3 &normal,             //!< Output contact unit normal
+        point &point_out,         //!< Output contact point
+        context &scratch,         //!< Query context (scratch buffers)
+        real tolerance = EPSILON  //!< Tolerance
+    ) const;
+
+    //! Sweep a rotating disk through the collection triangles and get the first impact \n
+    //! The disk center moves linearly by the displacement while the disk rotates about
+    //! its center by the rotation vector over the unit time interval. Candidates are
+    //! gathered through the AABB tree with the box swept by the disk bounding ball and
+    //! visited by increasing bounding ball impact time, so that the sampled disk sweep
+    //! stops as soon as no remaining candidate can be hit earlier.
+    bool
+    intersection(
+        disk const &disk_in,                //!< Input disk at the start of the motion
+        vec3 const &displacement,           //!< Input disk center displacement
+        vec3 const &rotation,               //!< Input disk rotation vector (axis times angle)
+        real resolution,                    //!< Maximum disk point motion between samples
+        real &time,                         //!< Output time of first impact
+        integer &id,                        //!< Output first impact triangle index
+        vec3 &normal,                       //!< Output contact unit normal
+        point &point_out = THROWAWAY_POINT, //!< Output contact point
+        real tolerance = EPSILON            //!< Tolerance
+    ) const;
+
+    //! Sweep a rotating disk through the collection triangles and get the first impact \n
+    //! Reentrant version using the context scratch buffers and query budget.
+    bool
+    intersection(
+        disk const &disk_in,      //!< Input disk at the start of the motion
+        vec3 const &displacement, //!< Input disk center displacement
+        vec3 const &rotation,     //!< Input disk rotation vector (axis times angle)
+        real resolution,          //!< Maximum disk point motion between samples
+        real &time,               //!< Output time of first impact
+        integer &id,              //!< Output first impact triangle index
+        vec3 &normal,             //!< Output contact unit normal
+        point &point_out,         //!< Output contact point
+        context &scratch,         //!< Query context (scratch buffers)
+        real tolerance = EPSILON  //!< Tolerance
+    ) const;
+
+    //! Intersect the collection triangles with a batch of rays \n
+    //! Rays are partitioned among the available threads (OpenMP) and the nearest hits
+    //! are returned in input order. Missed rays get -1 id and Not-a-Number point.
+    bool
+    intersection(
+        std::vector<ray> const &rays, //!< Input rays
+        std::vector<integer> &ids,    //!< Output nearest hit entity indexes
+        std::vector<point> &points,   //!< Output nearest hit points
+        integer threads = 0,          //!< Number of threads (0 = OpenMP default)
+        real tolerance = EPSILON      //!< Tolerance
+    ) const;
+
+    //! Intersect the collection triangles with a batch of segments \n
+    //! Segments are partitioned among the available threads (OpenMP) and the nearest
+    //! hits are returned in input order. Missed segments get -1 id and Not-a-Number point.
+    bool
+    intersection(
+        std::vector<segment> const &segments, //!< Input segments
+        std::vector<integer> &ids,            //!< Output nearest hit entity indexes
+        std::vector<point> &points,           //!< Output nearest hit points
+        integer threads = 0,                  //!< Number of threads (0 = OpenMP default)
+        real tolerance = EPSILON              //!< Tolerance
+    ) const;
+
+    //! Intersect all the collection entities with each other \n
+    //! Only the pairs whose boxes overlap in the AABB tree are evaluated (a temporary
+    //! tree is used if the collection one is not built or is out of date because of new
+    //! or dirty entities, see markDirty). Self-pairs and non-intersecting pairs are
+    //! skipped, results are sorted by entity indexes (i < j).
+    void
+    intersection(
+        collection &entities,     //!< Intersection results
+        real tolerance = EPSILON, //!< Tolerance
+        integer threads = 0       //!< Number of threads (0 = OpenMP default)
+    ) const;
+
   }; // class collection
 
 } // namespace acme
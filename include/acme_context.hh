@@ -0,0 +1,194 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_context.hh
+///
+
+#ifndef INCLUDE_ACME_CONTEXT
+#define INCLUDE_ACME_CONTEXT
+
+#include <chrono>
+
+#include "acme.hh"
+#include "acme_aabb.hh"
+
+namespace acme
+{
+
+  /*\
+   |                   _            _   
+   |    ___ ___  _ __ | |_ _____  _| |_ 
+   |   / __/ _ \| '_ \| __/ _ \ \/ / __|
+   |  | (_| (_) | | | | ||  __/>  <| |_ 
+   |   \___\___/|_| |_|\__\___/_/\_\\__|
+   |                                    
+  \*/
+
+  //! Query context class container
+  /**
+   * Scratch storage for collection queries. A query that receives a context uses its
+   * buffers instead of local ones and writes no shared state, so each thread running
+   * queries in parallel owns its context. Buffers are cleared by each query but keep
+   * their storage, so a reused context stops allocating once it has grown enough.
+   *
+   * A context may also carry a query budget: maximum number of tree nodes visited and
+   * primitives tested per query, and a wall-clock deadline shared by all the queries
+   * until it is changed. When the nodes budget is exhausted the traversal stops and the
+   * candidates found so far are tested; when the primitives budget is exhausted or the
+   * deadline has passed no more candidates are tested. The query then returns its
+   * partial answer (ray candidates are tested by increasing entry parameter, so a
+   * partial nearest hit is the best among the tested ones) and the context is flagged.
+   */
+  class context
+  {
+  public:
+    typedef std::pair<real, integer> entry;                  //!< Ray entry parameter and leaf box id
+    typedef std::vector<entry> vecentry;                     //!< Vector of ray entry parameters and leaf boxes ids
+    typedef std::chrono::steady_clock clock;                 //!< Deadline clock type
+    typedef std::chrono::steady_clock::time_point timepoint; //!< Deadline time point type
+
+  private:
+    aabb::vecid m_candidates; //!< Candidate leaf boxes ids
+    vecentry m_entries;       //!< Candidate ray entry parameters and leaf boxes ids
+    aabb::vecpairid m_pairs;  //!< Candidate pairs of leaf boxes ids
+    vecentry m_instances;     //!< Candidate ray entry parameters and scene instances ids
+
+    integer m_max_nodes;      //!< Maximum nodes visited per query (non-positive = unlimited)
+    integer m_max_primitives; //!< Maximum primitives tested per query (non-positive = unlimited)
+    bool m_timed;             //!< Deadline flag
+    timepoint m_deadline;     //!< Queries deadline
+    integer m_nodes;          //!< Nodes visited by the last query
+    integer m_primitives;     //!< Primitives tested by the last query
+    bool m_exhausted;         //!< Budget exhausted by the last query
+
+  public:
+    //! Context class destructor
+    ~context() {}
+
+    //! Context class constructor
+    context();
+
+    //! Context copy constructor
+    context(context const &) = default;
+
+    //! Context move constructor
+    context(context &&) = default;
+
+    //! Reserve the buffers storage
+    void
+    reserve(
+        integer size //!< Input expected number of candidates
+    );
+
+    //! Clear the buffers (storage is kept)
+    void
+    clear(void);
+
+    //! Get candidate leaf boxes ids buffer reference
+    aabb::vecid &
+    candidates(void);
+
+    //! Get candidate ray entry parameters and leaf boxes ids buffer reference
+    vecentry &
+    entries(void);
+
+    //! Get candidate pairs of leaf boxes ids buffer reference
+    aabb::vecpairid &
+    pairs(void);
+
+    //! Get candidate ray entry parameters and scene instances ids buffer reference
+    vecentry &
+    instances(void);
+
+    //! Set the per query budget (non-positive values mean unlimited)
+    void
+    budget(
+        integer nodes,     //!< Input maximum nodes visited per query
+        integer primitives //!< Input maximum primitives tested per query
+    );
+
+    //! Set the queries deadline
+    void
+    deadline(
+        timepoint const &deadline_in //!< Input deadline time point
+    );
+
+    //! Set the queries deadline from now
+    void
+    deadline(
+        real seconds //!< Input time from now [s]
+    );
+
+    //! Remove budget and deadline
+    void
+    unlimited(void);
+
+    //! Check whether the last query exhausted its budget (partial answer)
+    bool
+    isExhausted(void) const;
+
+    //! Get the number of nodes visited by the last query
+    integer
+    nodes(void) const;
+
+    //! Get the number of primitives tested by the last query
+    integer
+    primitives(void) const;
+
+    //! Start a query (reset the query counters)
+    void
+    start(void);
+
+    //! Get the nodes left to the query
+    integer
+    nodesLeft(void) const;
+
+    //! Update the query counters with the nodes left after a traversal
+    void
+    updateNodes(
+        integer nodes_left //!< Input nodes left (see nodesLeft)
+    );
+
+    //! Count a visited node and check whether the traversal may go on
+    bool
+    visit(void);
+
+    //! Count a primitive test and check whether it may be done (budget and deadline)
+    bool
+    test(void);
+
+  }; // class context
+
+} // namespace acme
+
+#endif
+
+///
+/// eof: acme_context.hh
+///
@@ -158,6 +158,12 @@ namespace acme
     real
     area(void) const;
 
+    //! Get the disk point closest to the query point
+    point
+    closestPoint(
+        point const &point_in //!< Query point
+    ) const;
+
     //! Translate by vector
     void
     translate(
@@ -243,7 +249,7 @@ namespace acme
   }; // class disk
 
   static disk const NAN_DISK = disk(QUIET_NAN, NAN_PLANE); //!< Not-a-Number static const disk object
-  static disk THROWAWAY_DISK = disk(NAN_DISK);             //!< Throwaway static non-const disk object
+  static thread_local disk THROWAWAY_DISK = disk(NAN_DISK);             //!< Throwaway static thread-local non-const disk object
 
 } // namespace acme
 
@@ -0,0 +1,209 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_instrumentation.hh
+///
+
+#ifndef INCLUDE_ACME_INSTRUMENTATION
+#define INCLUDE_ACME_INSTRUMENTATION
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "acme.hh"
+
+// Hot-path probes (compiled out unless ACME_INSTRUMENTATION is defined)
+#ifdef ACME_INSTRUMENTATION
+#define ACME_PROBE(KIND, CONTEXT) acme::instrumentation::scope acme_probe_scope(KIND, CONTEXT)
+#define ACME_PROBE_HITS(N) acme_probe_scope.hits(N)
+#define ACME_PROBE_NODES(N) acme_probe_scope.nodes(N)
+#else
+#define ACME_PROBE(KIND, CONTEXT)
+#define ACME_PROBE_HITS(N)
+#define ACME_PROBE_NODES(N)
+#endif
+
+namespace acme
+{
+
+  class context;
+
+  /*\
+   |   _           _                                   _        _   _             
+   |  (_)_ __  ___| |_ _ __ _   _ _ __ ___   ___ _ __ | |_ __ _| |_(_) ___  _ __  
+   |  | | '_ \/ __| __| '__| | | | '_ ` _ \ / _ \ '_ \| __/ _` | __| |/ _ \| '_ \ 
+   |  | | | | \__ \ |_| |  | |_| | | | | | |  __/ | | | || (_| | |_| | (_) | | | |
+   |  |_|_| |_|___/\__|_|   \__,_|_| |_| |_|\___|_| |_|\__\__,_|\__|_|\___/|_| |_|
+   |                                                                              
+  \*/
+
+  //! Instrumentation class container
+  /**
+   * Per-thread counters, log-scale latency histograms and recent events of the
+   * instrumented queries. The probes placed in the AABB tree ray traversal, the
+   * collection queries and the entity dispatcher (ACME_PROBE) only exist when the
+   * library is compiled with ACME_INSTRUMENTATION, so they cost nothing otherwise.
+   *
+   * Each thread writes its own counters (relaxed atomics, no locking), a snapshot sums
+   * the counters of all the threads, those already exited included. Events (the last
+   * EVENTS probes of each thread) are exported to a Chrome trace JSON file, which can
+   * be opened in chrome://tracing or Perfetto; user scopes with a label (a road section,
+   * a simulation frame) show up as slices enclosing the query events. Exporting and
+   * resetting the events must not run concurrently with instrumented queries.
+  */
+  class instrumentation
+  {
+  public:
+    //! Instrumented query kinds
+    enum probe
+    {
+      PROBE_RAY = 0,        //!< Collection ray query
+      PROBE_SEGMENT = 1,    //!< Collection segment query
+      PROBE_DISK = 2,       //!< Collection disk polyline query
+      PROBE_BALL = 3,       //!< Collection ball penetration query
+      PROBE_BALL_SWEPT = 4, //!< Collection swept ball query
+      PROBE_DISK_SWEPT = 5, //!< Collection swept disk query
+      PROBE_BOX = 6,        //!< Collection box candidates query
+      PROBE_TREE = 7,       //!< Collection tree-vs-tree candidates query
+      PROBE_TREE_RAY = 8,   //!< AABB tree ray traversal
+      PROBE_DISPATCH = 9,   //!< Entity intersection dispatcher
+      PROBE_SCOPE = 10,     //!< User scope
+      PROBES = 11           //!< Number of query kinds
+    };
+
+    static integer const BINS = 32;      //!< Latency histogram bins (bin i counts latencies in [2^i, 2^(i+1)) ns)
+    static integer const EVENTS = 65536; //!< Events kept per thread (the oldest are overwritten)
+
+    //! Query kind statistics
+    struct statistics
+    {
+      uint64_t calls;           //!< Number of calls
+      uint64_t nodes;           //!< Tree nodes visited
+      uint64_t primitives;      //!< Primitives tested
+      uint64_t hits;            //!< Hits returned
+      uint64_t time;            //!< Total time [ns]
+      uint64_t histogram[BINS]; //!< Latency histogram
+    };
+
+    //! Instrumentation scope class container
+    /**
+     * Times a probe from construction to destruction and records it on the calling
+     * thread. A query probe given a context reads its visited nodes and tested
+     * primitives at destruction; a user scope only records its labelled event.
+    */
+    class scope
+    {
+    private:
+      probe m_kind;                                  //!< Query kind
+      char const *m_label;                           //!< Event label (string literal)
+      context const *m_context;                      //!< Query context (may be nullptr)
+      uint64_t m_nodes;                              //!< Tree nodes visited
+      uint64_t m_hits;                               //!< Hits returned
+      std::chrono::steady_clock::time_point m_start; //!< Start time
+
+      scope(scope const &) = delete;
+      scope &operator=(scope const &) = delete;
+
+    public:
+      //! Instrumentation scope class destructor
+      ~scope();
+
+      //! Instrumentation scope class constructor (query probe)
+      scope(
+          probe kind,               //!< Input query kind
+          context const *context_in //!< Input query context (may be nullptr)
+      );
+
+      //! Instrumentation scope class constructor (user scope)
+      explicit scope(
+          char const *label //!< Input event label (string literal)
+      );
+
+      //! Set hits returned
+      void
+      hits(
+          uint64_t hits_in //!< Input hits returned
+      );
+
+      //! Set tree nodes visited (when no context is given)
+      void
+      nodes(
+          uint64_t nodes_in //!< Input tree nodes visited
+      );
+
+    }; // class scope
+
+    //! Check if the library was compiled with the probes
+    static bool
+    isEnabled(void);
+
+    //! Get query kind name
+    static char const *
+    name(
+        probe kind //!< Input query kind
+    );
+
+    //! Get the statistics of a query kind summed over all the threads
+    static statistics
+    snapshot(
+        probe kind //!< Input query kind
+    );
+
+    //! Reset the statistics and the events of all the threads
+    static void
+    reset(void);
+
+    //! Export the events and the statistics to a Chrome trace JSON file
+    static bool
+    exportTrace(
+        std::string const &file //!< Output file name
+    );
+
+    //! Record a probe on the calling thread (used by the scope destructor)
+    static void
+    record(
+        probe kind,                                  //!< Input query kind
+        char const *label,                           //!< Input event label
+        std::chrono::steady_clock::time_point start, //!< Input start time
+        std::chrono::steady_clock::time_point stop,  //!< Input stop time
+        uint64_t nodes,                              //!< Input tree nodes visited
+        uint64_t primitives,                         //!< Input primitives tested
+        uint64_t hits                                //!< Input hits returned
+    );
+
+  }; // class instrumentation
+
+} // namespace acme
+
+#endif
+
+///
+/// eof: acme_instrumentation.hh
+///
@@ -44,6 +44,7 @@
 #include "acme_segment.hh"
 #include "acme_ball.hh"
 #include "acme_triangle.hh"
+#include "acme_triangleRecord.hh"
 
 namespace acme
 {
@@ -63,7 +64,7 @@ namespace acme
       entity const *entity0_in, //!< Input entity 0
       entity const *entity1_in, //!< Input entity 1
       real tolerance = EPSILON  //!< Tolerance
-  );
+  ) ACME_NOEXCEPT;
 
   /*\
    |   ____                   _               _ 
@@ -128,6 +129,15 @@ namespace acme
       real tolerance = EPSILON            //!< Tolerance
   );
 
+  //! Intersection between point and triangle record
+  bool
+  intersection(
+      point const &point_in,              //!< Input point
+      triangleRecord const &record_in,    //!< Input triangle record
+      point &point_out = THROWAWAY_POINT, //!< Output point
+      real tolerance = EPSILON            //!< Tolerance
+  );
+
   //! Intersection between point and disk
   bool
   intersection(
@@ -474,7 +484,7 @@ namespace acme
       real tolerance = EPSILON            //!< Tolerance
   );
 
-  //! Intersection between triangles \n
+  //! Intersection between triangles (interval overlap method) \n
   //! WARNING: This function does not support coplanarity!
   bool
   intersection(
@@ -524,6 +534,16 @@ namespace acme
       real tolerance = EPSILON            //!< Tolerance
   );
 
+  //! Intersection line with triangle record \n
+  //! WARNING: This function does not support coplanarity!
+  bool
+  intersection(
+      line const &line_in,                //!< Input line
+      triangleRecord const &record_in,    //!< Input triangle record
+      point &point_out = THROWAWAY_POINT, //!< Output point
+      real tolerance = EPSILON            //!< Tolerance
+  );
+
   //! Intersection line and disk \n
   //! WARNING: This function does not support coplanarity!
   bool
@@ -564,6 +584,16 @@ namespace acme
       real tolerance = EPSILON            //!< Tolerance
   );
 
+  //! Intersection ray with triangle record \n
+  //! WARNING: This function does not support coplanarity!
+  bool
+  intersection(
+      ray const &ray_in,                  //!< Input ray
+      triangleRecord const &record_in,    //!< Input triangle record
+      point &point_out = THROWAWAY_POINT, //!< Output point
+      real tolerance = EPSILON            //!< Tolerance
+  );
+
   //! Intersection ray with disk \n
   //! WARNING: This function does not support coplanarity!
   bool
@@ -634,6 +664,16 @@ namespace acme
       real tolerance = EPSILON            //!< Tolerance
   );
 
+  //! Intersection segment with triangle record \n
+  //! WARNING: This function does not support coplanarity!
+  bool
+  intersection(
+      segment const &segment_in,          //!< Input segment
+      triangleRecord const &record_in,    //!< Input triangle record
+      point &point_out = THROWAWAY_POINT, //!< Output point
+      real tolerance = EPSILON            //!< Tolerance
+  );
+
   //! Intersection segment with disk \n
   //! WARNING: This function does not support coplanarity!
   bool
@@ -665,23 +705,23 @@ namespace acme
   );
 
   //! Intersection triangle and ball \n
-  //! WARNING: Function not supported!
+  //! Output point is the triangle point closest to the ball center (deepest contact).
   bool
   intersection(
-      triangle const &triangle_in,     //!< Input triangle
-      ball const &ball_in,         //!< Input ball
-      none &none_out = THROWAWAY_NONE, //!< Output none
-      real tolerance = EPSILON         //!< Tolerance
+      triangle const &triangle_in,        //!< Input triangle
+      ball const &ball_in,                //!< Input ball
+      point &point_out = THROWAWAY_POINT, //!< Output point
+      real tolerance = EPSILON            //!< Tolerance
   );
 
   //! Intersection disk and ball \n
-  //! WARNING: Function not supported!
+  //! Output point is the disk point closest to the ball center (deepest contact).
   bool
   intersection(
-      disk const &disk_in,             //!< Input disk
-      ball const &ball_in,         //!< Input ball
-      none &none_out = THROWAWAY_NONE, //!< Output none
-      real tolerance = EPSILON         //!< Tolerance
+      disk const &disk_in,                //!< Input disk
+      ball const &ball_in,                //!< Input ball
+      point &point_out = THROWAWAY_POINT, //!< Output point
+      real tolerance = EPSILON            //!< Tolerance
   );
 
   /*\
@@ -702,6 +742,62 @@ namespace acme
       real tolerance = EPSILON         //!< Tolerance
   );
 
+  //! Intersection between disk and axis aligned box \n
+  //! Exact test: the box section on the disk laying plane is compared with the disk.
+  bool
+  intersection(
+      disk const &disk_in,     //!< Input disk
+      aabb const &aabb_in,     //!< Input aabb
+      real tolerance = EPSILON //!< Tolerance
+  );
+
+  //! Intersection between triangles (boolean only) \n
+  //! Interval overlap test without building the intersection segment.
+  //! WARNING: This function does not support coplanarity!
+  bool
+  intersection(
+      triangle const &triangle0_in, //!< Input triangle 0
+      triangle const &triangle1_in, //!< Input triangle 1
+      real tolerance                //!< Tolerance
+  );
+
+  //! Swept ball against triangle (continuous collision) \n
+  //! The ball center moves linearly by the displacement over the unit time interval.
+  //! The first impact is the earliest among the face, edge and vertex contacts. Output
+  //! time is in [0, 1], point is the contact point on the triangle and normal points
+  //! from the triangle towards the ball center at impact.
+  bool
+  intersection(
+      ball const &ball_in,         //!< Input ball at the start of the motion
+      vec3 const &displacement,    //!< Input ball center displacement
+      triangle const &triangle_in, //!< Input triangle
+      real &time,                  //!< Output time of first impact
+      point &point_out,            //!< Output contact point
+      vec3 &normal,                //!< Output contact unit normal
+      real tolerance = EPSILON     //!< Tolerance
+  );
+
+  //! Swept disk against triangle (continuous collision) \n
+  //! The disk center moves linearly by the displacement while the disk rotates about
+  //! its center by the rotation vector (axis times angle) over the unit time interval.
+  //! The exact sweep of the disk bounding ball gives the earliest possible impact, the
+  //! motion is then sampled from there so that no disk point moves more than the
+  //! resolution between samples, and the first contact is refined by bisection.
+  //! Output point is the contact segment midpoint and normal is the triangle normal
+  //! oriented towards the disk center.
+  bool
+  intersection(
+      disk const &disk_in,         //!< Input disk at the start of the motion
+      vec3 const &displacement,    //!< Input disk center displacement
+      vec3 const &rotation,        //!< Input disk rotation vector (axis times angle)
+      triangle const &triangle_in, //!< Input triangle
+      real resolution,             //!< Maximum disk point motion between samples
+      real &time,                  //!< Output time of first impact
+      point &point_out,            //!< Output contact point
+      vec3 &normal,                //!< Output contact unit normal
+      real tolerance = EPSILON     //!< Tolerance
+  );
+
 } // namespace acme
 
 #endif
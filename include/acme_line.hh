@@ -217,7 +217,7 @@ namespace acme
   }; // class line
 
   static line const NAN_LINE = line(NAN_POINT, NAN_VEC3); //!< Not-a-Number static const line object
-  static line THROWAWAY_LINE = line(NAN_LINE);            //!< Throwaway static non-const line object
+  static thread_local line THROWAWAY_LINE = line(NAN_LINE);            //!< Throwaway static thread-local non-const line object
 
 } // namespace acme
 
@@ -0,0 +1,457 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_memory.hh
+///
+
+#ifndef INCLUDE_ACME_MEMORY
+#define INCLUDE_ACME_MEMORY
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "acme.hh"
+
+namespace acme
+{
+
+  /*\
+   |                                             ____                                    
+   |   _ __ ___   ___ _ __ ___   ___  _ __ _   _|  _ \ ___  ___  ___  _   _ _ __ ___ ___ 
+   |  | '_ ` _ \ / _ \ '_ ` _ \ / _ \| '__| | | | |_) / _ \/ __|/ _ \| | | | '__/ __/ _ \
+   |  | | | | | |  __/ | | | | | (_) | |  | |_| |  _ <  __/\__ \ (_) | |_| | | | (_|  __/
+   |  |_| |_| |_|\___|_| |_| |_|\___/|_|   \__, |_| \_\___||___/\___/ \__,_|_|  \___\___|
+   |                                       |___/                                         
+  \*/
+
+  //! Memory resource class container
+  /**
+   * Abstract source of raw memory, mirroring the C++17 std::pmr::memory_resource
+   * interface. Collections and AABB trees given a memory resource allocate their
+   * nodes, boxes and entities from it (see allocator).
+  */
+  class memoryResource
+  {
+  public:
+    //! Memory resource class destructor
+    virtual ~memoryResource() {}
+
+    //! Allocate memory block
+    virtual void *
+    allocate(
+        size_t bytes,                                //!< Input block size
+        size_t alignment = alignof(std::max_align_t) //!< Input block alignment
+        ) = 0;
+
+    //! Deallocate memory block
+    virtual void
+    deallocate(
+        void *pointer,                               //!< Input block pointer
+        size_t bytes,                                //!< Input block size
+        size_t alignment = alignof(std::max_align_t) //!< Input block alignment
+        ) = 0;
+
+    //! Check if memory blocks allocated from a resource can be deallocated from this one
+    virtual bool
+    isEqual(
+        memoryResource const &resource_in //!< Input memory resource
+    ) const noexcept
+    {
+      return this == &resource_in;
+    }
+
+  }; // class memoryResource
+
+  //! Get the memory resource using global operator new and delete
+  memoryResource *
+  newDeleteResource(void) noexcept;
+
+  //! Get the default memory resource (global operator new and delete if not set)
+  memoryResource *
+  defaultResource(void) noexcept;
+
+  //! Set the default memory resource (nullptr restores global operator new and delete) \n
+  //! Returns the previous default memory resource.
+  memoryResource *
+  setDefaultResource(
+      memoryResource *resource_in //!< Input memory resource
+      ) noexcept;
+
+  /*\
+   |                               _              _      ____                                    
+   |   _ __ ___   ___  _ __   ___ | |_ ___  _ __ (_) ___|  _ \ ___  ___  ___  _   _ _ __ ___ ___ 
+   |  | '_ ` _ \ / _ \| '_ \ / _ \| __/ _ \| '_ \| |/ __| |_) / _ \/ __|/ _ \| | | | '__/ __/ _ \
+   |  | | | | | | (_) | | | | (_) | || (_) | | | | | (__|  _ <  __/\__ \ (_) | |_| | | | (_|  __/
+   |  |_| |_| |_|\___/|_| |_|\___/ \__\___/|_| |_|_|\___|_| \_\___||___/\___/ \__,_|_|  \___\___|
+   |                                                                                             
+  \*/
+
+  //! Monotonic memory resource class container
+  /**
+   * Arena resource: blocks are carved from chunks obtained from an upstream resource,
+   * or from a pre-reserved buffer given by the user, and are never deallocated one by
+   * one. All the memory is given back at once by release() or by the destructor, so
+   * every object allocated from the arena must be destroyed before. Use it to build a
+   * whole scene and tear it down between runs. Not thread-safe.
+  */
+  class monotonicResource : public memoryResource
+  {
+  private:
+    //! Chunk header obtained from upstream resource
+    struct chunk
+    {
+      chunk *next; //!< Next chunk
+      size_t size; //!< Chunk size (header included)
+    };
+
+    memoryResource *m_upstream; //!< Upstream memory resource
+    char *m_buffer;             //!< User pre-reserved buffer
+    size_t m_buffer_size;       //!< User pre-reserved buffer size
+    chunk *m_chunks;            //!< Chunks obtained from upstream resource
+    char *m_current;            //!< Current free position
+    size_t m_left;              //!< Bytes left in current chunk
+    size_t m_next_size;         //!< Size of next upstream chunk
+    size_t m_used;              //!< Bytes allocated (alignment padding included)
+    size_t m_capacity;          //!< Bytes reserved (buffer and chunks)
+
+    monotonicResource(monotonicResource const &) = delete;
+    monotonicResource &operator=(monotonicResource const &) = delete;
+
+  public:
+    //! Monotonic memory resource class destructor
+    ~monotonicResource();
+
+    //! Monotonic memory resource class constructor
+    explicit monotonicResource(
+        size_t initial_size = 1024,                  //!< Input first upstream chunk size
+        memoryResource *upstream = defaultResource() //!< Input upstream memory resource
+    );
+
+    //! Monotonic memory resource class constructor (pre-reserved buffer)
+    monotonicResource(
+        void *buffer,                                //!< Input pre-reserved buffer
+        size_t buffer_size,                          //!< Input pre-reserved buffer size
+        memoryResource *upstream = defaultResource() //!< Input upstream memory resource
+    );
+
+    //! Allocate memory block
+    void *
+    allocate(
+        size_t bytes,                                //!< Input block size
+        size_t alignment = alignof(std::max_align_t) //!< Input block alignment
+        ) override;
+
+    //! Deallocate memory block (no-op)
+    void
+    deallocate(
+        void *pointer,                               //!< Input block pointer
+        size_t bytes,                                //!< Input block size
+        size_t alignment = alignof(std::max_align_t) //!< Input block alignment
+        ) override;
+
+    //! Release all the memory (upstream chunks are given back)
+    void
+    release(void);
+
+    //! Get allocated bytes
+    size_t
+    used(void) const;
+
+    //! Get reserved bytes
+    size_t
+    capacity(void) const;
+
+    //! Get upstream memory resource
+    memoryResource *
+    upstream(void) const;
+
+  }; // class monotonicResource
+
+  /*\
+   |                     _ ____                                    
+   |   _ __   ___   ___ | |  _ \ ___  ___  ___  _   _ _ __ ___ ___ 
+   |  | '_ \ / _ \ / _ \| | |_) / _ \/ __|/ _ \| | | | '__/ __/ _ \
+   |  | |_) | (_) | (_) | |  _ <  __/\__ \ (_) | |_| | | | (_|  __/
+   |  | .__/ \___/ \___/|_|_| \_\___||___/\___/ \__,_|_|  \___\___|
+   |  |_|                                                          
+  \*/
+
+  //! Pool memory resource class container
+  /**
+   * Pool resource for short-lived objects such as query results: blocks up to 4096 bytes
+   * are served from free lists of power-of-two size classes and recycled when
+   * deallocated, larger blocks go straight to the upstream resource. Chunks are given
+   * back by release() or by the destructor. Not thread-safe.
+  */
+  class poolResource : public memoryResource
+  {
+  private:
+    static integer const CLASSES = 10;      //!< Number of size classes (8 to 4096 bytes)
+    static size_t const MIN_BLOCK = 8;      //!< Smallest size class
+    static size_t const MAX_BLOCK = 4096;   //!< Largest size class
+    static size_t const CHUNK_SIZE = 65536; //!< Size of upstream chunks
+
+    //! Free block in a size class list
+    struct block
+    {
+      block *next; //!< Next free block
+    };
+
+    //! Chunk header obtained from upstream resource
+    struct chunk
+    {
+      chunk *next; //!< Next chunk
+      size_t size; //!< Chunk size (header included)
+    };
+
+    memoryResource *m_upstream; //!< Upstream memory resource
+    block *m_free[CLASSES];     //!< Free lists by size class
+    chunk *m_chunks;            //!< Chunks obtained from upstream resource
+    size_t m_used;              //!< Bytes in blocks currently allocated
+    size_t m_capacity;          //!< Bytes reserved from upstream resource
+
+    poolResource(poolResource const &) = delete;
+    poolResource &operator=(poolResource const &) = delete;
+
+    //! Get the size class of a block
+    static integer
+    sizeClass(
+        size_t bytes,    //!< Input block size
+        size_t alignment //!< Input block alignment
+    );
+
+  public:
+    //! Pool memory resource class destructor
+    ~poolResource();
+
+    //! Pool memory resource class constructor
+    explicit poolResource(
+        memoryResource *upstream = defaultResource() //!< Input upstream memory resource
+    );
+
+    //! Allocate memory block
+    void *
+    allocate(
+        size_t bytes,                                //!< Input block size
+        size_t alignment = alignof(std::max_align_t) //!< Input block alignment
+        ) override;
+
+    //! Deallocate memory block (recycled in its size class)
+    void
+    deallocate(
+        void *pointer,                               //!< Input block pointer
+        size_t bytes,                                //!< Input block size
+        size_t alignment = alignof(std::max_align_t) //!< Input block alignment
+        ) override;
+
+    //! Release all the memory (upstream chunks are given back)
+    void
+    release(void);
+
+    //! Get bytes in blocks currently allocated
+    size_t
+    used(void) const;
+
+    //! Get reserved bytes
+    size_t
+    capacity(void) const;
+
+  }; // class poolResource
+
+  /*\
+   |         _ _                 _             
+   |    __ _| | | ___   ___ __ _| |_ ___  _ __ 
+   |   / _` | | |/ _ \ / __/ _` | __/ _ \| '__|
+   |  | (_| | | | (_) | (_| (_| | || (_) | |   
+   |   \__,_|_|_|\___/ \___\__,_|\__\___/|_|   
+   |                                           
+  \*/
+
+  //! Allocator class container
+  /**
+   * Standard allocator drawing from a memory resource, mirroring the C++17
+   * std::pmr::polymorphic_allocator. Use it with std::allocate_shared and with
+   * standard containers; a default-constructed allocator uses the default resource.
+  */
+  template <typename T>
+  class allocator
+  {
+  private:
+    memoryResource *m_resource; //!< Memory resource
+
+  public:
+    typedef T value_type; //!< Allocated type
+
+    //! Allocator class constructor
+    allocator(void) noexcept
+        : m_resource(defaultResource())
+    {
+    }
+
+    //! Allocator class constructor
+    allocator(
+        memoryResource *resource_in //!< Input memory resource
+        ) noexcept
+        : m_resource(resource_in != nullptr ? resource_in : defaultResource())
+    {
+    }
+
+    //! Allocator copy constructor (from another allocated type)
+    template <typename U>
+    allocator(
+        allocator<U> const &allocator_in //!< Input allocator
+        ) noexcept
+        : m_resource(allocator_in.resource())
+    {
+    }
+
+    //! Allocate storage for n objects
+    T *
+    allocate(
+        size_t n //!< Input number of objects
+    )
+    {
+      return static_cast<T *>(this->m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    //! Deallocate storage for n objects
+    void
+    deallocate(
+        T *pointer, //!< Input storage pointer
+        size_t n    //!< Input number of objects
+    )
+    {
+      this->m_resource->deallocate(pointer, n * sizeof(T), alignof(T));
+    }
+
+    //! Get memory resource
+    memoryResource *
+    resource(void) const noexcept
+    {
+      return this->m_resource;
+    }
+
+  }; // class allocator
+
+  //! Check if two allocators draw from interchangeable memory resources
+  template <typename T, typename U>
+  bool
+  operator==(
+      allocator<T> const &allocator0_in, //!< Input allocator 0
+      allocator<U> const &allocator1_in  //!< Input allocator 1
+  )
+  {
+    return allocator0_in.resource() == allocator1_in.resource() ||
+           allocator0_in.resource()->isEqual(*allocator1_in.resource());
+  }
+
+  //! Check if two allocators draw from different memory resources
+  template <typename T, typename U>
+  bool
+  operator!=(
+      allocator<T> const &allocator0_in, //!< Input allocator 0
+      allocator<U> const &allocator1_in  //!< Input allocator 1
+  )
+  {
+    return !(allocator0_in == allocator1_in);
+  }
+
+  /*\
+   |    __             _              _       _   
+   |   / _| ___   ___ | |_ _ __  _ __(_)_ __ | |_ 
+   |  | |_ / _ \ / _ \| __| '_ \| '__| | '_ \| __|
+   |  |  _| (_) | (_) | |_| |_) | |  | | | | | |_ 
+   |  |_|  \___/ \___/ \__| .__/|_|  |_|_| |_|\__|
+   |                      |_|                     
+  \*/
+
+  //! Memory footprint class container
+  /**
+   * Memory footprint report, a breakdown in bytes by named component. Component names
+   * are paths such as "entities/triangle", "tree/nodes" or "overhead/control blocks",
+   * so that groups of components can be summed by prefix.
+   *
+   * The report counts the objects sizes, the shared pointer control blocks (estimated
+   * as a pointer and two counters, as for std::make_shared), the vtable pointers and
+   * the vectors unused capacity. Memory resource and heap allocator headers, padding
+   * and chunk slack are not counted.
+  */
+  class footprint
+  {
+  private:
+    std::map<std::string, size_t> m_components; //!< Component names and sizes [bytes]
+
+  public:
+    //! Footprint class destructor
+    ~footprint() {}
+
+    //! Footprint class constructor
+    footprint() {}
+
+    //! Add bytes to a component
+    void
+    add(
+        std::string const &component, //!< Input component name
+        size_t bytes                  //!< Input component bytes
+    );
+
+    //! Add all the components of another footprint
+    void
+    add(
+        footprint const &footprint_in //!< Input footprint
+    );
+
+    //! Get bytes of the components whose name starts with a prefix
+    size_t
+    bytes(
+        std::string const &prefix //!< Input component name prefix
+    ) const;
+
+    //! Get total bytes
+    size_t
+    total(void) const;
+
+    //! Get component names and sizes [bytes]
+    std::map<std::string, size_t> const &
+    components(void) const;
+
+    //! Get estimated size of a shared pointer control block
+    static size_t
+    controlBlock(void);
+
+  }; // class footprint
+
+} // namespace acme
+
+#endif
+
+///
+/// eof: acme_memory.hh
+///
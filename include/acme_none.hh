@@ -139,7 +139,7 @@ namespace acme
 
   }; // class none
 
-  static none THROWAWAY_NONE = none(); //!< Throwaway static non-const none object
+  static thread_local none THROWAWAY_NONE = none(); //!< Throwaway static thread-local non-const none object
 
 } // namespace acme
 
@@ -234,7 +234,7 @@ namespace acme
   }; // class plane
 
   static plane const NAN_PLANE = plane(NAN_POINT, NAN_VEC3); //!< Not-a-Number static const plane object
-  static plane plane_goat = plane(NAN_PLANE);                //!< Throwaway static non-const plane object
+  static thread_local plane plane_goat = plane(NAN_PLANE);                //!< Throwaway static thread-local non-const plane object
 
 } // namespace acme
 
@@ -165,7 +165,7 @@ namespace acme
   }; // class point
 
   static point const NAN_POINT = point::Constant(QUIET_NAN); //!< Not-a-Number static const point object
-  static point THROWAWAY_POINT = point(NAN_POINT);           //!< Throwaway static non-const point object
+  static thread_local point THROWAWAY_POINT = point(NAN_POINT);           //!< Throwaway static thread-local non-const point object
 
 } // namespace acme
 
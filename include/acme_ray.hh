@@ -221,7 +221,7 @@ namespace acme
   }; // class ray
 
   static ray const NAN_RAY = ray(NAN_POINT, NAN_VEC3); //!< Not-a-Number static const ray object
-  static ray THROWAWAY_RAY = ray(NAN_RAY);             //!< Throwaway static non-const ray object
+  static thread_local ray THROWAWAY_RAY = ray(NAN_RAY);             //!< Throwaway static thread-local non-const ray object
 
 } // namespace acme
 
@@ -0,0 +1,273 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_recorder.hh
+///
+
+#ifndef INCLUDE_ACME_RECORDER
+#define INCLUDE_ACME_RECORDER
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+
+namespace acme
+{
+
+  /*\
+   |                              _           
+   |   _ __ ___  ___ ___  _ __ __| | ___ _ __ 
+   |  | '__/ _ \/ __/ _ \| '__/ _` |/ _ \ '__|
+   |  | | |  __/ (_| (_) | | | (_| |  __/ |   
+   |  |_|  \___|\___\___/|_|  \__,_|\___|_|   
+   |                                          
+  \*/
+
+  //! Recorder class container
+  /**
+   * Query trace recorder. Once set on a collection (collection::setRecorder), every
+   * ray, segment, disk, ball, swept ball and swept disk query of the collection is
+   * appended to a compact binary trace with its parameters, tolerance, result summary
+   * and duration. The trace starts with a snapshot of the collection entities and of
+   * its acceleration structures, so that it can be loaded and re-executed offline
+   * (see the acme-replay tool) to reproduce slow queries and compare their results.
+   *
+   * The trace uses the native byte order. Writes are serialized by a mutex, so that
+   * concurrent queries may share the recorder. The recorder must outlive the recording
+   * collection or be removed from it before being destroyed.
+  */
+  class recorder
+  {
+  public:
+    //! Recorded query kinds
+    enum query
+    {
+      QUERY_RAY = 0,        //!< Ray nearest hit
+      QUERY_SEGMENT = 1,    //!< Segment nearest hit
+      QUERY_DISK = 2,       //!< Disk contact polyline
+      QUERY_BALL = 3,       //!< Ball penetration
+      QUERY_BALL_SWEPT = 4, //!< Swept ball first impact
+      QUERY_DISK_SWEPT = 5, //!< Swept disk first impact
+      QUERIES = 6           //!< Number of query kinds
+    };
+
+    static integer const PARAMETERS = 14; //!< Maximum number of query parameters
+    static integer const VALUES = 4;      //!< Number of result summary values
+
+    //! Recorded query
+    struct entry
+    {
+      query kind;                  //!< Query kind
+      real parameters[PARAMETERS]; //!< Query parameters (see parameters)
+      real tolerance;              //!< Query tolerance
+      bool hit;                    //!< Query result
+      integer id;                  //!< Hit entity index (-1 if none)
+      integer count;               //!< Number of hit entities or contact segments
+      real values[VALUES];         //!< Result summary values (hit point, depth or time and normal)
+      uint64_t duration;           //!< Query duration [ns]
+    };
+
+    //! Recorder guard class container
+    /**
+     * Records a query from construction to destruction when the given recorder is
+     * open, otherwise it does nothing. Used by the collection queries.
+    */
+    class guard
+    {
+    private:
+      recorder *m_recorder;                          //!< Recorder (nullptr if not recording)
+      entry m_entry;                                 //!< Recorded query
+      std::chrono::steady_clock::time_point m_start; //!< Query start time
+
+      guard(guard const &) = delete;
+      guard &operator=(guard const &) = delete;
+
+      //! Start recording a query
+      void
+      start(
+          recorder *recorder_in, //!< Input recorder
+          query kind,            //!< Input query kind
+          real tolerance         //!< Input query tolerance
+      );
+
+    public:
+      //! Recorder guard class destructor (writes the query)
+      ~guard();
+
+      //! Recorder guard class constructor (ray query)
+      guard(
+          recorder *recorder_in, //!< Input recorder (may be nullptr)
+          ray const &ray_in,     //!< Input ray
+          real tolerance         //!< Input query tolerance
+      );
+
+      //! Recorder guard class constructor (segment query)
+      guard(
+          recorder *recorder_in,     //!< Input recorder (may be nullptr)
+          segment const &segment_in, //!< Input segment
+          real tolerance             //!< Input query tolerance
+      );
+
+      //! Recorder guard class constructor (disk query)
+      guard(
+          recorder *recorder_in, //!< Input recorder (may be nullptr)
+          disk const &disk_in,   //!< Input disk
+          real tolerance         //!< Input query tolerance
+      );
+
+      //! Recorder guard class constructor (ball query)
+      guard(
+          recorder *recorder_in, //!< Input recorder (may be nullptr)
+          ball const &ball_in,   //!< Input ball
+          real tolerance         //!< Input query tolerance
+      );
+
+      //! Recorder guard class constructor (swept ball query)
+      guard(
+          recorder *recorder_in,    //!< Input recorder (may be nullptr)
+          ball const &ball_in,      //!< Input ball
+          vec3 const &displacement, //!< Input ball center displacement
+          real tolerance            //!< Input query tolerance
+      );
+
+      //! Recorder guard class constructor (swept disk query)
+      guard(
+          recorder *recorder_in,    //!< Input recorder (may be nullptr)
+          disk const &disk_in,      //!< Input disk
+          vec3 const &displacement, //!< Input disk center displacement
+          vec3 const &rotation,     //!< Input disk rotation vector
+          real resolution,          //!< Input maximum disk point motion between samples
+          real tolerance            //!< Input query tolerance
+      );
+
+      //! Set the query result (queries without result are recorded as misses)
+      void
+      result(
+          integer id,           //!< Input hit entity index
+          integer count,        //!< Input number of hit entities or contact segments
+          real value0,          //!< Input first result summary value
+          vec3 const &values123 //!< Input other result summary values
+      );
+
+    }; // class guard
+
+  private:
+    std::FILE *m_file;          //!< Trace file (nullptr if closed)
+    integer m_size;             //!< Number of recorded queries
+    mutable std::mutex m_mutex; //!< Writes mutex
+
+    recorder(recorder const &) = delete;
+    recorder &operator=(recorder const &) = delete;
+
+  public:
+    //! Recorder class destructor (closes the trace)
+    ~recorder();
+
+    //! Recorder class constructor
+    recorder();
+
+    //! Open a trace file and write the collection snapshot \n
+    //! Entities are stored with their index, non-clampable entities are stored as none.
+    bool
+    open(
+        std::string const &file,   //!< Output trace file name
+        collection const &snapshot //!< Input recorded collection
+    );
+
+    //! Close the trace file
+    bool
+    close(void);
+
+    //! Check whether the trace file is open
+    bool
+    isOpen(void) const;
+
+    //! Get number of recorded queries
+    integer
+    size(void) const;
+
+    //! Append a query to the trace
+    void
+    write(
+        entry const &entry_in //!< Input recorded query
+    );
+
+    //! Get number of parameters of a query kind
+    static integer
+    parameters(
+        query kind //!< Input query kind
+    );
+
+    //! Get query kind name
+    static char const *
+    name(
+        query kind //!< Input query kind
+    );
+
+    //! Load a trace file \n
+    //! The snapshot collection is rebuilt with the recorded acceleration structures.
+    static bool
+    load(
+        std::string const &file,    //!< Input trace file name
+        collection &snapshot,       //!< Output recorded collection
+        std::vector<entry> &entries //!< Output recorded queries
+    );
+
+    //! Execute a recorded query on a collection and get its result and duration
+    static void
+    execute(
+        collection const &collection_in, //!< Input collection
+        entry const &query_in,           //!< Input recorded query
+        entry &result_out,               //!< Output query result
+        context &scratch                 //!< Query context (scratch buffers)
+    );
+
+    //! Check whether two query results match (durations are not compared)
+    static bool
+    compare(
+        entry const &entry0,     //!< Input first query result
+        entry const &entry1,     //!< Input second query result
+        real tolerance = EPSILON //!< Tolerance on the result summary values
+    );
+
+  }; // class recorder
+
+} // namespace acme
+
+#endif
+
+///
+/// eof: acme_recorder.hh
+///
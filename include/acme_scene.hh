@@ -0,0 +1,237 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+///
+/// file: acme_scene.hh
+///
+
+#ifndef INCLUDE_ACME_SCENE
+#define INCLUDE_ACME_SCENE
+
+#include "acme.hh"
+#include "acme_AABBtree.hh"
+#include "acme_aabb.hh"
+#include "acme_collection.hh"
+#include "acme_context.hh"
+#include "acme_ray.hh"
+#include "acme_segment.hh"
+
+namespace acme
+{
+
+  /*\
+   |                           
+   |   ___  ___ ___ _ __   ___ 
+   |  / __|/ __/ _ \ '_ \ / _ \
+   |  \__ \ (_|  __/ | | |  __/
+   |  |___/\___\___|_| |_|\___|
+   |                           
+  \*/
+
+  //! Scene class container
+  /**
+   * Two-level acceleration structure. The scene is made of instances, each one given by
+   * a shared collection (geometry and bottom-level AABB tree in object space) and an
+   * affine transformation from object to world space. A top-level AABB tree is built
+   * over the instances world boxes. Queries are transformed into object space during
+   * the traversal, so moving an instance only updates its transformation and the
+   * top-level tree, and identical objects can share one collection.
+   */
+  class scene
+  {
+  public:
+    typedef std::shared_ptr<collection const> geometry;                   //!< Shared pointer to const instance geometry
+    typedef std::vector<affine, Eigen::aligned_allocator<affine>> vecaffine; //!< Vector of affine transformations
+
+  private:
+    std::vector<geometry> m_geometries; //!< Instances geometries (object space)
+    vecaffine m_transforms;             //!< Instances object to world transformations
+    vecaffine m_inverses;               //!< Instances world to object transformations
+    aabb::vecptr m_boxes;               //!< Instances world boxes
+    AABBtree::ptr m_AABBtree;           //!< Top-level AABB tree pointer
+    std::vector<bool> m_changed;        //!< Instances moved since the last top-level AABB tree build
+    bool m_updated;                     //!< Top-level AABB tree validity flag
+
+    //! Compute the world box of an instance
+    void
+    updateBox(
+        integer i //!< Input instance index
+    );
+
+    //! Get the nearest hit of a ray with the scene within a ray parameter bound \n
+    //! The ray parameter is preserved by the affine transformations, so hits of
+    //! different instances are compared on it.
+    bool
+    nearestHit(
+        ray const &ray_in, //!< Input ray (world space)
+        real t_max,        //!< Input maximum ray parameter
+        integer &instance, //!< Output nearest hit instance index
+        integer &id,       //!< Output nearest hit entity index
+        real &t,           //!< Output nearest hit ray parameter
+        context &scratch,  //!< Query context (scratch buffers)
+        real tolerance     //!< Tolerance
+    ) const;
+
+  public:
+    //! Scene class destructor
+    ~scene() {}
+
+    //! Scene copy constructor
+    scene(scene const &) = default;
+
+    //! Scene move constructor
+    scene(scene &&) = default;
+
+    //! Scene class constructor
+    scene();
+
+    //! Clear all scene instances
+    void
+    clear(void);
+
+    //! Get number of instances
+    integer
+    size(void) const;
+
+    //! Add an instance and get its index \n
+    //! The geometry AABB tree must be already built.
+    integer
+    push_back(
+        geometry const &geometry_in,                    //!< Input instance geometry
+        affine const &transform_in = affine::Identity() //!< Input object to world transformation
+    );
+
+    //! Get i-th instance geometry
+    geometry const &
+    instanceGeometry(
+        integer i //!< Input instance index
+    ) const;
+
+    //! Get i-th instance object to world transformation
+    affine const &
+    instanceTransform(
+        integer i //!< Input instance index
+    ) const;
+
+    //! Set i-th instance object to world transformation \n
+    //! The instance world box is updated in place, the top-level AABB tree must be
+    //! rebuilt (refitted) before the next query.
+    void
+    instanceTransform(
+        integer i,                //!< Input instance index
+        affine const &transform_in //!< Input object to world transformation
+    );
+
+    //! Get i-th instance world box
+    aabb const &
+    instanceBox(
+        integer i //!< Input instance index
+    ) const;
+
+    //! Build the top-level AABB tree over the instances world boxes \n
+    //! If only instances transformations have changed since the last build, the tree
+    //! is refitted over the moved instances boxes, otherwise it is fully rebuilt. As
+    //! scene copies share the top-level tree and the instances boxes, a refit is seen
+    //! by all of them.
+    void
+    buildAABBtree(void);
+
+    //! Check whether the top-level AABB tree is up to date
+    bool
+    isUpdated(void) const;
+
+    //! Get memory footprint of the scene \n
+    //! Instances ("scene/...") and the top-level AABB tree ("scene tree/...") are
+    //! reported with the footprint of each distinct geometry, counted once however
+    //! many instances share it.
+    footprint
+    memoryUsage(void) const;
+
+    //! Intersect the scene with a ray and get the nearest hit
+    bool
+    intersection(
+        ray const &ray_in,                  //!< Input ray
+        integer &instance,                  //!< Output nearest hit instance index
+        integer &id,                        //!< Output nearest hit entity index (in the instance geometry)
+        point &point_out = THROWAWAY_POINT, //!< Output nearest hit point (world space)
+        real tolerance = EPSILON            //!< Tolerance (object space)
+    ) const;
+
+    //! Intersect the scene with a ray and get the nearest hit \n
+    //! Reentrant version using the context scratch buffers: instances are listed in
+    //! the instances buffer, the instances geometries queries use the other buffers
+    //! and the query budget.
+    bool
+    intersection(
+        ray const &ray_in,       //!< Input ray
+        integer &instance,       //!< Output nearest hit instance index
+        integer &id,             //!< Output nearest hit entity index (in the instance geometry)
+        point &point_out,        //!< Output nearest hit point (world space)
+        context &scratch,        //!< Query context (scratch buffers)
+        real tolerance = EPSILON //!< Tolerance (object space)
+    ) const;
+
+    //! Intersect the scene with a segment and get the hit nearest to the first vertex
+    bool
+    intersection(
+        segment const &segment_in,          //!< Input segment
+        integer &instance,                  //!< Output nearest hit instance index
+        integer &id,                        //!< Output nearest hit entity index (in the instance geometry)
+        point &point_out = THROWAWAY_POINT, //!< Output nearest hit point (world space)
+        real tolerance = EPSILON            //!< Tolerance (object space)
+    ) const;
+
+    //! Intersect the scene with a segment and get the hit nearest to the first vertex \n
+    //! Reentrant version using the context scratch buffers (see ray intersection).
+    bool
+    intersection(
+        segment const &segment_in, //!< Input segment
+        integer &instance,         //!< Output nearest hit instance index
+        integer &id,               //!< Output nearest hit entity index (in the instance geometry)
+        point &point_out,          //!< Output nearest hit point (world space)
+        context &scratch,          //!< Query context (scratch buffers)
+        real tolerance = EPSILON   //!< Tolerance (object space)
+    ) const;
+
+    //! Get the entities whose boxes overlap a world box \n
+    //! Candidates are pairs of instance and entity indexes. The box is mapped into each
+    //! instance object space as the box of its transformed corners (conservative).
+    bool
+    intersection(
+        aabb const &box,            //!< Input world box
+        aabb::vecpairid &candidates //!< Output pairs of instance and entity indexes
+    ) const;
+
+  }; // class scene
+
+} // namespace acme
+
+#endif
+
+///
+/// eof: acme_scene.hh
+///
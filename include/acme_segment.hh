@@ -233,7 +233,7 @@ namespace acme
   }; // class segment
 
   static segment const NAN_SEGMENT = segment(NAN_POINT, NAN_POINT); //!< Not-a-Number static const segment object
-  static segment THROWAWAY_SEGMENT = segment(NAN_SEGMENT);          //!< Throwaway static non-const segment object
+  static thread_local segment THROWAWAY_SEGMENT = segment(NAN_SEGMENT);          //!< Throwaway static thread-local non-const segment object
 
 } // namespace acme
 
@@ -114,25 +114,25 @@ namespace acme
     point const &
     vertex(
         size_t i //!< New triangle vertex
-    ) const;
+    ) const ACME_NOEXCEPT;
 
     //! Get i-th triangle vertex reference
     point &
     vertex(
         size_t i //!< New triangle vertex
-    );
+    ) ACME_NOEXCEPT;
 
     //! Get i-th triangle vertex const reference
     point const &
     operator[](
         size_t i //!< New triangle vertex
-    ) const;
+    ) const ACME_NOEXCEPT;
 
     //! Get i-th triangle vertex reference
     point &
     operator[](
         size_t i //!< New triangle vertex
-    );
+    ) ACME_NOEXCEPT;
 
     //! Get triangle centroid
     point
@@ -177,6 +177,12 @@ namespace acme
     plane
     layingPlane(void) const;
 
+    //! Get the triangle point closest to the query point
+    point
+    closestPoint(
+        point const &point_in //!< Query point
+    ) const;
+
     //! Translate triangle by vector
     void
     translate(
@@ -262,7 +268,7 @@ namespace acme
   }; // class triangle
 
   static triangle const NAN_TRIANGLE = triangle(NAN_POINT, NAN_POINT, NAN_POINT); //!< Not-a-Number static const triangle object
-  static triangle THROWAWAY_TRIANGLE = triangle(NAN_TRIANGLE);                    //!< Throwaway static non-const triangle object
+  static thread_local triangle THROWAWAY_TRIANGLE = triangle(NAN_TRIANGLE);                    //!< Throwaway static thread-local non-const triangle object
 
 } // namespace acme
 
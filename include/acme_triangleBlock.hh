@@ -0,0 +1,160 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+///
+/// file: acme_triangleBlock.hh
+///
+
+#ifndef INCLUDE_ACME_TRIANGLEBLOCK
+#define INCLUDE_ACME_TRIANGLEBLOCK
+
+#include "acme.hh"
+#include "acme_aabb.hh"
+#include "acme_point.hh"
+#include "acme_ray.hh"
+#include "acme_triangle.hh"
+
+namespace acme
+{
+
+  /*\
+   |   _        _                   _      ____  _            _    
+   |  | |_ _ __(_) __ _ _ __   __ _| | ___| __ )| | ___   ___| | __
+   |  | __| '__| |/ _` | '_ \ / _` | |/ _ \  _ \| |/ _ \ / __| |/ /
+   |  | |_| |  | | (_| | | | | (_| | |  __/ |_) | | (_) | (__|   < 
+   |   \__|_|  |_|\__,_|_| |_|\__, |_|\___|____/|_|\___/ \___|_|\_\
+   |                          |___/                                
+  \*/
+
+  //! Triangle block class container
+  /**
+   * Block of triangles stored in structure-of-arrays layout. Each coordinate of each
+   * triangle vertex is stored in a separate aligned array with one lane per triangle,
+   * so that one ray can be tested against all the triangles of the block with packed
+   * instructions. Unused lanes are filled with Not-a-Number vertices and never hit.
+   */
+  class triangleBlock
+  {
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef std::vector<triangleBlock, Eigen::aligned_allocator<triangleBlock>> vec; //!< Vector of triangle blocks
+
+    static integer const LANES = 8; //!< Number of triangles in a block
+
+  private:
+    EIGEN_ALIGN_MAX real m_vertex[3][3][LANES]; //!< Triangles vertices coordinates [vertex][axis][lane]
+    integer m_id[LANES];                        //!< Triangles ids (may be used in external algorithms)
+    integer m_size;                             //!< Number of used lanes
+
+  public:
+    //! Triangle block class destructor
+    ~triangleBlock() {}
+
+    //! Triangle block copy constructor
+    triangleBlock(triangleBlock const &) = default;
+
+    //! Triangle block class constructor
+    triangleBlock();
+
+    //! Equality operator
+    triangleBlock &
+    operator=(
+        triangleBlock const &triangleBlock_in //!< Input triangle block object
+    ) = default;
+
+    //! Clear the triangle block (all lanes set to Not-a-Number)
+    void
+    clear(void);
+
+    //! Get number of used lanes
+    integer
+    size(void) const;
+
+    //! Check if all the lanes are used
+    bool
+    isFull(void) const;
+
+    //! Check if no lane is used
+    bool
+    isEmpty(void) const;
+
+    //! Add a triangle in the first free lane (return false if the block is full)
+    bool
+    push_back(
+        triangle const &triangle_in, //!< Input triangle
+        integer id = 0               //!< Input triangle id
+    );
+
+    //! Replace the i-th lane triangle (the lane id is kept)
+    void
+    set(
+        integer i,                  //!< Input i-th lane
+        triangle const &triangle_in //!< Input triangle
+    );
+
+    //! Get i-th lane triangle id
+    integer
+    id(
+        integer i //!< Input i-th lane
+    ) const ACME_NOEXCEPT;
+
+    //! Get i-th lane triangle
+    triangle
+    getTriangle(
+        integer i //!< Input i-th lane
+    ) const;
+
+    //! Get the minimum bounding aabb of the used lanes
+    void
+    clamp(
+        aabb &aabb_out //!< Output aabb
+    ) const;
+
+    //! Intersect a ray with all the triangles of the block and get the nearest hit \n
+    //! The watertight formulation by Woop, Benthin and Wald is used, so rays through
+    //! shared edges and vertices never slip between adjacent triangles. The input t is
+    //! the upper bound of the ray parameter and it is updated only on hit. Hit point is
+    //! given by origin + t * direction = vertex0 + u * edge1 + v * edge2.
+    bool
+    intersection(
+        ray const &ray_in, //!< Input ray
+        integer &lane,     //!< Output nearest hit lane
+        real &t,           //!< Input/Output ray parameter (upper bound/nearest hit)
+        real &u,           //!< Output barycentric coordinate along first edge
+        real &v            //!< Output barycentric coordinate along second edge
+    ) const;
+
+  }; // class triangleBlock
+
+} // namespace acme
+
+#endif
+
+///
+/// eof: acme_triangleBlock.hh
+///
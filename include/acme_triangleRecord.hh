@@ -0,0 +1,162 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+///
+/// file: acme_triangleRecord.hh
+///
+
+#ifndef INCLUDE_ACME_TRIANGLERECORD
+#define INCLUDE_ACME_TRIANGLERECORD
+
+#include "acme.hh"
+#include "acme_plane.hh"
+#include "acme_point.hh"
+#include "acme_triangle.hh"
+
+namespace acme
+{
+
+  /*\
+   |   _        _                   _      ____                        _ 
+   |  | |_ _ __(_) __ _ _ __   __ _| | ___|  _ \ ___  ___ ___  _ __ __| |
+   |  | __| '__| |/ _` | '_ \ / _` | |/ _ \ |_) / _ \/ __/ _ \| '__/ _` |
+   |  | |_| |  | | (_| | | | | (_| | |  __/  _ <  __/ (_| (_) | | | (_| |
+   |   \__|_|  |_|\__,_|_| |_|\__, |_|\___|_| \_\___|\___\___/|_|  \__,_|
+   |                          |___/                                      
+  \*/
+
+  //! Triangle record class container
+  /**
+   * Precomputed triangle data used to speed up the intersection kernels. The record
+   * stores the unit normal and the offset of the triangle laying plane, together with
+   * two affine rows that map any point in 3D space to the barycentric coordinates of
+   * its projection on the triangle plane (Baldwin-Weber style transformation). A record
+   * is built once from a triangle and it does not follow subsequent modifications of
+   * the triangle vertices.
+   */
+  class triangleRecord
+  {
+  private:
+    vec3 m_normal;  //!< Triangle laying plane unit normal vector
+    real m_d;       //!< Triangle laying plane offset (normal.dot(point) + d = 0)
+    vec3 m_beta;    //!< Barycentric coordinate row of the second vertex
+    real m_beta_d;  //!< Barycentric coordinate offset of the second vertex
+    vec3 m_gamma;   //!< Barycentric coordinate row of the third vertex
+    real m_gamma_d; //!< Barycentric coordinate offset of the third vertex
+
+  public:
+    //! Triangle record class destructor
+    ~triangleRecord() {}
+
+    //! Triangle record copy constructor
+    triangleRecord(triangleRecord const &) = default;
+
+    //! Triangle record move constructor
+    triangleRecord(triangleRecord &&) = default;
+
+    //! Triangle record class constructor
+    triangleRecord();
+
+    //! Triangle record class constructor
+    triangleRecord(
+        triangle const &triangle_in //!< Input triangle
+    );
+
+    //! Equality operator
+    triangleRecord &
+    operator=(
+        triangleRecord const &triangleRecord_in //!< Input triangle record object
+    );
+
+    //! Build triangle record from a triangle
+    void
+    build(
+        triangle const &triangle_in //!< Input triangle
+    );
+
+    //! Clear the triangle record (set to Not-a-Number)
+    void
+    clear(void);
+
+    //! Check if triangle record is degenerated (Not-a-Number)
+    bool
+    isDegenerated(void) const;
+
+    //! Get triangle face normal (normalized vector) const reference
+    vec3 const &
+    normal(void) const;
+
+    //! Get triangle laying plane offset
+    real
+    d(void) const;
+
+    //! Get triangle laying plane
+    plane
+    layingPlane(void) const;
+
+    //! Compute signed distance from point to triangle laying plane
+    real
+    signedDistance(
+        point const &point_in //!< Input point
+    ) const;
+
+    //! Compute barycentric coordinates (u,v,w) for point (projected on the triangle plane)
+    void
+    barycentric(
+        point const &point_in, //!< Input point
+        real &u,               //!< Output barycentric coordinate u
+        real &v,               //!< Output barycentric coordinate v
+        real &w                //!< Output barycentric coordinate w
+    ) const;
+
+    //! Check if a point lays inside the triangle
+    bool
+    isInside(
+        point const &point_in,   //!< Query point
+        real tolerance = EPSILON //!< Tolerance
+    ) const;
+
+    //! Check if barycentric coordinates (u,v,w) lay inside the triangle \n
+    //! Coordinates down to -tolerance are accepted, so that points on an edge shared
+    //! by two triangles are not missed by both because of rounding.
+    static bool
+    isInside(
+        real u,                  //!< Input barycentric coordinate u
+        real v,                  //!< Input barycentric coordinate v
+        real w,                  //!< Input barycentric coordinate w
+        real tolerance = EPSILON //!< Tolerance
+    );
+
+  }; // class triangleRecord
+
+} // namespace acme
+
+#endif
+
+///
+/// eof: acme_triangleRecord.hh
+///
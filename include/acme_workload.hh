@@ -0,0 +1,289 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_workload.hh
+///
+
+#ifndef INCLUDE_ACME_WORKLOAD
+#define INCLUDE_ACME_WORKLOAD
+
+#include <random>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_disk.hh"
+#include "acme_ray.hh"
+#include "acme_triangle.hh"
+
+namespace acme
+{
+
+  /*\
+   |                       _ 
+   |   _ __ ___   __ _  __| |
+   |  | '__/ _ \ / _` |/ _` |
+   |  | | | (_) | (_| | (_| |
+   |  |_|  \___/ \__,_|\__,_|
+   |                         
+  \*/
+
+  //! Road terrain generator class container
+  /**
+   * Seeded procedural road mesh for scaling experiments. The road runs along the x axis
+   * with a winding centerline and is meshed on a regular grid in road coordinates
+   * (x, lateral offset from the centerline), sidewalks included. The surface has grade,
+   * undulations and fine roughness, kerbs at the road edges, circular potholes, and
+   * bridges raising the deck over a ground strip meshed below it (two overlapping
+   * layers). The same seed and parameters give the same mesh on every machine: the
+   * random sequence comes from std::mt19937, whose output is fully specified.
+  */
+  class road
+  {
+  private:
+    //! Pothole data
+    struct pothole
+    {
+      real x;      //!< Center x value
+      real offset; //!< Center lateral offset
+      real radius; //!< Radius
+      real depth;  //!< Depth
+    };
+
+    //! Bridge data
+    struct bridge
+    {
+      real start;  //!< Deck start x value
+      real end;    //!< Deck end x value
+      real height; //!< Deck height over the ground
+    };
+
+    unsigned int m_seed;             //!< Random seed
+    real m_length;                   //!< Road length
+    real m_width;                    //!< Road (carriageway) width
+    real m_sidewalk;                 //!< Sidewalk width on each side
+    real m_resolution;               //!< Grid cell size
+    real m_kerb;                     //!< Kerb height (zero for no kerbs)
+    real m_phase;                    //!< Undulations phase
+    real m_grade;                    //!< Longitudinal grade
+    std::vector<pothole> m_potholes; //!< Potholes
+    std::vector<bridge> m_bridges;   //!< Bridges
+
+    //! Get deterministic lattice noise in [-1, 1]
+    real
+    noise(
+        integer i, //!< Input lattice x index
+        integer j  //!< Input lattice y index
+    ) const;
+
+    //! Get smooth lattice noise in [-1, 1]
+    real
+    smoothNoise(
+        real x, //!< Input x value
+        real y  //!< Input y value
+    ) const;
+
+    //! Get ground height (no bridges) in road coordinates
+    real
+    groundHeight(
+        real x,     //!< Input x value
+        real offset //!< Input lateral offset from the centerline
+    ) const;
+
+    //! Get grid nodes along the road and across it
+    void
+    grid(
+        integer &nx, //!< Output number of cells along the road
+        integer &ny  //!< Output number of cells across the road
+    ) const;
+
+    //! Add the triangles of a grid patch to a collection
+    void
+    patch(
+        collection &collection_out, //!< Output collection
+        integer start,              //!< Input first cell along the road
+        integer cells,              //!< Input number of cells along the road
+        bool ground                 //!< Input ground (true) or top surface (false) heights
+    ) const;
+
+    //! Get bridge cells range along the road
+    void
+    bridgeCells(
+        bridge const &bridge_in, //!< Input bridge
+        integer &start,          //!< Output first cell
+        integer &cells           //!< Output number of cells
+    ) const;
+
+  public:
+    //! Road class destructor
+    ~road() {}
+
+    //! Road class constructor
+    road(
+        unsigned int seed = 0, //!< Input random seed
+        real length = 1000.0,  //!< Input road length
+        real width = 7.0,      //!< Input road width
+        real resolution = 0.25 //!< Input grid cell size
+    );
+
+    //! Set road features (potholes and bridges are placed at random from the seed)
+    void
+    features(
+        integer potholes, //!< Input number of potholes
+        integer bridges,  //!< Input number of bridges
+        real kerb = 0.15  //!< Input kerb height (zero for no kerbs)
+    );
+
+    //! Set the grid cell size so that the mesh has about the given number of triangles
+    void
+    fit(
+        integer triangles //!< Input target number of triangles
+    );
+
+    //! Get road length
+    real
+    length(void) const;
+
+    //! Get road width
+    real
+    width(void) const;
+
+    //! Get grid cell size
+    real
+    resolution(void) const;
+
+    //! Get number of triangles of the mesh
+    integer
+    size(void) const;
+
+    //! Get centerline lateral position at a x value
+    real
+    centerline(
+        real x //!< Input x value
+    ) const;
+
+    //! Get centerline unit tangent at a x value
+    vec3
+    tangent(
+        real x //!< Input x value
+    ) const;
+
+    //! Get top surface height at a world position (bridge deck where present)
+    real
+    height(
+        real x, //!< Input x value
+        real y  //!< Input y value
+    ) const;
+
+    //! Generate the road mesh triangles into a collection \n
+    //! Triangles are created with collection::emplace_back, so they come from the
+    //! collection memory resource. The collection is not cleared.
+    void
+    generate(
+        collection &collection_out //!< Output collection
+    ) const;
+
+  }; // class road
+
+  /*\
+   |                      _    _                 _ 
+   |  __      _____  _ __| | _| | ___   __ _  __| |
+   |  \ \ /\ / / _ \| '__| |/ / |/ _ \ / _` |/ _` |
+   |   \ V  V / (_) | |  |   <| | (_) | (_| | (_| |
+   |    \_/\_/ \___/|_|  |_|\_\_|\___/ \__,_|\__,_|
+   |                                               
+  \*/
+
+  //! Query workload class container
+  /**
+   * Replayable query stream on a road: a four-wheeled vehicle drives along the road
+   * with a seeded lateral wander, giving per frame the four tire disks (standing on
+   * the surface with a small penetration) and a fan of sensor rays looking at the road
+   * ahead. The same seed, road and parameters give the same stream on every machine.
+  */
+  class workload
+  {
+  private:
+    integer m_frames;          //!< Number of frames
+    integer m_rays;            //!< Number of sensor rays per frame
+    std::vector<disk> m_tires; //!< Tire disks (four per frame)
+    std::vector<ray> m_fan;    //!< Sensor rays (m_rays per frame)
+
+  public:
+    //! Workload class destructor
+    ~workload() {}
+
+    //! Workload class constructor
+    workload();
+
+    //! Clear workload data
+    void
+    clear(void);
+
+    //! Generate the query stream of a vehicle driving along a road
+    void
+    generate(
+        road const &road_in,   //!< Input road
+        integer frames,        //!< Input number of frames
+        integer rays = 16,     //!< Input number of sensor rays per frame
+        unsigned int seed = 0, //!< Input random seed
+        real speed = 20.0,     //!< Input vehicle speed
+        real step = 0.01       //!< Input time step between frames
+    );
+
+    //! Get number of frames
+    integer
+    frames(void) const;
+
+    //! Get number of sensor rays per frame
+    integer
+    rays(void) const;
+
+    //! Get tire disk const reference (wheels: front left, front right, rear left, rear right)
+    disk const &
+    tire(
+        integer frame, //!< Input frame
+        integer wheel  //!< Input wheel [0,3]
+    ) const;
+
+    //! Get sensor ray const reference
+    ray const &
+    sensor(
+        integer frame, //!< Input frame
+        integer i      //!< Input ray index
+    ) const;
+
+  }; // class workload
+
+} // namespace acme
+
+#endif
+
+///
+/// eof: acme_workload.hh
+///
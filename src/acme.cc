@@ -0,0 +1,95 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+///
+/// file: acme.cc
+///
+
+#include "acme.hh"
+
+namespace acme
+{
+
+  /*\
+   |   ____  _        _             
+   |  / ___|| |_ __ _| |_ _   _ ___ 
+   |  \___ \| __/ _` | __| | | / __|
+   |   ___) | || (_| | |_| |_| \__ \
+   |  |____/ \__\__,_|\__|\__,_|___/
+   |                                
+  \*/
+
+  static thread_local status last_status = STATUS_OK;   //!< Thread-local status of the last reported error
+  static thread_local char const *last_error = nullptr; //!< Thread-local message of the last reported error
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  setStatus(
+      status status_in,
+      char const *message)
+      ACME_NOEXCEPT
+  {
+    last_status = status_in;
+    last_error = message;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  status
+  lastStatus(void)
+      ACME_NOEXCEPT
+  {
+    return last_status;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  char const *
+  lastError(void)
+      ACME_NOEXCEPT
+  {
+    return last_error != nullptr ? last_error : "";
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  clearStatus(void)
+      ACME_NOEXCEPT
+  {
+    last_status = STATUS_OK;
+    last_error = nullptr;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme.cc
+///
@@ -40,6 +40,7 @@
 ///
 
 #include "acme_AABBtree.hh"
+#include "acme_instrumentation.hh"
 
 namespace acme
 {
@@ -64,9 +65,27 @@ namespace acme
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   AABBtree::AABBtree()
+      : m_resource(defaultResource()),
+        m_children(allocator<ptr>(m_resource))
   {
-    this->m_ptrbox.reset();
-    this->m_children.clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  AABBtree::AABBtree(
+      memoryResource *resource)
+      : m_resource(resource != nullptr ? resource : defaultResource()),
+        m_children(allocator<ptr>(m_resource))
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  memoryResource *
+  AABBtree::resource(void)
+      const
+  {
+    return this->m_resource;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -88,6 +107,16 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  aabb const &
+  AABBtree::box(void)
+      const
+  {
+    ACME_ASSERT(!this->isEmpty(), "acme::AABBtree::box(): empty tree.")
+    return *this->m_ptrbox;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   AABBtree::build(
       aabb::vecptr const &boxes)
@@ -105,7 +134,7 @@ namespace acme
       return;
     }
 
-    this->m_ptrbox = std::make_shared<aabb const>(boxes, 0, 0);
+    this->m_ptrbox = std::allocate_shared<aabb>(allocator<aabb>(this->m_resource), boxes, 0, 0);
 
     real xmin = this->m_ptrbox->min(0);
     real ymin = this->m_ptrbox->min(1);
@@ -172,8 +201,8 @@ namespace acme
       neg_boxes.erase(mid_idx, neg_boxes.end());
     }
 
-    AABBtree::ptr neg = std::make_shared<AABBtree>();
-    AABBtree::ptr pos = std::make_shared<AABBtree>();
+    AABBtree::ptr neg = std::allocate_shared<AABBtree>(allocator<AABBtree>(this->m_resource), this->m_resource);
+    AABBtree::ptr pos = std::allocate_shared<AABBtree>(allocator<AABBtree>(this->m_resource), this->m_resource);
 
     neg->build(neg_boxes);
     if (!neg->isEmpty())
@@ -261,6 +290,261 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  AABBtree::intersection(
+      AABBtree const &tree,
+      aabb::vecpairid &intersection_list,
+      bool swap_tree)
+      const
+  {
+    if (!tree.m_ptrbox->intersects(*this->m_ptrbox))
+      return;
+    integer icase = (this->m_children.empty() ? 0 : 1) +
+                    (tree.m_children.empty() ? 0 : 2);
+    switch (icase)
+    {
+    case 0: // Both are leafs
+      if (swap_tree)
+        intersection_list.push_back(aabb::pairid(tree.m_ptrbox->id(), this->m_ptrbox->id()));
+      else
+        intersection_list.push_back(aabb::pairid(this->m_ptrbox->id(), tree.m_ptrbox->id()));
+      break;
+    case 1: // First is a tree, second is a leaf
+    {
+      AABBtree::vecptr::const_iterator it;
+      for (it = this->m_children.begin(); it != this->m_children.end(); ++it)
+        tree.intersection(**it, intersection_list, !swap_tree);
+    }
+    break;
+    case 2: // First leaf, second is a tree
+    {
+      AABBtree::vecptr::const_iterator it;
+      for (it = tree.m_children.begin(); it != tree.m_children.end(); ++it)
+        this->intersection(**it, intersection_list, swap_tree);
+    }
+    break;
+    case 3: // First is a tree, second is a tree
+    {
+      AABBtree::vecptr::const_iterator c1;
+      AABBtree::vecptr::const_iterator c2;
+      for (c1 = this->m_children.begin(); c1 != this->m_children.end(); ++c1)
+        for (c2 = tree.m_children.begin(); c2 != tree.m_children.end(); ++c2)
+          (*c1)->intersection(**c2, intersection_list, swap_tree);
+    }
+    break;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  AABBtree::intersection(
+      aabb::vecpairptr &intersection_list)
+      const
+  {
+    if (this->isEmpty())
+      return;
+    AABBtree::vecptr::const_iterator c1;
+    AABBtree::vecptr::const_iterator c2;
+    for (c1 = this->m_children.begin(); c1 != this->m_children.end(); ++c1)
+    {
+      (*c1)->intersection(intersection_list);
+      for (c2 = c1 + 1; c2 != this->m_children.end(); ++c2)
+        (*c1)->intersection(**c2, intersection_list);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  AABBtree::intersection(
+      ray const &ray_in,
+      aabb::vecptr &candidate_list,
+      real t_max)
+      const
+  {
+    if (this->isEmpty())
+      return;
+    vec3 inv_direction(ray_in.direction().cwiseInverse());
+    selectRayCandidates(ray_in.origin(), inv_direction, t_max, *this, candidate_list);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  AABBtree::selectRayCandidates(
+      point const &origin,
+      vec3 const &inv_direction,
+      real t_max,
+      AABBtree const &tree,
+      aabb::vecptr &candidate_list)
+  {
+    real t_entry, t_exit;
+    if (!tree.m_ptrbox->intersects(origin, inv_direction, t_entry, t_exit) || t_entry > t_max)
+      return;
+    if (tree.m_children.empty())
+    {
+      candidate_list.push_back(tree.m_ptrbox);
+    }
+    else
+    {
+      AABBtree::vecptr::const_iterator it;
+      for (it = tree.m_children.begin(); it != tree.m_children.end(); ++it)
+        selectRayCandidates(origin, inv_direction, t_max, **it, candidate_list);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  AABBtree::intersection(
+      ray const &ray_in,
+      std::vector<std::pair<real, integer>> &candidate_list,
+      real t_max)
+      const
+  {
+    integer nodes = -1;
+    this->intersection(ray_in, candidate_list, t_max, nodes);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  AABBtree::intersection(
+      ray const &ray_in,
+      std::vector<std::pair<real, integer>> &candidate_list,
+      real t_max,
+      integer &nodes)
+      const
+  {
+    if (this->isEmpty())
+      return;
+    ACME_PROBE(instrumentation::PROBE_TREE_RAY, nullptr);
+#ifdef ACME_INSTRUMENTATION
+    integer nodes_in = nodes;
+    size_t size_in = candidate_list.size();
+#endif
+    vec3 inv_direction(ray_in.direction().cwiseInverse());
+    selectRayCandidates(ray_in.origin(), inv_direction, t_max, *this, candidate_list, nodes);
+    ACME_PROBE_NODES(nodes_in > 0 ? nodes_in - nodes : 0);
+    ACME_PROBE_HITS(candidate_list.size() - size_in);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  AABBtree::selectRayCandidates(
+      point const &origin,
+      vec3 const &inv_direction,
+      real t_max,
+      AABBtree const &tree,
+      std::vector<std::pair<real, integer>> &candidate_list,
+      integer &nodes)
+  {
+    if (nodes == 0)
+      return;
+    if (nodes > 0)
+      --nodes;
+    real t_entry, t_exit;
+    if (!tree.m_ptrbox->intersects(origin, inv_direction, t_entry, t_exit) || t_entry > t_max)
+      return;
+    if (tree.m_children.empty())
+    {
+      candidate_list.push_back(std::make_pair(t_entry, tree.m_ptrbox->id()));
+    }
+    else
+    {
+      AABBtree::vecptr::const_iterator it;
+      for (it = tree.m_children.begin(); it != tree.m_children.end(); ++it)
+        selectRayCandidates(origin, inv_direction, t_max, **it, candidate_list, nodes);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  AABBtree::leaves(
+      aabb::vecptr &leaf_list)
+      const
+  {
+    if (this->isEmpty())
+      return;
+    if (this->m_children.empty())
+    {
+      leaf_list.push_back(this->m_ptrbox);
+    }
+    else
+    {
+      AABBtree::vecptr::const_iterator it;
+      for (it = this->m_children.begin(); it != this->m_children.end(); ++it)
+        (*it)->leaves(leaf_list);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  AABBtree::refit(
+      std::vector<bool> const &changed)
+  {
+    if (this->isEmpty())
+      return false;
+    if (this->m_children.empty())
+    {
+      size_t id = this->m_ptrbox->id();
+      return id < changed.size() && changed[id];
+    }
+    bool refitted = false;
+    AABBtree::vecptr::const_iterator it;
+    for (it = this->m_children.begin(); it != this->m_children.end(); ++it)
+      refitted = (*it)->refit(changed) || refitted;
+    if (!refitted)
+      return false;
+    // Inner boxes are allocated by the tree itself (see build)
+    it = this->m_children.begin();
+    aabb &box = *std::const_pointer_cast<aabb>(this->m_ptrbox);
+    box.min() = (*it)->m_ptrbox->min();
+    box.max() = (*it)->m_ptrbox->max();
+    for (++it; it != this->m_children.end(); ++it)
+    {
+      box.min() = box.min().cwiseMin((*it)->m_ptrbox->min());
+      box.max() = box.max().cwiseMax((*it)->m_ptrbox->max());
+    }
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  footprint
+  AABBtree::memoryUsage(
+      std::string const &name)
+      const
+  {
+    footprint usage;
+    size_t control = footprint::controlBlock();
+    std::vector<AABBtree const *> nodes(1, this);
+    while (!nodes.empty())
+    {
+      AABBtree const &node = *nodes.back();
+      nodes.pop_back();
+      usage.add(name + "/nodes", sizeof(AABBtree) - sizeof(AABBtree::vecptr));
+      usage.add(name + "/children", sizeof(AABBtree::vecptr) + node.m_children.size() * sizeof(AABBtree::ptr));
+      usage.add("overhead/vector slack", (node.m_children.capacity() - node.m_children.size()) * sizeof(AABBtree::ptr));
+      usage.add("overhead/control blocks", control);
+      if (node.m_ptrbox)
+      {
+        usage.add(name + (node.m_children.empty() ? "/leaf boxes" : "/boxes"), sizeof(aabb));
+        usage.add("overhead/control blocks", control);
+      }
+      AABBtree::vecptr::const_iterator it;
+      for (it = node.m_children.begin(); it != node.m_children.end(); ++it)
+        nodes.push_back(it->get());
+    }
+    return usage;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   real
   AABBtree::minimumExteriorDistance(
       point const &query,
@@ -286,6 +286,30 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool
+  aabb::intersects(
+      point const &origin,
+      vec3 const &inv_direction,
+      real &t_entry,
+      real &t_exit)
+      const
+  {
+    t_entry = 0.0;
+    t_exit = INFTY;
+    for (integer i = 0; i < 3; ++i)
+    {
+      real t0 = (this->m_min[i] - origin[i]) * inv_direction[i];
+      real t1 = (this->m_max[i] - origin[i]) * inv_direction[i];
+      if (t0 > t1)
+        std::swap(t0, t1);
+      t_entry = t0 > t_entry ? t0 : t_entry;
+      t_exit = t1 < t_exit ? t1 : t_exit;
+    }
+    return t_entry <= t_exit;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   aabb::merged(
       std::vector<aabb::ptr> const &boxes)
@@ -30,6 +30,14 @@
 ///
 
 #include "acme_collection.hh"
+#include "acme_instrumentation.hh"
+#include "acme_recorder.hh"
+
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace acme
 {
@@ -46,8 +54,48 @@ namespace acme
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   collection::collection()
-      : m_AABBtree(std::make_shared<AABBtree>())
+      : collection(defaultResource())
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  collection::collection(
+      memoryResource *resource)
+      : m_resource(resource != nullptr ? resource : defaultResource()),
+        m_recorder(nullptr),
+        m_indexed(true),
+        m_AABBtree(std::allocate_shared<AABBtree>(allocator<AABBtree>(m_resource), m_resource)),
+        m_blocksSize(0),
+        m_blocksAABBtree(std::allocate_shared<AABBtree>(allocator<AABBtree>(m_resource), m_resource))
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  memoryResource *
+  collection::resource(void)
+      const
+  {
+    return this->m_resource;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::setRecorder(
+      recorder *recorder_in)
+  {
+    this->m_recorder = recorder_in;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder *
+  collection::getRecorder(void)
+      const
   {
+    return this->m_recorder;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -57,6 +105,7 @@ namespace acme
       : collection()
   {
     this->m_entities = entities;
+    this->buildIndexes();
   };
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -65,6 +114,10 @@ namespace acme
   collection::clear(void)
   {
     this->m_entities.clear();
+    this->buildIndexes();
+    this->clearBounds();
+    this->m_records.clear();
+    this->clearBlocks();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -74,6 +127,11 @@ namespace acme
       size_t size)
   {
     this->m_entities.resize(size);
+    for (integer k = 0; k < TYPES && this->m_indexed; ++k)
+      this->m_indexes[k].erase(std::lower_bound(this->m_indexes[k].begin(), this->m_indexes[k].end(), integer(size)),
+                               this->m_indexes[k].end());
+    this->clearBounds();
+    this->clearBlocks();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -83,15 +141,50 @@ namespace acme
       entity::ptr entity_in)
   {
     this->m_entities.push_back(entity_in);
+    if (this->m_indexed && entity_in)
+      this->m_indexes[typeOf(*entity_in)].push_back(this->m_entities.size() - 1);
+    this->clearBlocks();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-  entity::ptr &collection::operator[](
+  entity::ptr const &
+  collection::modify(
       size_t i)
   {
+    this->markDirty(i);
     return this->m_entities[i];
-  };
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::set(
+      size_t i,
+      entity::ptr entity_in)
+  {
+    if (this->m_indexed)
+    {
+      if (this->m_entities[i])
+      {
+        std::vector<integer> &indexes = this->m_indexes[typeOf(*this->m_entities[i])];
+        indexes.erase(std::lower_bound(indexes.begin(), indexes.end(), integer(i)));
+      }
+      if (entity_in)
+      {
+        std::vector<integer> &indexes = this->m_indexes[typeOf(*entity_in)];
+        indexes.insert(std::lower_bound(indexes.begin(), indexes.end(), integer(i)), i);
+      }
+    }
+    this->m_entities[i] = entity_in;
+    this->markDirty(i);
+    if (this->hasRecords())
+    {
+      this->m_records[i] = triangleRecord();
+      if (entity_in && entity_in->isTriangle())
+        this->m_records[i].build(*dynamic_cast<triangle const *>(entity_in.get()));
+    }
+  }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -111,6 +204,9 @@ namespace acme
   {
     for (size_t i = 0; i < this->m_entities.size(); ++i)
       this->m_entities[i]->translate(input);
+    this->markDirty();
+    this->m_records.clear();
+    this->clearBlocks();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -122,6 +218,9 @@ namespace acme
   {
     for (size_t i = 0; i < this->m_entities.size(); ++i)
       this->m_entities[i]->rotate(angle, axis);
+    this->markDirty();
+    this->m_records.clear();
+    this->clearBlocks();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -132,6 +231,9 @@ namespace acme
   {
     for (size_t i = 0; i < this->m_entities.size(); ++i)
       this->m_entities[i]->transform(matrix);
+    this->markDirty();
+    this->m_records.clear();
+    this->clearBlocks();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -140,12 +242,7 @@ namespace acme
   collection::containNone(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isNone())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_NONE) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -154,12 +251,7 @@ namespace acme
   collection::areNone(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isNone())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_NONE) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -177,11 +269,9 @@ namespace acme
   void
   collection::removeNone(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isNone(); });
+        { return typeOf(*entity) == TYPE_NONE; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -190,13 +280,7 @@ namespace acme
   collection::countNone(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isNone())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_NONE);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -205,12 +289,7 @@ namespace acme
   collection::containPoint(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isPoint())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_POINT) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -219,12 +298,7 @@ namespace acme
   collection::arePoint(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isPoint())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_POINT) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -242,11 +316,9 @@ namespace acme
   void
   collection::removePoint(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isPoint(); });
+        { return typeOf(*entity) == TYPE_POINT; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -255,13 +327,7 @@ namespace acme
   collection::countPoint(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isPoint())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_POINT);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -270,12 +336,7 @@ namespace acme
   collection::containLine(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isLine())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_LINE) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -284,12 +345,7 @@ namespace acme
   collection::areLine(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isLine())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_LINE) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -307,11 +363,9 @@ namespace acme
   void
   collection::removeLine(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isLine(); });
+        { return typeOf(*entity) == TYPE_LINE; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -320,13 +374,7 @@ namespace acme
   collection::countLine(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isLine())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_LINE);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -335,12 +383,7 @@ namespace acme
   collection::containRay(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isRay())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_RAY) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -349,12 +392,7 @@ namespace acme
   collection::areRay(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isRay())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_RAY) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -372,11 +410,9 @@ namespace acme
   void
   collection::removeRay(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isRay(); });
+        { return typeOf(*entity) == TYPE_RAY; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -385,13 +421,7 @@ namespace acme
   collection::countRay(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isRay())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_RAY);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -400,12 +430,7 @@ namespace acme
   collection::containPlane(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isPlane())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_PLANE) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -414,12 +439,7 @@ namespace acme
   collection::arePlane(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isPlane())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_PLANE) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -437,11 +457,9 @@ namespace acme
   void
   collection::removePlane(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isPlane(); });
+        { return typeOf(*entity) == TYPE_PLANE; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -450,13 +468,7 @@ namespace acme
   collection::countPlane(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isPlane())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_PLANE);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -465,12 +477,7 @@ namespace acme
   collection::containSegment(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isSegment())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_SEGMENT) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -479,12 +486,7 @@ namespace acme
   collection::areSegment(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isBall())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_SEGMENT) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -502,11 +504,9 @@ namespace acme
   void
   collection::removeSegment(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isSegment(); });
+        { return typeOf(*entity) == TYPE_SEGMENT; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -515,13 +515,7 @@ namespace acme
   collection::countSegment(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isSegment())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_SEGMENT);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -530,12 +524,7 @@ namespace acme
   collection::containTriangle(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isTriangle())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_TRIANGLE) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -544,12 +533,7 @@ namespace acme
   collection::areTriangle(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isTriangle())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_TRIANGLE) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -567,11 +551,9 @@ namespace acme
   void
   collection::removeTriangle(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isTriangle(); });
+        { return typeOf(*entity) == TYPE_TRIANGLE; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -580,13 +562,7 @@ namespace acme
   collection::countTriangle(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isTriangle())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_TRIANGLE);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -595,12 +571,7 @@ namespace acme
   collection::containDisk(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isDisk())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_DISK) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -609,12 +580,7 @@ namespace acme
   collection::areDisk(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isDisk())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_DISK) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -632,11 +598,9 @@ namespace acme
   void
   collection::removeDisk(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isDisk(); });
+        { return typeOf(*entity) == TYPE_DISK; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -645,13 +609,7 @@ namespace acme
   collection::countDisk(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isDisk())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_DISK);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -660,12 +618,7 @@ namespace acme
   collection::containBall(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isBall())
-        return true;
-    }
-    return false;
+    return this->countType(TYPE_BALL) > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -674,12 +627,7 @@ namespace acme
   collection::areBall(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isBall())
-        return false;
-    }
-    return true;
+    return this->countType(TYPE_BALL) == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -697,11 +645,9 @@ namespace acme
   void
   collection::removeBall(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
-        { return entity->isBall(); });
+        { return typeOf(*entity) == TYPE_BALL; });
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -710,13 +656,7 @@ namespace acme
   collection::countBall(void)
       const
   {
-    integer count = 0;
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isBall())
-        ++count;
-    }
-    return count;
+    return this->countType(TYPE_BALL);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -728,10 +668,10 @@ namespace acme
   {
     for (size_t i = 0; i < this->m_entities.size(); ++i)
     {
-      if (!this->m_entities[i]->isDegenerated(tolerance))
-        return false;
+      if (this->m_entities[i]->isDegenerated(tolerance))
+        return true;
     }
-    return true;
+    return false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -766,9 +706,7 @@ namespace acme
   collection::removeDegenerated(
       real tolerance)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [tolerance](entity::ptr &entity)
         { return entity->isDegenerated(tolerance); });
   }
@@ -795,12 +733,7 @@ namespace acme
   collection::containClampable(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isClampable())
-        return true;
-    }
-    return false;
+    return this->countClampable() > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -809,12 +742,7 @@ namespace acme
   collection::areClampable(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isClampable())
-        return false;
-    }
-    return true;
+    return this->countClampable() == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -832,9 +760,7 @@ namespace acme
   void
   collection::removeClampable(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
         { return entity->isClampable(); });
   }
@@ -846,6 +772,16 @@ namespace acme
       const
   {
     integer count = 0;
+    if (this->m_indexed)
+    {
+      // Clampability is a type property, ask the first entity of each type
+      for (integer k = 0; k < TYPES; ++k)
+      {
+        if (!this->m_indexes[k].empty() && this->m_entities[this->m_indexes[k].front()]->isClampable())
+          count += this->m_indexes[k].size();
+      }
+      return count;
+    }
     for (size_t i = 0; i < this->m_entities.size(); ++i)
     {
       if (this->m_entities[i]->isClampable())
@@ -860,12 +796,7 @@ namespace acme
   collection::containNonClampable(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (this->m_entities[i]->isNonClampable())
-        return true;
-    }
-    return false;
+    return this->countNonClampable() > 0;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -874,12 +805,7 @@ namespace acme
   collection::areNonClampable(void)
       const
   {
-    for (size_t i = 0; i < this->m_entities.size(); ++i)
-    {
-      if (!this->m_entities[i]->isNonClampable())
-        return false;
-    }
-    return true;
+    return this->countNonClampable() == this->size();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -897,9 +823,7 @@ namespace acme
   void
   collection::removeNonClampable(void)
   {
-    remove_if(
-        this->m_entities.begin(),
-        this->m_entities.end(),
+    this->removeIf(
         [](entity::ptr &entity)
         { return entity->isNonClampable(); });
   }
@@ -911,9 +835,19 @@ namespace acme
       const
   {
     integer count = 0;
+    if (this->m_indexed)
+    {
+      // Clampability is a type property, ask the first entity of each type
+      for (integer k = 0; k < TYPES; ++k)
+      {
+        if (!this->m_indexes[k].empty() && this->m_entities[this->m_indexes[k].front()]->isNonClampable())
+          count += this->m_indexes[k].size();
+      }
+      return count;
+    }
     for (size_t i = 0; i < this->m_entities.size(); ++i)
     {
-      if (!this->m_entities[i]->isNonClampable())
+      if (this->m_entities[i]->isNonClampable())
         ++count;
     }
     return count;
@@ -922,66 +856,480 @@ namespace acme
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   integer
-  collection::size(void)
-      const
-  {
-    return this->m_entities.size();
+  collection::typeOf(
+      entity const &entity_in)
+  {
+    if (entity_in.isNone())
+      return TYPE_NONE;
+    else if (entity_in.isPoint())
+      return TYPE_POINT;
+    else if (entity_in.isLine())
+      return TYPE_LINE;
+    else if (entity_in.isRay())
+      return TYPE_RAY;
+    else if (entity_in.isPlane())
+      return TYPE_PLANE;
+    else if (entity_in.isSegment())
+      return TYPE_SEGMENT;
+    else if (entity_in.isTriangle())
+      return TYPE_TRIANGLE;
+    else if (entity_in.isDisk())
+      return TYPE_DISK;
+    else if (entity_in.isBall())
+      return TYPE_BALL;
+    ACME_ERROR("acme::collection::typeOf(): unknown entity type.")
+    return TYPE_NONE;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-  std::map<std::string, integer>
-  collection::count(
-      real tolerance)
+  integer
+  collection::countType(
+      integer type)
       const
   {
-    return {{"none", this->countNone()},
-            {"point", this->countPoint()},
-            {"line", this->countLine()},
-            {"ray", this->countRay()},
-            {"plane", this->countPlane()},
-            {"segment", this->countSegment()},
-            {"triangle", this->countTriangle()},
-            {"disk", this->countDisk()},
-            {"ball", this->countBall()},
-            {"degenerated", this->countDegenerated(tolerance)},
-            {"clampable", this->countClampable()},
-            {"non-clampable", this->countNonClampable()}};
+    if (this->m_indexed)
+      return this->m_indexes[type].size();
+    integer count = 0;
+    for (size_t i = 0; i < this->m_entities.size(); ++i)
+    {
+      if (this->m_entities[i] && typeOf(*this->m_entities[i]) == type)
+        ++count;
+    }
+    return count;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
-  collection::clamp(
-      aabb::vecptr &boxes)
-      const
+  collection::buildIndexes(void)
   {
-    boxes.clear();
-    vec3 min;
-    vec3 max;
+    for (integer k = 0; k < TYPES; ++k)
+      this->m_indexes[k].clear();
     for (size_t i = 0; i < this->m_entities.size(); ++i)
     {
-      if (this->m_entities[i]->clamp(min, max))
-        boxes.push_back(std::make_shared<aabb>(min, max, i, 0));
-      else
-        ACME_ERROR("acme::collection::clamp(): non-clampable object detected.");
+      if (this->m_entities[i])
+        this->m_indexes[typeOf(*this->m_entities[i])].push_back(i);
     }
+    this->m_indexed = true;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-  void
-  collection::buildAABBtree(void)
+  bool
+  collection::hasIndexes(void)
+      const
   {
+    return this->m_indexed;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::indexes(
+      std::string const &type,
+      std::vector<integer> &indexes)
+      const
+  {
+    indexes.clear();
+    if (this->m_indexed)
+    {
+      for (integer k = 0; k < TYPES; ++k)
+      {
+        if (!this->m_indexes[k].empty() && this->m_entities[this->m_indexes[k].front()]->type() == type)
+          indexes = this->m_indexes[k];
+      }
+      return;
+    }
+    for (size_t i = 0; i < this->m_entities.size(); ++i)
+    {
+      if (this->m_entities[i]->type() == type)
+        indexes.push_back(i);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  collection::size(void)
+      const
+  {
+    return this->m_entities.size();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  std::map<std::string, integer>
+  collection::count(
+      real tolerance)
+      const
+  {
+    return {{"none", this->countNone()},
+            {"point", this->countPoint()},
+            {"line", this->countLine()},
+            {"ray", this->countRay()},
+            {"plane", this->countPlane()},
+            {"segment", this->countSegment()},
+            {"triangle", this->countTriangle()},
+            {"disk", this->countDisk()},
+            {"ball", this->countBall()},
+            {"degenerated", this->countDegenerated(tolerance)},
+            {"clampable", this->countClampable()},
+            {"non-clampable", this->countNonClampable()}};
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::clamp(
+      aabb::vecptr &boxes)
+      const
+  {
+    boxes.clear();
+    vec3 min;
+    vec3 max;
+    for (size_t i = 0; i < this->m_entities.size(); ++i)
+    {
+      if (this->m_entities[i]->clamp(min, max))
+        boxes.push_back(std::allocate_shared<aabb>(allocator<aabb>(this->m_resource), min, max, i, 0));
+      else
+        ACME_ERROR("acme::collection::clamp(): non-clampable object detected.");
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::buildAABBtree(
+      bool records)
+  {
+    // Entities may have been modified without being marked dirty
+    this->markDirty();
+    this->updateBounds(false);
+    this->m_AABBtree->build(this->m_bounds);
+    this->clearBlocks();
+    if (records)
+      this->buildRecords();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::refitAABBtree(void)
+  {
+    bool blocks = !this->m_blocks.empty();
+    if (this->m_AABBtree->isEmpty() || this->m_bounds.empty() ||
+        this->m_bounds.size() != this->m_entities.size())
+    {
+      this->buildAABBtree(!this->m_records.empty());
+      if (blocks)
+        this->buildBlocks();
+      return;
+    }
+    if (this->m_dirty.empty())
+      return;
+    std::vector<bool> changed(this->m_changed);
+    std::vector<integer> dirty(this->m_dirty);
+    this->updateBounds(true);
+    this->m_AABBtree->refit(changed);
+    if (this->hasRecords())
+    {
+      for (size_t i = 0; i < dirty.size(); ++i)
+      {
+        triangle const *triangle_ptr = dynamic_cast<triangle const *>(this->m_entities[dirty[i]].get());
+        this->m_records[dirty[i]] = triangleRecord();
+        if (triangle_ptr != nullptr)
+          this->m_records[dirty[i]].build(*triangle_ptr);
+      }
+    }
+    if (blocks)
+      this->refitBlocks(dirty);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::updateBounds(
+      bool in_place)
+  {
+    vec3 min;
+    vec3 max;
+    for (size_t i = 0; i < this->m_dirty.size(); ++i)
+    {
+      integer j = this->m_dirty[i];
+      if (!this->m_entities[j]->clamp(min, max))
+        ACME_ERROR("acme::collection::updateBounds(): non-clampable object detected.");
+      if (in_place)
+      {
+        // Cached boxes are allocated by the collection itself
+        aabb &box = *std::const_pointer_cast<aabb>(this->m_bounds[j]);
+        box.min() = min;
+        box.max() = max;
+      }
+      else
+        this->m_bounds[j] = std::allocate_shared<aabb>(allocator<aabb>(this->m_resource), min, max, j, 0);
+      this->m_changed[j] = false;
+    }
+    this->m_dirty.clear();
+    for (size_t i = this->m_bounds.size(); i < this->m_entities.size(); ++i)
+    {
+      if (!this->m_entities[i]->clamp(min, max))
+        ACME_ERROR("acme::collection::updateBounds(): non-clampable object detected.");
+      this->m_bounds.push_back(std::allocate_shared<aabb>(allocator<aabb>(this->m_resource), min, max, i, 0));
+    }
+    this->m_changed.resize(this->m_bounds.size(), false);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::refitBlocks(
+      std::vector<integer> const &dirty)
+  {
+    if (this->m_blocksSize != this->m_entities.size())
+    {
+      this->buildBlocks();
+      return;
+    }
+    std::vector<bool> changed(this->m_blocks.size(), false);
+    for (size_t i = 0; i < dirty.size(); ++i)
+    {
+      integer lane = this->m_lanes[dirty[i]];
+      triangle const *triangle_ptr = dynamic_cast<triangle const *>(this->m_entities[dirty[i]].get());
+      if ((lane < 0) != (triangle_ptr == nullptr))
+      {
+        this->buildBlocks();
+        return;
+      }
+      if (lane < 0)
+        continue;
+      this->m_blocks[lane / triangleBlock::LANES].set(lane % triangleBlock::LANES, *triangle_ptr);
+      changed[lane / triangleBlock::LANES] = true;
+    }
+    for (size_t i = 0; i < this->m_blocks.size(); ++i)
+    {
+      // Blocks boxes are allocated by the collection itself (see buildBlocks)
+      if (changed[i])
+        this->m_blocks[i].clamp(*std::const_pointer_cast<aabb>(this->m_blocksBounds[i]));
+    }
+    this->m_blocksAABBtree->refit(changed);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::clearBlocks(void)
+  {
+    this->m_blocks.clear();
+    this->m_lanes.clear();
+    this->m_blocksBounds.clear();
+    this->m_blocksAABBtree->clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::clearBounds(void)
+  {
+    this->m_bounds.clear();
+    this->m_changed.clear();
+    this->m_dirty.clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::markDirty(
+      size_t i)
+  {
+    if (i < this->m_changed.size() && !this->m_changed[i])
+    {
+      this->m_changed[i] = true;
+      this->m_dirty.push_back(i);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::markDirty(void)
+  {
+    for (size_t i = 0; i < this->m_changed.size(); ++i)
+      this->markDirty(i);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::isDirty(
+      size_t i)
+      const
+  {
+    return i >= this->m_changed.size() || this->m_changed[i];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  collection::countDirty(void)
+      const
+  {
+    integer count = this->m_dirty.size();
+    if (this->m_entities.size() > this->m_bounds.size())
+      count += this->m_entities.size() - this->m_bounds.size();
+    return count;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::buildRecords(void)
+  {
+    this->m_records.clear();
+    this->m_records.resize(this->m_entities.size());
+    std::vector<integer> triangles;
+    this->indexes("triangle", triangles);
+    for (size_t i = 0; i < triangles.size(); ++i)
+      this->m_records[triangles[i]].build(*dynamic_cast<triangle const *>(this->m_entities[triangles[i]].get()));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::hasRecords(void)
+      const
+  {
+    return !this->m_records.empty() &&
+           this->m_records.size() == this->m_entities.size();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  triangleRecord const &
+  collection::record(
+      size_t i)
+      const ACME_NOEXCEPT
+  {
+    ACME_ASSERT_DEBUG(i < this->m_records.size(),
+                      "acme::collection::record(): triangle records not built or index out of range.");
+    return this->m_records[i];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  collection::buildBlocks(void)
+  {
+    if (this->m_AABBtree->isEmpty())
+      this->buildAABBtree();
+
+    aabb::vecptr leaves;
+    this->m_AABBtree->leaves(leaves);
+
+    this->m_blocks.clear();
+    this->m_lanes.assign(this->m_entities.size(), -1);
+    triangleBlock block;
+    for (size_t i = 0; i < leaves.size(); ++i)
+    {
+      integer id = leaves[i]->id();
+      if (!this->m_entities[id]->isTriangle())
+        continue;
+      this->m_lanes[id] = this->m_blocks.size() * triangleBlock::LANES + block.size();
+      block.push_back(*dynamic_cast<triangle const *>(this->m_entities[id].get()), id);
+      if (block.isFull())
+      {
+        this->m_blocks.push_back(block);
+        block.clear();
+      }
+    }
+    if (!block.isEmpty())
+      this->m_blocks.push_back(block);
+
     aabb::vecptr ptrVecbox;
-    this->clamp(ptrVecbox);
-    this->m_AABBtree->build(ptrVecbox);
+    aabb box;
+    for (size_t i = 0; i < this->m_blocks.size(); ++i)
+    {
+      this->m_blocks[i].clamp(box);
+      ptrVecbox.push_back(std::allocate_shared<aabb>(allocator<aabb>(this->m_resource), box.min(), box.max(), i, 0));
+    }
+    this->m_blocksAABBtree->build(ptrVecbox);
+    this->m_blocksBounds.swap(ptrVecbox);
+    this->m_blocksSize = this->m_entities.size();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::hasBlocks(void)
+      const
+  {
+    return !this->m_blocks.empty() &&
+           this->m_blocksSize == this->m_entities.size() &&
+           this->m_dirty.empty();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  footprint
+  collection::memoryUsage(void)
+      const
+  {
+    static char const *names[TYPES] = {"none", "point", "line", "ray", "plane", "segment", "triangle", "disk", "ball"};
+    static size_t const sizes[TYPES] = {sizeof(none), sizeof(point), sizeof(line), sizeof(ray), sizeof(plane),
+                                        sizeof(segment), sizeof(triangle), sizeof(disk), sizeof(ball)};
+    footprint usage;
+    size_t control = footprint::controlBlock();
+
+    // Entities (payload, vtable pointer and control block)
+    size_t counts[TYPES] = {0};
+    for (size_t i = 0; i < this->m_entities.size(); ++i)
+      ++counts[typeOf(*this->m_entities[i])];
+    for (integer i = 0; i < TYPES; ++i)
+    {
+      if (counts[i] == 0)
+        continue;
+      usage.add(std::string("entities/") + names[i], counts[i] * (sizes[i] - sizeof(void *)));
+      usage.add("overhead/vtable pointers", counts[i] * sizeof(void *));
+      usage.add("overhead/control blocks", counts[i] * control);
+    }
+
+    // Collection containers
+    usage.add("collection/object", sizeof(collection));
+    usage.add("collection/pointers", this->m_entities.size() * sizeof(entity::ptr));
+    usage.add("overhead/vector slack", (this->m_entities.capacity() - this->m_entities.size()) * sizeof(entity::ptr));
+    for (integer i = 0; i < TYPES; ++i)
+    {
+      usage.add("collection/indexes", this->m_indexes[i].size() * sizeof(integer));
+      usage.add("overhead/vector slack", (this->m_indexes[i].capacity() - this->m_indexes[i].size()) * sizeof(integer));
+    }
+    usage.add("collection/records", this->m_records.size() * sizeof(triangleRecord));
+    usage.add("overhead/vector slack", (this->m_records.capacity() - this->m_records.size()) * sizeof(triangleRecord));
+    usage.add("collection/bounds", this->m_bounds.size() * sizeof(aabb::ptr) + (this->m_changed.size() + 7) / 8);
+    usage.add("overhead/vector slack", (this->m_bounds.capacity() - this->m_bounds.size()) * sizeof(aabb::ptr));
+    usage.add("collection/dirty", this->m_dirty.capacity() * sizeof(integer));
+    usage.add("collection/blocks", this->m_blocks.size() * sizeof(triangleBlock) + this->m_lanes.size() * sizeof(integer) +
+                                       this->m_blocksBounds.size() * sizeof(aabb::ptr));
+    usage.add("overhead/vector slack", (this->m_blocks.capacity() - this->m_blocks.size()) * sizeof(triangleBlock));
+
+    // AABB trees
+    usage.add(this->m_AABBtree->memoryUsage("tree"));
+    usage.add(this->m_blocksAABBtree->memoryUsage("blocks tree"));
+    return usage;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  AABBtree::ptr const &
+  collection::ptrAABBtree(void)
+  {
+    return this->m_AABBtree;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   AABBtree::ptr const &
   collection::ptrAABBtree(void)
+      const
   {
     return this->m_AABBtree;
   }
@@ -1049,19 +1397,896 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool
+  collection::intersection(
+      collection const &entities,
+      aabb::vecpairid &candidates)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_TREE, nullptr);
+    candidates.clear();
+    if (this->m_AABBtree->isEmpty() || entities.m_AABBtree->isEmpty())
+      return false;
+    this->m_AABBtree->intersection(*entities.m_AABBtree, candidates);
+    ACME_PROBE_HITS(candidates.size());
+    return !candidates.empty();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      AABBtree::ptr const &ptrAABBtree,
+      aabb::vecid &candidates)
+      const
+  {
+    context scratch;
+    return this->intersection(ptrAABBtree, candidates, scratch);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      AABBtree::ptr const &ptrAABBtree,
+      aabb::vecid &candidates,
+      context &scratch)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_TREE, nullptr);
+    candidates.clear();
+    if (this->m_AABBtree->isEmpty() || ptrAABBtree->isEmpty())
+      return false;
+    aabb::vecpairid &intersection_list = scratch.pairs();
+    intersection_list.clear();
+    this->m_AABBtree->intersection(*ptrAABBtree, intersection_list);
+    candidates.reserve(intersection_list.size());
+    for (size_t i = 0; i < intersection_list.size(); ++i)
+      candidates.push_back(intersection_list[i].first);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    ACME_PROBE_HITS(candidates.size());
+    return !candidates.empty();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      aabb::vecptr const &ptrVecbox,
+      aabb::vecid &candidates)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_BOX, nullptr);
+    candidates.clear();
+    for (size_t i = 0; i < ptrVecbox.size(); ++i)
+    {
+      aabb const &box = *ptrVecbox[i];
+      this->m_AABBtree->select(
+          [&box](aabb const &box_k) { return box.intersects(box_k); },
+          candidates);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    ACME_PROBE_HITS(candidates.size());
+    return !candidates.empty();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      aabb const &box,
+      aabb::vecid &candidates)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_BOX, nullptr);
+    candidates.clear();
+    this->m_AABBtree->select(
+        [&box](aabb const &box_k) { return box.intersects(box_k); },
+        candidates);
+    ACME_PROBE_HITS(candidates.size());
+    return !candidates.empty();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::nearestHit(
+      ray const &ray_in,
+      real t_max,
+      integer &id,
+      real &t,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    bool blocks = this->hasBlocks();
+    bool records = this->hasRecords();
+    AABBtree::ptr const &ptrAABBtree = blocks ? this->m_blocksAABBtree : this->m_AABBtree;
+
+    // Sort candidates by ray entry parameter to stop at the first hit
+    scratch.start();
+    context::vecentry &entries = scratch.entries();
+    entries.clear();
+    integer nodes = scratch.nodesLeft();
+    ptrAABBtree->intersection(ray_in, entries, t_max, nodes);
+    scratch.updateNodes(nodes);
+    std::sort(entries.begin(), entries.end());
+
+    point const &origin = ray_in.origin();
+    vec3 const &direction = ray_in.direction();
+
+    t = t_max;
+    integer nearest = -1;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+      if (entries[i].first > t || !scratch.test())
+        break;
+      integer k = entries[i].second;
+      if (blocks)
+      {
+        integer lane;
+        real u, v;
+        if (this->m_blocks[k].intersection(ray_in, lane, t, u, v))
+          nearest = this->m_blocks[k].id(lane);
+      }
+      else if (this->m_entities[k]->isTriangle())
+      {
+        point point_hit;
+        bool hit = records
+                       ? acme::intersection(ray_in, this->m_records[k], point_hit, tolerance)
+                       : acme::intersection(ray_in, *dynamic_cast<triangle const *>(this->m_entities[k].get()), point_hit, tolerance);
+        if (hit)
+        {
+          real t_hit = (point_hit - origin).dot(direction) / direction.squaredNorm();
+          if (t_hit <= t)
+          {
+            t = t_hit;
+            nearest = k;
+          }
+        }
+      }
+    }
+    if (nearest < 0)
+      return false;
+    id = nearest;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      ray const &ray_in,
+      integer &id,
+      point &point_out,
+      real tolerance)
+      const
+  {
+    context scratch;
+    return this->intersection(ray_in, id, point_out, scratch, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      ray const &ray_in,
+      integer &id,
+      point &point_out,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_RAY, &scratch);
+    recorder::guard record(this->m_recorder, ray_in, tolerance);
+    real t;
+    if (!this->nearestHit(ray_in, INFTY, id, t, scratch, tolerance))
+      return false;
+    ACME_PROBE_HITS(1);
+    point_out = ray_in.origin() + t * ray_in.direction();
+    record.result(id, 1, t, point_out);
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      segment const &segment_in,
+      integer &id,
+      point &point_out,
+      real tolerance)
+      const
+  {
+    context scratch;
+    return this->intersection(segment_in, id, point_out, scratch, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      segment const &segment_in,
+      integer &id,
+      point &point_out,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_SEGMENT, &scratch);
+    recorder::guard record(this->m_recorder, segment_in, tolerance);
+    real t;
+    ray ray_in(segment_in.vertex(0), segment_in.toVector());
+    if (!this->nearestHit(ray_in, 1.0, id, t, scratch, tolerance))
+      return false;
+    ACME_PROBE_HITS(1);
+    point_out = ray_in.origin() + t * ray_in.direction();
+    record.result(id, 1, t, point_out);
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      disk const &disk_in,
+      std::vector<segment> &segments,
+      std::vector<integer> &ids,
+      std::vector<vec3> &normals,
+      real tolerance)
+      const
+  {
+    context scratch;
+    return this->intersection(disk_in, segments, ids, normals, scratch, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      disk const &disk_in,
+      std::vector<segment> &segments,
+      std::vector<integer> &ids,
+      std::vector<vec3> &normals,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_DISK, &scratch);
+    recorder::guard record(this->m_recorder, disk_in, tolerance);
+    segments.clear();
+    ids.clear();
+    normals.clear();
+
+    scratch.start();
+    aabb::vecid &candidates = scratch.candidates();
+    candidates.clear();
+    this->m_AABBtree->select(
+        [&disk_in, tolerance, &scratch](aabb const &box) { return scratch.visit() && acme::intersection(disk_in, box, tolerance); },
+        candidates);
+
+    // Contact segments (degenerated segments are discarded)
+    segment segment_hit;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      integer k = candidates[i];
+      if (!this->m_entities[k]->isTriangle())
+        continue;
+      if (!scratch.test())
+        break;
+      triangle const &triangle_k = *dynamic_cast<triangle const *>(this->m_entities[k].get());
+      if (!acme::intersection(triangle_k, disk_in, segment_hit, tolerance) ||
+          segment_hit.length() <= tolerance)
+        continue;
+      segments.push_back(segment_hit);
+      ids.push_back(k);
+      normals.push_back(this->hasRecords() ? this->m_records[k].normal() : triangle_k.normal());
+    }
+
+    // Cluster the segments endpoints (e = 2 * segment + end) into nodes: endpoints are
+    // sorted along the axis of largest extent and only the endpoints within tolerance
+    // along that axis are compared. Each node is a linked list of its endpoints.
+    integer size = segments.size();
+    integer ends = 2 * size;
+    auto endpoint = [&segments](integer e) -> point const & { return segments[e / 2].vertex(e % 2); };
+    vec3 min(vec3::Constant(INFTY));
+    vec3 max(vec3::Constant(-INFTY));
+    for (integer e = 0; e < ends; ++e)
+    {
+      min = min.cwiseMin(endpoint(e));
+      max = max.cwiseMax(endpoint(e));
+    }
+    integer axis = 0;
+    if (size > 0)
+      (max - min).maxCoeff(&axis);
+    context::vecentry &sorted = scratch.entries();
+    sorted.clear();
+    for (integer e = 0; e < ends; ++e)
+      sorted.push_back(context::entry(endpoint(e)[axis], e));
+    std::sort(sorted.begin(), sorted.end());
+    aabb::vecid &nodes = candidates; // Node of each endpoint, then next endpoint of the same node
+    nodes.assign(2 * ends, -1);
+    for (integer i = 0; i < ends; ++i)
+    {
+      integer e = sorted[i].second;
+      if (nodes[e] >= 0)
+        continue;
+      nodes[e] = e;
+      for (integer j = i + 1; j < ends && sorted[j].first - sorted[i].first <= tolerance; ++j)
+      {
+        integer f = sorted[j].second;
+        if (nodes[f] < 0 && (endpoint(e) - endpoint(f)).norm() <= tolerance)
+        {
+          nodes[f] = e;
+          nodes[ends + f] = nodes[ends + e];
+          nodes[ends + e] = f;
+        }
+      }
+    }
+
+    // Segments state: free, used or discarded (duplicated or collapsed to a node)
+    enum
+    {
+      FREE = 0,
+      USED = 1,
+      DISCARDED = 2
+    };
+    context::vecentry &state = sorted; // Endpoints order is no longer needed
+    state.assign(size, context::entry(0.0, FREE));
+    for (integer k = 0; k < size; ++k)
+    {
+      integer node0 = nodes[2 * k], node1 = nodes[2 * k + 1];
+      if (node0 == node1)
+        state[k].second = DISCARDED;
+      for (integer f = node0; f >= 0 && state[k].second == FREE; f = nodes[ends + f])
+        if (f / 2 < k && state[f / 2].second == FREE && nodes[f ^ 1] == node1)
+          state[k].second = DISCARDED;
+    }
+    auto count = [&nodes, &state, ends](integer e, bool free) {
+      integer n = 0;
+      for (integer f = nodes[e]; f >= 0; f = nodes[ends + f])
+        n += free ? state[f / 2].second == FREE : state[f / 2].second != DISCARDED;
+      return n;
+    };
+    auto direction = [&segments](integer k, bool reverse) -> vec3 {
+      return reverse ? vec3(segments[k].vertex(0) - segments[k].vertex(1)) : vec3(segments[k].toVector());
+    };
+
+    // Walk the polylines, from the free endpoints first and then along the closed ones.
+    // A segment entering a node shared only with the previous segment is merged with it
+    // if they are collinear and lay on the same plane (same triangle normal).
+    enum
+    {
+      REVERSE = 1,
+      MERGE = 2,
+      START = 4
+    };
+    aabb::vecpairid &order = scratch.pairs();
+    order.clear();
+    for (integer pass = 0; pass < 2; ++pass)
+    {
+      for (integer e = 0; e < ends; ++e)
+      {
+        if (state[e / 2].second != FREE || (pass == 0 && count(e, true) != 1))
+          continue;
+        integer previous = -1;
+        for (integer f = e; f >= 0;)
+        {
+          integer k = f / 2;
+          bool reverse = (f % 2) == 1;
+          state[k].second = USED;
+          integer flags = (reverse ? REVERSE : 0) | (previous < 0 ? START : 0);
+          if (previous >= 0 && count(f, false) == 2)
+          {
+            vec3 direction0(direction(order[previous].first, (order[previous].second & REVERSE) != 0));
+            vec3 direction1(direction(k, reverse));
+            if (direction0.dot(direction1) > 0.0 &&
+                direction0.cross(direction1).norm() <= tolerance * direction0.norm() * direction1.norm() &&
+                (normals[order[previous].first] - normals[k]).norm() <= tolerance)
+              flags |= MERGE;
+          }
+          previous = order.size();
+          order.push_back(aabb::pairid(k, flags));
+          integer exit = f ^ 1;
+          f = -1;
+          for (integer g = nodes[exit]; g >= 0 && f < 0; g = nodes[ends + g])
+            if (state[g / 2].second == FREE)
+              f = g;
+        }
+      }
+    }
+
+    // Ordered, oriented and merged segments are appended and the unordered ones erased,
+    // so that consecutive segments share their endpoints exactly
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+      integer k = order[i].first;
+      integer flags = order[i].second;
+      segment segment_k(segments[k]);
+      if (flags & REVERSE)
+        segment_k.swap();
+      if (flags & MERGE)
+      {
+        segments.back().vertex(1) = segment_k.vertex(1);
+        continue;
+      }
+      if (!(flags & START))
+        segment_k.vertex(0) = segments.back().vertex(1);
+      integer id_k = ids[k];
+      vec3 normal_k(normals[k]);
+      segments.push_back(segment_k);
+      ids.push_back(id_k);
+      normals.push_back(normal_k);
+    }
+    segments.erase(segments.begin(), segments.begin() + size);
+    ids.erase(ids.begin(), ids.begin() + size);
+    normals.erase(normals.begin(), normals.begin() + size);
+    ACME_PROBE_HITS(segments.size());
+    if (!segments.empty())
+    {
+      real length = 0.0;
+      for (size_t i = 0; i < segments.size(); ++i)
+        length += segments[i].length();
+      record.result(ids.front(), segments.size(), length, segments.front().vertex(0));
+    }
+    return !segments.empty();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      ball const &ball_in,
+      real &depth,
+      vec3 &normal,
+      std::vector<integer> &ids,
+      point &point_out,
+      real tolerance)
+      const
+  {
+    context scratch;
+    return this->intersection(ball_in, depth, normal, ids, point_out, scratch, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      ball const &ball_in,
+      real &depth,
+      vec3 &normal,
+      std::vector<integer> &ids,
+      point &point_out,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_BALL, &scratch);
+    recorder::guard record(this->m_recorder, ball_in, tolerance);
+    ids.clear();
+    depth = 0.0;
+    normal = vec3::Zero();
+
+    aabb box;
+    ball_in.clamp(box.min(), box.max());
+    scratch.start();
+    aabb::vecid &candidates = scratch.candidates();
+    candidates.clear();
+    this->m_AABBtree->select(
+        [&box, &scratch](aabb const &box_k) { return scratch.visit() && box.intersects(box_k); },
+        candidates);
+
+    // Contacts in front of the faces, seen from behind the faces through their
+    // boundary (closest point to the center), and behind the faces (face normal)
+    enum
+    {
+      FRONT = 0,
+      EDGE = 1,
+      BEHIND = 2
+    };
+    vec3 normals[3] = {vec3::Zero(), vec3::Zero(), vec3::Zero()};
+    real depths[3] = {-INFTY, -INFTY, -INFTY};
+    point points[3];
+    bool through = false;
+    point point_hit;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      integer k = candidates[i];
+      if (!this->m_entities[k]->isTriangle())
+        continue;
+      if (!scratch.test())
+        break;
+      triangle const &triangle_k = *dynamic_cast<triangle const *>(this->m_entities[k].get());
+      if (!acme::intersection(triangle_k, ball_in, point_hit, tolerance))
+        continue;
+      vec3 face(this->hasRecords() ? this->m_records[k].normal() : triangle_k.normal());
+      vec3 direction(ball_in.center() - point_hit);
+      real distance = direction.norm();
+      real side = direction.dot(face);
+      real depth_k = ball_in.radius() - distance;
+      // Ball center on the triangle: fall back to the face normal
+      if (distance > tolerance)
+        direction /= distance;
+      else
+        direction = face;
+      integer kind = FRONT;
+      if (side < -tolerance)
+      {
+        // The center has passed through the face if its projection is the closest point
+        kind = EDGE;
+        through = through || distance + side <= tolerance;
+        real depth_behind = ball_in.radius() - side;
+        normals[BEHIND] += depth_behind * face;
+        if (depth_behind > depths[BEHIND])
+        {
+          depths[BEHIND] = depth_behind;
+          points[BEHIND] = point_hit;
+        }
+      }
+      normals[kind] += std::max(depth_k, tolerance) * direction;
+      if (depth_k > depths[kind])
+      {
+        depths[kind] = depth_k;
+        points[kind] = point_hit;
+      }
+      ids.push_back(k);
+    }
+
+    // Deep penetration: the contacts seen from behind push along the faces normals
+    integer other = through ? BEHIND : EDGE;
+    integer deepest = depths[FRONT] >= depths[other] ? FRONT : other;
+    normal = normals[FRONT] + normals[other];
+    if (!ids.empty())
+    {
+      depth = depths[deepest];
+      point_out = points[deepest];
+    }
+    real norm = normal.norm();
+    if (norm > 0.0)
+      normal /= norm;
+    ACME_PROBE_HITS(ids.size());
+    if (!ids.empty())
+      record.result(ids.front(), ids.size(), depth, normal);
+    return !ids.empty();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      ball const &ball_in,
+      vec3 const &displacement,
+      real &time,
+      integer &id,
+      vec3 &normal,
+      point &point_out,
+      real tolerance)
+      const
+  {
+    context scratch;
+    return this->intersection(ball_in, displacement, time, id, normal, point_out, scratch, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      ball const &ball_in,
+      vec3 const &displacement,
+      real &time,
+      integer &id,
+      vec3 &normal,
+      point &point_out,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_BALL_SWEPT, &scratch);
+    recorder::guard record(this->m_recorder, ball_in, displacement, tolerance);
+    id = -1;
+    aabb box;
+    vec3 extent(vec3::Constant(ball_in.radius()));
+    box.min() = ball_in.center().cwiseMin(ball_in.center() + displacement) - extent;
+    box.max() = ball_in.center().cwiseMax(ball_in.center() + displacement) + extent;
+    scratch.start();
+    aabb::vecid &candidates = scratch.candidates();
+    candidates.clear();
+    this->m_AABBtree->select(
+        [&box, &scratch](aabb const &box_k) { return scratch.visit() && box.intersects(box_k); },
+        candidates);
+
+    real t_k;
+    point point_k;
+    vec3 normal_k;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      integer k = candidates[i];
+      if (!this->m_entities[k]->isTriangle())
+        continue;
+      if (!scratch.test())
+        break;
+      triangle const &triangle_k = *dynamic_cast<triangle const *>(this->m_entities[k].get());
+      if (!acme::intersection(ball_in, displacement, triangle_k, t_k, point_k, normal_k, tolerance))
+        continue;
+      if (id < 0 || t_k < time)
+      {
+        id = k;
+        time = t_k;
+        normal = normal_k;
+        point_out = point_k;
+      }
+    }
+    ACME_PROBE_HITS(id >= 0 ? 1 : 0);
+    if (id >= 0)
+      record.result(id, 1, time, normal);
+    return id >= 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      disk const &disk_in,
+      vec3 const &displacement,
+      vec3 const &rotation,
+      real resolution,
+      real &time,
+      integer &id,
+      vec3 &normal,
+      point &point_out,
+      real tolerance)
+      const
+  {
+    context scratch;
+    return this->intersection(disk_in, displacement, rotation, resolution, time, id, normal, point_out, scratch, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      disk const &disk_in,
+      vec3 const &displacement,
+      vec3 const &rotation,
+      real resolution,
+      real &time,
+      integer &id,
+      vec3 &normal,
+      point &point_out,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    ACME_PROBE(instrumentation::PROBE_DISK_SWEPT, &scratch);
+    recorder::guard record(this->m_recorder, disk_in, displacement, rotation, resolution, tolerance);
+    id = -1;
+    ball bound(disk_in.radius(), disk_in.center());
+    aabb box;
+    vec3 extent(vec3::Constant(bound.radius()));
+    box.min() = bound.center().cwiseMin(bound.center() + displacement) - extent;
+    box.max() = bound.center().cwiseMax(bound.center() + displacement) + extent;
+    scratch.start();
+    aabb::vecid &candidates = scratch.candidates();
+    candidates.clear();
+    this->m_AABBtree->select(
+        [&box, &scratch](aabb const &box_k) { return scratch.visit() && box.intersects(box_k); },
+        candidates);
+
+    // Order the candidates by the impact time of the disk bounding ball (lower bound)
+    context::vecentry &bounds = scratch.entries();
+    bounds.clear();
+    real t_k;
+    point point_k;
+    vec3 normal_k;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      integer k = candidates[i];
+      if (!this->m_entities[k]->isTriangle())
+        continue;
+      if (!scratch.test())
+        break;
+      triangle const &triangle_k = *dynamic_cast<triangle const *>(this->m_entities[k].get());
+      if (acme::intersection(bound, displacement, triangle_k, t_k, point_k, normal_k, tolerance))
+        bounds.push_back(std::make_pair(t_k, k));
+    }
+    std::sort(bounds.begin(), bounds.end());
+
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+      if ((id >= 0 && bounds[i].first > time) || !scratch.test())
+        break;
+      integer k = bounds[i].second;
+      triangle const &triangle_k = *dynamic_cast<triangle const *>(this->m_entities[k].get());
+      if (!acme::intersection(disk_in, displacement, rotation, triangle_k, resolution,
+                              t_k, point_k, normal_k, tolerance))
+        continue;
+      if (id < 0 || t_k < time)
+      {
+        id = k;
+        time = t_k;
+        normal = normal_k;
+        point_out = point_k;
+      }
+    }
+    ACME_PROBE_HITS(id >= 0 ? 1 : 0);
+    if (id >= 0)
+      record.result(id, 1, time, normal);
+    return id >= 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      std::vector<ray> const &rays,
+      std::vector<integer> &ids,
+      std::vector<point> &points,
+      integer threads,
+      real tolerance)
+      const
+  {
+    integer size = rays.size();
+    ids.assign(size, -1);
+    points.assign(size, NAN_POINT);
+    integer hits = 0;
+#ifdef _OPENMP
+    if (threads <= 0)
+      threads = omp_get_max_threads();
+#else
+    (void)threads;
+#endif
+#pragma omp parallel num_threads(threads) if (size > 64)
+    {
+      context scratch;
+#pragma omp for schedule(dynamic, 16) reduction(+ : hits)
+      for (integer i = 0; i < size; ++i)
+      {
+        if (this->intersection(rays[i], ids[i], points[i], scratch, tolerance))
+          ++hits;
+      }
+    }
+    return hits > 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  collection::intersection(
+      std::vector<segment> const &segments,
+      std::vector<integer> &ids,
+      std::vector<point> &points,
+      integer threads,
+      real tolerance)
+      const
+  {
+    integer size = segments.size();
+    ids.assign(size, -1);
+    points.assign(size, NAN_POINT);
+    integer hits = 0;
+#ifdef _OPENMP
+    if (threads <= 0)
+      threads = omp_get_max_threads();
+#else
+    (void)threads;
+#endif
+#pragma omp parallel num_threads(threads) if (size > 64)
+    {
+      context scratch;
+#pragma omp for schedule(dynamic, 16) reduction(+ : hits)
+      for (integer i = 0; i < size; ++i)
+      {
+        if (this->intersection(segments[i], ids[i], points[i], scratch, tolerance))
+          ++hits;
+      }
+    }
+    return hits > 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   collection::intersection(
       collection &entities,
-      real tolerance)
+      real tolerance,
+      integer threads)
       const
   {
-    int size = this->m_entities.size();
     entities.clear();
-    for (size_t i = 0; i < size; ++i)
-      for (size_t j = i; j < size; ++j)
-        entities.push_back(entity::ptr(acme::intersection(this->m_entities[i].get(),
-                                                          this->m_entities[j].get(),
-                                                          tolerance)));
+    size_t size = this->m_entities.size();
+
+    // Candidate pairs (all pairs if some entity cannot be boxed)
+    std::vector<std::pair<integer, integer>> pairs;
+    if (this->containNonClampable())
+    {
+      for (size_t i = 0; i < size; ++i)
+        for (size_t j = i + 1; j < size; ++j)
+          pairs.push_back(std::make_pair(i, j));
+    }
+    else
+    {
+      // The collection tree is used only if it is up to date (no new or dirty entities)
+      AABBtree::ptr ptrAABBtree(this->m_AABBtree);
+      if (ptrAABBtree->isEmpty() || this->m_bounds.size() != size || !this->m_dirty.empty())
+      {
+        aabb::vecptr ptrVecbox;
+        this->clamp(ptrVecbox);
+        ptrAABBtree = std::make_shared<AABBtree>();
+        ptrAABBtree->build(ptrVecbox);
+      }
+      aabb::vecpairptr intersection_list;
+      ptrAABBtree->intersection(intersection_list);
+      pairs.reserve(intersection_list.size());
+      for (size_t k = 0; k < intersection_list.size(); ++k)
+      {
+        integer i = intersection_list[k].first->id();
+        integer j = intersection_list[k].second->id();
+        if (i != j)
+          pairs.push_back(std::make_pair(std::min(i, j), std::max(i, j)));
+      }
+      std::sort(pairs.begin(), pairs.end());
+    }
+
+    // Exact intersections (the first error is forwarded out of the threads)
+    integer count = pairs.size();
+    std::vector<entity::ptr> results(count);
+#ifdef ACME_NO_EXCEPTIONS
+    char const *error = nullptr;
+#else
+    std::exception_ptr exception;
+#endif
+#ifdef _OPENMP
+    if (threads <= 0)
+      threads = omp_get_max_threads();
+#else
+    (void)threads;
+#endif
+#pragma omp parallel for schedule(dynamic, 16) num_threads(threads) if (count > 64)
+    for (integer k = 0; k < count; ++k)
+    {
+#ifdef ACME_NO_EXCEPTIONS
+      clearStatus();
+      entity::ptr result(acme::intersection(this->m_entities[pairs[k].first].get(),
+                                            this->m_entities[pairs[k].second].get(),
+                                            tolerance));
+      if (!result->isNone())
+        results[k] = result;
+      if (lastStatus() != STATUS_OK)
+      {
+#pragma omp critical
+        if (error == nullptr)
+          error = lastError();
+      }
+#else
+      try
+      {
+        entity::ptr result(acme::intersection(this->m_entities[pairs[k].first].get(),
+                                              this->m_entities[pairs[k].second].get(),
+                                              tolerance));
+        if (!result->isNone())
+          results[k] = result;
+      }
+      catch (...)
+      {
+#pragma omp critical
+        if (!exception)
+          exception = std::current_exception();
+      }
+#endif
+    }
+#ifdef ACME_NO_EXCEPTIONS
+    if (error != nullptr)
+      setStatus(STATUS_ERROR, error);
+#else
+    if (exception)
+      std::rethrow_exception(exception);
+#endif
+    for (integer k = 0; k < count; ++k)
+    {
+      if (results[k])
+        entities.push_back(results[k]);
+    }
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -0,0 +1,248 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_context.cc
+///
+
+#include "acme_context.hh"
+
+namespace acme
+{
+
+  /*\
+   |                   _            _   
+   |    ___ ___  _ __ | |_ _____  _| |_ 
+   |   / __/ _ \| '_ \| __/ _ \ \/ / __|
+   |  | (_| (_) | | | | ||  __/>  <| |_ 
+   |   \___\___/|_| |_|\__\___/_/\_\\__|
+   |                                    
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  context::context()
+      : m_max_nodes(0),
+        m_max_primitives(0),
+        m_timed(false),
+        m_nodes(0),
+        m_primitives(0),
+        m_exhausted(false)
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  context::reserve(
+      integer size)
+  {
+    this->m_candidates.reserve(size);
+    this->m_entries.reserve(size);
+    this->m_pairs.reserve(size);
+    this->m_instances.reserve(size);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  context::clear(void)
+  {
+    this->m_candidates.clear();
+    this->m_entries.clear();
+    this->m_pairs.clear();
+    this->m_instances.clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  aabb::vecid &
+  context::candidates(void)
+  {
+    return this->m_candidates;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  context::vecentry &
+  context::entries(void)
+  {
+    return this->m_entries;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  aabb::vecpairid &
+  context::pairs(void)
+  {
+    return this->m_pairs;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  context::vecentry &
+  context::instances(void)
+  {
+    return this->m_instances;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  context::budget(
+      integer nodes,
+      integer primitives)
+  {
+    this->m_max_nodes = nodes;
+    this->m_max_primitives = primitives;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  context::deadline(
+      timepoint const &deadline_in)
+  {
+    this->m_timed = true;
+    this->m_deadline = deadline_in;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  context::deadline(
+      real seconds)
+  {
+    this->deadline(clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<real>(seconds)));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  context::unlimited(void)
+  {
+    this->m_max_nodes = 0;
+    this->m_max_primitives = 0;
+    this->m_timed = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  context::isExhausted(void)
+      const
+  {
+    return this->m_exhausted;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  context::nodes(void)
+      const
+  {
+    return this->m_nodes;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  context::primitives(void)
+      const
+  {
+    return this->m_primitives;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  context::start(void)
+  {
+    this->m_nodes = 0;
+    this->m_primitives = 0;
+    this->m_exhausted = this->m_timed && clock::now() >= this->m_deadline;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  context::nodesLeft(void)
+      const
+  {
+    integer max_nodes = this->m_max_nodes > 0 ? this->m_max_nodes : std::numeric_limits<integer>::max();
+    return std::max(0, max_nodes - this->m_nodes);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  context::updateNodes(
+      integer nodes_left)
+  {
+    integer max_nodes = this->m_max_nodes > 0 ? this->m_max_nodes : std::numeric_limits<integer>::max();
+    this->m_nodes = max_nodes - nodes_left;
+    if (nodes_left == 0)
+      this->m_exhausted = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  context::visit(void)
+  {
+    if (this->m_max_nodes > 0 && this->m_nodes >= this->m_max_nodes)
+    {
+      this->m_exhausted = true;
+      return false;
+    }
+    ++this->m_nodes;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  context::test(void)
+  {
+    if ((this->m_max_primitives > 0 && this->m_primitives >= this->m_max_primitives) ||
+        (this->m_timed && clock::now() >= this->m_deadline))
+    {
+      this->m_exhausted = true;
+      return false;
+    }
+    ++this->m_primitives;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme_context.cc
+///
@@ -215,6 +215,22 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  point
+  disk::closestPoint(
+      point const &point_in)
+      const
+  {
+    vec3 normal(this->m_plane.normal().normalized());
+    vec3 radial(point_in - this->m_plane.origin());
+    radial -= radial.dot(normal) * normal;
+    real distance = radial.norm();
+    if (distance > this->m_radius)
+      radial *= this->m_radius / distance;
+    return this->m_plane.origin() + radial;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   disk::translate(
       vec3 const &vector_in)
@@ -0,0 +1,491 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_instrumentation.cc
+///
+
+#include "acme_instrumentation.hh"
+#include "acme_context.hh"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace acme
+{
+
+  /*\
+   |   _           _                                   _        _   _             
+   |  (_)_ __  ___| |_ _ __ _   _ _ __ ___   ___ _ __ | |_ __ _| |_(_) ___  _ __  
+   |  | | '_ \/ __| __| '__| | | | '_ ` _ \ / _ \ '_ \| __/ _` | __| |/ _ \| '_ \ 
+   |  | | | | \__ \ |_| |  | |_| | | | | | |  __/ | | | || (_| | |_| | (_) | | | |
+   |  |_|_| |_|___/\__|_|   \__,_|_| |_| |_|\___|_| |_|\__\__,_|\__|_|\___/|_| |_|
+   |                                                                              
+  \*/
+
+  //! Instrumentation event
+  struct event
+  {
+    instrumentation::probe kind;                 //!< Query kind
+    char const *label;                           //!< Event label
+    std::chrono::steady_clock::time_point start; //!< Start time
+    uint64_t duration;                           //!< Duration [ns]
+    uint64_t nodes;                              //!< Tree nodes visited
+    uint64_t primitives;                         //!< Primitives tested
+    uint64_t hits;                               //!< Hits returned
+    uint64_t thread;                             //!< Thread id
+  };
+
+  //! Instrumentation counters of a query kind (single writer, relaxed atomics)
+  struct counters
+  {
+    std::atomic<uint64_t> calls;                            //!< Number of calls
+    std::atomic<uint64_t> nodes;                            //!< Tree nodes visited
+    std::atomic<uint64_t> primitives;                       //!< Primitives tested
+    std::atomic<uint64_t> hits;                             //!< Hits returned
+    std::atomic<uint64_t> time;                             //!< Total time [ns]
+    std::atomic<uint64_t> histogram[instrumentation::BINS]; //!< Latency histogram
+  };
+
+  //! Instrumentation data of a thread
+  struct threadData
+  {
+    uint64_t thread;                          //!< Thread id
+    counters probes[instrumentation::PROBES]; //!< Counters of each query kind
+    std::vector<event> events;                //!< Events ring
+    std::atomic<uint64_t> head;               //!< Events recorded since the last reset
+  };
+
+  //! Instrumentation registry of the threads
+  struct registry
+  {
+    std::mutex mutex;                                             //!< Registry mutex
+    std::vector<threadData *> threads;                            //!< Live threads data
+    instrumentation::statistics retired[instrumentation::PROBES]; //!< Statistics of the exited threads
+    std::vector<event> events;                                    //!< Events of the exited threads
+    uint64_t count;                                               //!< Threads registered so far
+    std::chrono::steady_clock::time_point origin;                 //!< Trace time origin
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static registry &
+  instrumentationRegistry(void)
+  {
+    // Never destroyed, so that threads exiting after main can still retire their data
+    static registry *instance = []()
+    {
+      registry *r = new registry();
+      r->count = 0;
+      r->origin = std::chrono::steady_clock::now();
+      for (integer i = 0; i < instrumentation::PROBES; ++i)
+        r->retired[i] = instrumentation::statistics();
+      return r;
+    }();
+    return *instance;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static void
+  add(
+      std::atomic<uint64_t> &counter,
+      uint64_t value)
+  {
+    // Only the owning thread writes, so a relaxed load and store are enough
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  //! Thread-local holder of the instrumentation data of a thread
+  class threadHolder
+  {
+  public:
+    threadData *data; //!< Thread data
+
+    //! Register the calling thread
+    threadHolder(void)
+    {
+      this->data = new threadData();
+      for (integer i = 0; i < instrumentation::PROBES; ++i)
+      {
+        counters &c = this->data->probes[i];
+        c.calls.store(0);
+        c.nodes.store(0);
+        c.primitives.store(0);
+        c.hits.store(0);
+        c.time.store(0);
+        for (integer j = 0; j < instrumentation::BINS; ++j)
+          c.histogram[j].store(0);
+      }
+      this->data->head.store(0);
+      registry &r = instrumentationRegistry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      this->data->thread = ++r.count;
+      r.threads.push_back(this->data);
+    }
+
+    //! Retire the calling thread, merging its data into the registry
+    ~threadHolder(void)
+    {
+      registry &r = instrumentationRegistry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      for (integer i = 0; i < instrumentation::PROBES; ++i)
+      {
+        counters const &c = this->data->probes[i];
+        instrumentation::statistics &s = r.retired[i];
+        s.calls += c.calls.load();
+        s.nodes += c.nodes.load();
+        s.primitives += c.primitives.load();
+        s.hits += c.hits.load();
+        s.time += c.time.load();
+        for (integer j = 0; j < instrumentation::BINS; ++j)
+          s.histogram[j] += c.histogram[j].load();
+      }
+      uint64_t head = this->data->head.load();
+      uint64_t size = this->data->events.size();
+      for (uint64_t i = head > size ? head - size : 0; i < head; ++i)
+        r.events.push_back(this->data->events[i % size]);
+      if (r.events.size() > static_cast<size_t>(instrumentation::EVENTS))
+        r.events.erase(r.events.begin(), r.events.end() - instrumentation::EVENTS);
+      for (size_t i = 0; i < r.threads.size(); ++i)
+      {
+        if (r.threads[i] == this->data)
+        {
+          r.threads.erase(r.threads.begin() + i);
+          break;
+        }
+      }
+      delete this->data;
+    }
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static threadData &
+  instrumentationThread(void)
+  {
+    static thread_local threadHolder holder;
+    return *holder.data;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static void
+  collect(
+      std::vector<event> &events)
+  {
+    registry &r = instrumentationRegistry();
+    events = r.events;
+    for (size_t k = 0; k < r.threads.size(); ++k)
+    {
+      threadData const &t = *r.threads[k];
+      uint64_t head = t.head.load();
+      uint64_t size = t.events.size();
+      for (uint64_t i = head > size ? head - size : 0; i < head; ++i)
+        events.push_back(t.events[i % size]);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static void
+  escape(
+      std::FILE *file,
+      char const *text)
+  {
+    for (; *text != '\0'; ++text)
+    {
+      unsigned char c = static_cast<unsigned char>(*text);
+      if (c == '"' || c == '\\')
+        std::fprintf(file, "\\%c", c);
+      else if (c < 0x20)
+        std::fprintf(file, "\\u%04x", c);
+      else
+        std::fputc(c, file);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  instrumentation::scope::~scope()
+  {
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    uint64_t nodes = this->m_nodes;
+    uint64_t primitives = 0;
+    if (this->m_context != nullptr)
+    {
+      nodes = static_cast<uint64_t>(this->m_context->nodes());
+      primitives = static_cast<uint64_t>(this->m_context->primitives());
+    }
+    instrumentation::record(this->m_kind, this->m_label, this->m_start, stop, nodes, primitives, this->m_hits);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  instrumentation::scope::scope(
+      probe kind,
+      context const *context_in)
+      : m_kind(kind),
+        m_label(instrumentation::name(kind)),
+        m_context(context_in),
+        m_nodes(0),
+        m_hits(0),
+        m_start(std::chrono::steady_clock::now())
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  instrumentation::scope::scope(
+      char const *label)
+      : m_kind(PROBE_SCOPE),
+        m_label(label),
+        m_context(nullptr),
+        m_nodes(0),
+        m_hits(0),
+        m_start(std::chrono::steady_clock::now())
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  instrumentation::scope::hits(
+      uint64_t hits_in)
+  {
+    this->m_hits = hits_in;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  instrumentation::scope::nodes(
+      uint64_t nodes_in)
+  {
+    this->m_nodes = nodes_in;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  instrumentation::isEnabled(void)
+  {
+#ifdef ACME_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  char const *
+  instrumentation::name(
+      probe kind)
+  {
+    switch (kind)
+    {
+    case PROBE_RAY:
+      return "collection/ray";
+    case PROBE_SEGMENT:
+      return "collection/segment";
+    case PROBE_DISK:
+      return "collection/disk";
+    case PROBE_BALL:
+      return "collection/ball";
+    case PROBE_BALL_SWEPT:
+      return "collection/ball-swept";
+    case PROBE_DISK_SWEPT:
+      return "collection/disk-swept";
+    case PROBE_BOX:
+      return "collection/box";
+    case PROBE_TREE:
+      return "collection/tree";
+    case PROBE_TREE_RAY:
+      return "AABBtree/ray";
+    case PROBE_DISPATCH:
+      return "intersection";
+    case PROBE_SCOPE:
+      return "scope";
+    default:
+      return "none";
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  instrumentation::statistics
+  instrumentation::snapshot(
+      probe kind)
+  {
+    ACME_ASSERT(kind >= 0 && kind < PROBES,
+                "acme::instrumentation::snapshot(): invalid query kind.")
+    registry &r = instrumentationRegistry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    statistics s = r.retired[kind];
+    for (size_t k = 0; k < r.threads.size(); ++k)
+    {
+      counters const &c = r.threads[k]->probes[kind];
+      s.calls += c.calls.load(std::memory_order_relaxed);
+      s.nodes += c.nodes.load(std::memory_order_relaxed);
+      s.primitives += c.primitives.load(std::memory_order_relaxed);
+      s.hits += c.hits.load(std::memory_order_relaxed);
+      s.time += c.time.load(std::memory_order_relaxed);
+      for (integer j = 0; j < BINS; ++j)
+        s.histogram[j] += c.histogram[j].load(std::memory_order_relaxed);
+    }
+    return s;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  instrumentation::reset(void)
+  {
+    registry &r = instrumentationRegistry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (integer i = 0; i < PROBES; ++i)
+      r.retired[i] = statistics();
+    r.events.clear();
+    for (size_t k = 0; k < r.threads.size(); ++k)
+    {
+      threadData &t = *r.threads[k];
+      for (integer i = 0; i < PROBES; ++i)
+      {
+        counters &c = t.probes[i];
+        c.calls.store(0, std::memory_order_relaxed);
+        c.nodes.store(0, std::memory_order_relaxed);
+        c.primitives.store(0, std::memory_order_relaxed);
+        c.hits.store(0, std::memory_order_relaxed);
+        c.time.store(0, std::memory_order_relaxed);
+        for (integer j = 0; j < BINS; ++j)
+          c.histogram[j].store(0, std::memory_order_relaxed);
+      }
+      t.head.store(0);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  instrumentation::exportTrace(
+      std::string const &file)
+  {
+    std::FILE *out = std::fopen(file.c_str(), "w");
+    if (out == nullptr)
+      return false;
+    registry &r = instrumentationRegistry();
+    std::vector<event> events;
+    {
+      std::lock_guard<std::mutex> lock(r.mutex);
+      collect(events);
+    }
+    std::fprintf(out, "{\"traceEvents\":[");
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+      event const &e = events[i];
+      real ts = std::chrono::duration<real, std::micro>(e.start - r.origin).count();
+      std::fprintf(out, "%s\n{\"name\":\"", i == 0 ? "" : ",");
+      escape(out, e.label);
+      std::fprintf(out,
+                   "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%llu,"
+                   "\"args\":{\"nodes\":%llu,\"primitives\":%llu,\"hits\":%llu}}",
+                   e.kind == PROBE_SCOPE ? "scope" : "query", ts, e.duration / 1000.0,
+                   static_cast<unsigned long long>(e.thread),
+                   static_cast<unsigned long long>(e.nodes),
+                   static_cast<unsigned long long>(e.primitives),
+                   static_cast<unsigned long long>(e.hits));
+    }
+    std::fprintf(out, "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{");
+    for (integer i = 0; i < PROBES; ++i)
+    {
+      statistics s = snapshot(static_cast<probe>(i));
+      std::fprintf(out,
+                   "%s\n\"%s\":{\"calls\":%llu,\"nodes\":%llu,\"primitives\":%llu,\"hits\":%llu,\"time_ns\":%llu}",
+                   i == 0 ? "" : ",", name(static_cast<probe>(i)),
+                   static_cast<unsigned long long>(s.calls),
+                   static_cast<unsigned long long>(s.nodes),
+                   static_cast<unsigned long long>(s.primitives),
+                   static_cast<unsigned long long>(s.hits),
+                   static_cast<unsigned long long>(s.time));
+    }
+    std::fprintf(out, "\n}}\n");
+    return std::fclose(out) == 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  instrumentation::record(
+      probe kind,
+      char const *label,
+      std::chrono::steady_clock::time_point start,
+      std::chrono::steady_clock::time_point stop,
+      uint64_t nodes,
+      uint64_t primitives,
+      uint64_t hits)
+  {
+    threadData &t = instrumentationThread();
+    uint64_t duration = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+    integer bin = 0;
+    for (uint64_t d = duration; d > 1 && bin < BINS - 1; d >>= 1)
+      ++bin;
+    counters &c = t.probes[kind];
+    add(c.calls, 1);
+    add(c.nodes, nodes);
+    add(c.primitives, primitives);
+    add(c.hits, hits);
+    add(c.time, duration);
+    add(c.histogram[bin], 1);
+    if (t.events.empty())
+      t.events.resize(EVENTS);
+    uint64_t head = t.head.load(std::memory_order_relaxed);
+    event &e = t.events[head % EVENTS];
+    e.kind = kind;
+    e.label = label;
+    e.start = start;
+    e.duration = duration;
+    e.nodes = nodes;
+    e.primitives = primitives;
+    e.hits = hits;
+    e.thread = t.thread;
+    t.head.store(head + 1, std::memory_order_release);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme_instrumentation.cc
+///
@@ -30,6 +30,7 @@
 ///
 
 #include "acme_intersection.hh"
+#include "acme_instrumentation.hh"
 
 namespace acme
 {
@@ -50,7 +51,9 @@ namespace acme
       entity const *entity0_in,
       entity const *entity1_in,
       real tolerance)
+      ACME_NOEXCEPT
   {
+    ACME_PROBE(instrumentation::PROBE_DISPATCH, nullptr);
     integer slide = entity0_in->level() * 100 + entity1_in->level();
     bool collide = false;
     entity *entity_out = nullptr;
@@ -230,7 +233,10 @@ namespace acme
                                *dynamic_cast<segment *>(entity_out),
                                tolerance);
         if (!collide)
+        {
           delete entity_out;
+          entity_out = nullptr;
+        }
         else
           break;
 
@@ -754,6 +760,7 @@ namespace acme
         break;
 
       case 508:
+        entity_out = new segment();
         collide = intersection(*dynamic_cast<plane const *>(entity0_in),
                                *dynamic_cast<disk const *>(entity1_in),
                                *dynamic_cast<segment *>(entity_out),
@@ -877,10 +884,10 @@ namespace acme
         break;
 
       case 709:
-        entity_out = new none();
+        entity_out = new point();
         collide = intersection(*dynamic_cast<triangle const *>(entity0_in),
                                *dynamic_cast<ball const *>(entity1_in),
-                               *dynamic_cast<none *>(entity_out),
+                               *dynamic_cast<point *>(entity_out),
                                tolerance);
         break;
 
@@ -935,10 +942,10 @@ namespace acme
         break;
 
       case 809:
-        entity_out = new none();
+        entity_out = new point();
         collide = intersection(*dynamic_cast<disk const *>(entity0_in),
                                *dynamic_cast<ball const *>(entity1_in),
-                               *dynamic_cast<none *>(entity_out),
+                               *dynamic_cast<point *>(entity_out),
                                tolerance);
         break;
 
@@ -977,18 +984,18 @@ namespace acme
         break;
 
       case 907:
-        entity_out = new none();
+        entity_out = new point();
         collide = intersection(*dynamic_cast<triangle const *>(entity1_in),
                                *dynamic_cast<ball const *>(entity0_in),
-                               *dynamic_cast<none *>(entity_out),
+                               *dynamic_cast<point *>(entity_out),
                                tolerance);
         break;
 
       case 908:
-        entity_out = new none();
+        entity_out = new point();
         collide = intersection(*dynamic_cast<disk const *>(entity1_in),
                                *dynamic_cast<ball const *>(entity0_in),
-                               *dynamic_cast<none *>(entity_out),
+                               *dynamic_cast<point *>(entity_out),
                                tolerance);
         break;
 
@@ -1013,6 +1020,7 @@ namespace acme
       entity_out = new none();
       return entity_out;
     }
+    ACME_PROBE_HITS(1);
     return entity_out;
   }
 
@@ -1452,6 +1460,26 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool
+  intersection(
+      point const &point_in,
+      triangleRecord const &record_in,
+      point &point_out,
+      real tolerance)
+  {
+    if (record_in.isInside(point_in, tolerance))
+    {
+      point_out = point_in;
+      return true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   bool
   intersection(
       point const &point_in,
@@ -2181,21 +2209,75 @@ namespace acme
       segment &segment_out,
       real tolerance)
   {
-    line tmp_line;
-    if (intersection(triangle0_in.layingPlane(),
-                     triangle1_in.layingPlane(),
-                     tmp_line,
-                     tolerance))
-    {
-      segment tmp_segment0, tmp_segment1;
-      intersection(tmp_line, triangle0_in, tmp_segment0, tolerance);
-      intersection(tmp_line, triangle1_in, tmp_segment1, tolerance);
-      return intersection(tmp_segment0, tmp_segment1, segment_out, tolerance);
-    }
-    else
-    {
+    // Interval overlap method (Moller, A fast triangle-triangle intersection test)
+    vec3 normal0((triangle0_in.vertex(1) - triangle0_in.vertex(0)).cross(triangle0_in.vertex(2) - triangle0_in.vertex(0)));
+    vec3 normal1((triangle1_in.vertex(1) - triangle1_in.vertex(0)).cross(triangle1_in.vertex(2) - triangle1_in.vertex(0)));
+    real norm0 = normal0.norm();
+    real norm1 = normal1.norm();
+    if (!(norm0 > 0.0 && norm1 > 0.0))
       return false;
-    }
+    normal0 /= norm0;
+    normal1 /= norm1;
+
+    // Early rejection by signed vertex distances from the other triangle plane
+    real distance0[3], distance1[3];
+    for (integer i = 0; i < 3; ++i)
+    {
+      distance0[i] = normal1.dot(triangle0_in.vertex(i) - triangle1_in.vertex(0));
+      distance1[i] = normal0.dot(triangle1_in.vertex(i) - triangle0_in.vertex(0));
+      if (std::abs(distance0[i]) <= tolerance)
+        distance0[i] = 0.0;
+      if (std::abs(distance1[i]) <= tolerance)
+        distance1[i] = 0.0;
+    }
+    if ((distance0[0] * distance0[1] > 0.0 && distance0[0] * distance0[2] > 0.0) ||
+        (distance1[0] * distance1[1] > 0.0 && distance1[0] * distance1[2] > 0.0))
+      return false;
+    // Triangles (nearly) lying on the other plane: no transversal intersection line
+    if ((distance0[0] == 0.0 && distance0[1] == 0.0 && distance0[2] == 0.0) ||
+        (distance1[0] == 0.0 && distance1[1] == 0.0 && distance1[2] == 0.0))
+      return false;
+
+    // Triangle section on the planes intersection line (isolated vertex edges)
+    vec3 direction(normal0.cross(normal1).normalized());
+    auto section = [&direction](triangle const &triangle_in, real const distance[3],
+                                point &point0, point &point1, real &t0, real &t1) {
+      integer k;
+      if (distance[0] * distance[1] > 0.0)
+        k = 2;
+      else if (distance[0] * distance[2] > 0.0)
+        k = 1;
+      else if (distance[1] * distance[2] > 0.0 || distance[0] != 0.0)
+        k = 0;
+      else if (distance[1] != 0.0)
+        k = 1;
+      else
+        k = 2;
+      point const &vertex_k = triangle_in.vertex(k);
+      point const &vertex_i = triangle_in.vertex((k + 1) % 3);
+      point const &vertex_j = triangle_in.vertex((k + 2) % 3);
+      real distance_k = distance[k];
+      point0 = vertex_k + (vertex_i - vertex_k) * (distance_k / (distance_k - distance[(k + 1) % 3]));
+      point1 = vertex_k + (vertex_j - vertex_k) * (distance_k / (distance_k - distance[(k + 2) % 3]));
+      t0 = direction.dot(point0);
+      t1 = direction.dot(point1);
+      if (t0 > t1)
+      {
+        std::swap(t0, t1);
+        std::swap(point0, point1);
+      }
+    };
+    point point00, point01, point10, point11;
+    real t00, t01, t10, t11;
+    section(triangle0_in, distance0, point00, point01, t00, t01);
+    section(triangle1_in, distance1, point10, point11, t10, t11);
+
+    // Intervals overlap
+    if (std::max(t00, t10) > std::min(t01, t11) + tolerance)
+      return false;
+    segment_out.vertex(0) = t00 > t10 ? point00 : point10;
+    segment_out.vertex(1) = t01 < t11 ? point01 : point11;
+    return true;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2257,36 +2339,56 @@ namespace acme
       point &point_out,
       real tolerance)
   {
-    point vertex0(triangle_in.vertex(0));
-    point vertex1(triangle_in.vertex(1));
-    point vertex2(triangle_in.vertex(2));
-    vec3 edge1(vertex1 - vertex0);
-    vec3 edge2(vertex2 - vertex0);
+    // Plucker side of the line with respect to each edge, as scalar triple
+    // products of vertices relative to the line origin (the edge terms are
+    // exactly antisymmetric, so triangles sharing an edge agree on its side)
     point origin(line_in.origin());
     vec3 direction(line_in.direction());
-
-    vec3 h, s, q;
-    real a, f, u, v;
-    h = direction.cross(edge2);
-    a = edge1.dot(h);
-    if (a > -tolerance && a < tolerance)
-      return false;
-    f = 1.0 / a;
-    s = origin - vertex0;
-    u = f * s.dot(h);
-    if (u < 0.0 || u > 1.0)
+    vec3 vertex0(triangle_in.vertex(0) - origin);
+    vec3 vertex1(triangle_in.vertex(1) - origin);
+    vec3 vertex2(triangle_in.vertex(2) - origin);
+    real side0 = direction.dot(vertex1.cross(vertex2));
+    real side1 = direction.dot(vertex2.cross(vertex0));
+    real side2 = direction.dot(vertex0.cross(vertex1));
+    real det = side0 + side1 + side2;
+    if (det > -tolerance && det < tolerance)
       return false;
-    q = s.cross(edge1);
-    v = f * direction.dot(q);
-    if (v < 0.0 || u + v > 1.0)
+    if ((side0 < 0.0 || side1 < 0.0 || side2 < 0.0) &&
+        (side0 > 0.0 || side1 > 0.0 || side2 > 0.0))
       return false;
-    real t = f * edge2.dot(q);
-    point_out = origin + t * direction;
+    point_out = origin + (side0 * vertex0 + side1 * vertex1 + side2 * vertex2) / det;
     return true;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool
+  intersection(
+      line const &line_in,
+      triangleRecord const &record_in,
+      point &point_out,
+      real tolerance)
+  {
+    point origin(line_in.origin());
+    vec3 direction(line_in.direction());
+    real det = record_in.normal().dot(direction);
+    if (!(std::abs(det) > tolerance))
+      return false;
+    real t = -record_in.signedDistance(origin) / det;
+    point point_tmp(origin + t * direction);
+    real u, v, w;
+    record_in.barycentric(point_tmp, u, v, w);
+    if (triangleRecord::isInside(u, v, w, tolerance))
+    {
+      point_out = point_tmp;
+      return true;
+    }
+    else
+      return false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   bool
   intersection(
       line const &line_in,
@@ -2406,6 +2508,35 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool
+  intersection(
+      ray const &ray_in,
+      triangleRecord const &record_in,
+      point &point_out,
+      real tolerance)
+  {
+    point origin(ray_in.origin());
+    vec3 direction(ray_in.direction());
+    real det = record_in.normal().dot(direction);
+    if (!(std::abs(det) > tolerance))
+      return false;
+    real t = -record_in.signedDistance(origin) / det;
+    if (t < 0.0)
+      return false;
+    point point_tmp(origin + t * direction);
+    real u, v, w;
+    record_in.barycentric(point_tmp, u, v, w);
+    if (triangleRecord::isInside(u, v, w, tolerance))
+    {
+      point_out = point_tmp;
+      return true;
+    }
+    else
+      return false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   bool
   intersection(
       ray const &ray_in,
@@ -2559,33 +2690,54 @@ namespace acme
       point &point_out,
       real tolerance)
   {
-    point vertex0(triangle_in.vertex(0));
-    point vertex1(triangle_in.vertex(1));
-    point vertex2(triangle_in.vertex(2));
-    vec3 edge1(vertex1 - vertex0);
-    vec3 edge2(vertex2 - vertex0);
+    // Same as the line kernel, plus the segment vertices on opposite sides of
+    // the triangle plane (signed volumes against the triangle normal)
     point origin(segment_in.vertex(0));
     vec3 direction(segment_in.toVector());
-
-    vec3 h, s, q;
-    real a, f, u, v;
-    h = direction.cross(edge2);
-    a = edge1.dot(h);
-    if (a > -tolerance && a < tolerance)
+    vec3 vertex0(triangle_in.vertex(0) - origin);
+    vec3 vertex1(triangle_in.vertex(1) - origin);
+    vec3 vertex2(triangle_in.vertex(2) - origin);
+    real side0 = direction.dot(vertex1.cross(vertex2));
+    real side1 = direction.dot(vertex2.cross(vertex0));
+    real side2 = direction.dot(vertex0.cross(vertex1));
+    real det = side0 + side1 + side2;
+    if (det > -tolerance && det < tolerance)
       return false;
-    f = 1.0 / a;
-    s = origin - vertex0;
-    u = f * s.dot(h);
-    if (u < 0.0 || u > 1.0)
+    if ((side0 < 0.0 || side1 < 0.0 || side2 < 0.0) &&
+        (side0 > 0.0 || side1 > 0.0 || side2 > 0.0))
       return false;
-    q = s.cross(edge1);
-    v = f * direction.dot(q);
-    if (v < 0.0 || u + v > 1.0)
+    vec3 normal((vertex1 - vertex0).cross(vertex2 - vertex0));
+    real volume0 = normal.dot(vertex0);
+    real volume1 = normal.dot(vertex0 - direction);
+    if (volume0 * volume1 > 0.0)
       return false;
-    real t = f * edge2.dot(q);
-    if (t >= 0.0 && t <= 1.0)
+    point_out = origin + (side0 * vertex0 + side1 * vertex1 + side2 * vertex2) / det;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  intersection(
+      segment const &segment_in,
+      triangleRecord const &record_in,
+      point &point_out,
+      real tolerance)
+  {
+    point origin(segment_in.vertex(0));
+    vec3 direction(segment_in.toVector());
+    real det = record_in.normal().dot(direction);
+    if (!(std::abs(det) > tolerance))
+      return false;
+    real t = -record_in.signedDistance(origin) / det;
+    if (t < 0.0 || t > 1.0)
+      return false;
+    point point_tmp(origin + t * direction);
+    real u, v, w;
+    record_in.barycentric(point_tmp, u, v, w);
+    if (triangleRecord::isInside(u, v, w, tolerance))
     {
-      point_out = origin + direction * t;
+      point_out = point_tmp;
       return true;
     }
     else
@@ -2672,11 +2824,17 @@ namespace acme
   intersection(
       triangle const &triangle_in,
       ball const &ball_in,
-      none &none_out,
+      point &point_out,
       real tolerance)
   {
-    ACME_ERROR("acme::intersection(triangle, ball): function not supported")
-    return false;
+    point point_tmp(triangle_in.closestPoint(ball_in.center()));
+    if ((point_tmp - ball_in.center()).norm() <= ball_in.radius() + tolerance)
+    {
+      point_out = point_tmp;
+      return true;
+    }
+    else
+      return false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2685,11 +2843,17 @@ namespace acme
   intersection(
       disk const &disk_in,
       ball const &ball_in,
-      none &none_out,
+      point &point_out,
       real tolerance)
   {
-    ACME_ERROR("acme::intersection(disk, ball): function not supported")
-    return false;
+    point point_tmp(disk_in.closestPoint(ball_in.center()));
+    if ((point_tmp - ball_in.center()).norm() <= ball_in.radius() + tolerance)
+    {
+      point_out = point_tmp;
+      return true;
+    }
+    else
+      return false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2731,6 +2895,347 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool
+  intersection(
+      disk const &disk_in,
+      aabb const &aabb_in,
+      real tolerance)
+  {
+    point const &center = disk_in.center();
+    vec3 normal(disk_in.normal().normalized());
+    real radius = disk_in.radius();
+    point const &box_min = aabb_in.min();
+    point const &box_max = aabb_in.max();
+
+    // Box must straddle the disk laying plane
+    vec3 box_center(0.5 * (box_min + box_max));
+    vec3 box_half(0.5 * (box_max - box_min));
+    if (std::abs(normal.dot(box_center - center)) > box_half.dot(normal.cwiseAbs()) + tolerance)
+      return false;
+
+    // Box must intersect the disk circumscribed ball
+    vec3 closest(center.cwiseMax(box_min).cwiseMin(box_max));
+    real distance = (closest - center).norm();
+    if (distance > radius + tolerance)
+      return false;
+    if (distance <= tolerance)
+      return true;
+
+    // Box section on the disk laying plane (convex polygon)
+    point corner[8];
+    real side[8];
+    for (integer i = 0; i < 8; ++i)
+    {
+      corner[i] = point(i & 1 ? box_max.x() : box_min.x(),
+                        i & 2 ? box_max.y() : box_min.y(),
+                        i & 4 ? box_max.z() : box_min.z());
+      side[i] = normal.dot(corner[i] - center);
+    }
+    static integer const edges[12][2] = {{0, 1}, {2, 3}, {4, 5}, {6, 7}, {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+    vec3 axis(std::abs(normal.x()) > 0.9 ? UNITY_VEC3 : UNITX_VEC3);
+    vec3 u((axis - normal * normal.dot(axis)).normalized());
+    vec3 v(normal.cross(u));
+    // Fixed storage: corners lying on the plane are listed once per edge
+    vec2 polygon[24];
+    integer size = 0;
+    for (integer i = 0; i < 12; ++i)
+    {
+      real side0 = side[edges[i][0]];
+      real side1 = side[edges[i][1]];
+      point const &corner0 = corner[edges[i][0]];
+      point const &corner1 = corner[edges[i][1]];
+      if (std::abs(side0) <= tolerance)
+        polygon[size++] = vec2(u.dot(corner0 - center), v.dot(corner0 - center));
+      if (std::abs(side1) <= tolerance)
+        polygon[size++] = vec2(u.dot(corner1 - center), v.dot(corner1 - center));
+      if ((side0 < -tolerance && side1 > tolerance) || (side0 > tolerance && side1 < -tolerance))
+      {
+        vec3 section(corner0 + (side0 / (side0 - side1)) * (corner1 - corner0) - center);
+        polygon[size++] = vec2(u.dot(section), v.dot(section));
+      }
+    }
+    if (size == 0)
+      return false;
+
+    // Sort polygon vertices counterclockwise around their centroid
+    vec2 centroid(ZEROS_VEC2);
+    for (integer i = 0; i < size; ++i)
+      centroid += polygon[i];
+    centroid /= real(size);
+    std::sort(polygon, polygon + size,
+              [&centroid](vec2 const &a, vec2 const &b) {
+                return std::atan2(a.y() - centroid.y(), a.x() - centroid.x()) <
+                       std::atan2(b.y() - centroid.y(), b.x() - centroid.x());
+              });
+
+    // Disk center inside the section or section edges within disk radius
+    bool inside = size > 2;
+    for (integer i = 0; i < size; ++i)
+    {
+      vec2 const &p0 = polygon[i];
+      vec2 const &p1 = polygon[(i + 1) % size];
+      vec2 edge(p1 - p0);
+      real length = edge.squaredNorm();
+      if (length > tolerance * tolerance && edge.x() * p0.y() - edge.y() * p0.x() >= 0.0)
+        inside = false;
+      real t = length > 0.0 ? std::max(0.0, std::min(1.0, -p0.dot(edge) / length)) : 0.0;
+      if ((p0 + t * edge).norm() <= radius + tolerance)
+        return true;
+    }
+    return inside;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  intersection(
+      triangle const &triangle0_in,
+      triangle const &triangle1_in,
+      real tolerance)
+  {
+    vec3 normal0((triangle0_in.vertex(1) - triangle0_in.vertex(0)).cross(triangle0_in.vertex(2) - triangle0_in.vertex(0)));
+    vec3 normal1((triangle1_in.vertex(1) - triangle1_in.vertex(0)).cross(triangle1_in.vertex(2) - triangle1_in.vertex(0)));
+    real norm0 = normal0.norm();
+    real norm1 = normal1.norm();
+    if (!(norm0 > 0.0 && norm1 > 0.0))
+      return false;
+    normal0 /= norm0;
+    normal1 /= norm1;
+
+    real distance0[3], distance1[3];
+    for (integer i = 0; i < 3; ++i)
+    {
+      distance0[i] = normal1.dot(triangle0_in.vertex(i) - triangle1_in.vertex(0));
+      distance1[i] = normal0.dot(triangle1_in.vertex(i) - triangle0_in.vertex(0));
+      if (std::abs(distance0[i]) <= tolerance)
+        distance0[i] = 0.0;
+      if (std::abs(distance1[i]) <= tolerance)
+        distance1[i] = 0.0;
+    }
+    if ((distance0[0] * distance0[1] > 0.0 && distance0[0] * distance0[2] > 0.0) ||
+        (distance1[0] * distance1[1] > 0.0 && distance1[0] * distance1[2] > 0.0))
+      return false;
+    // Triangles (nearly) lying on the other plane: no transversal intersection line
+    if ((distance0[0] == 0.0 && distance0[1] == 0.0 && distance0[2] == 0.0) ||
+        (distance1[0] == 0.0 && distance1[1] == 0.0 && distance1[2] == 0.0))
+      return false;
+
+    // Same as the segment variant but on projected scalars only
+    vec3 direction(normal0.cross(normal1).normalized());
+    auto section = [&direction](triangle const &triangle_in, real const distance[3],
+                                real &t0, real &t1) {
+      real projection[3];
+      for (integer i = 0; i < 3; ++i)
+        projection[i] = direction.dot(triangle_in.vertex(i));
+      integer k;
+      if (distance[0] * distance[1] > 0.0)
+        k = 2;
+      else if (distance[0] * distance[2] > 0.0)
+        k = 1;
+      else if (distance[1] * distance[2] > 0.0 || distance[0] != 0.0)
+        k = 0;
+      else if (distance[1] != 0.0)
+        k = 1;
+      else
+        k = 2;
+      integer i = (k + 1) % 3;
+      integer j = (k + 2) % 3;
+      t0 = projection[k] + (projection[i] - projection[k]) * (distance[k] / (distance[k] - distance[i]));
+      t1 = projection[k] + (projection[j] - projection[k]) * (distance[k] / (distance[k] - distance[j]));
+      if (t0 > t1)
+        std::swap(t0, t1);
+    };
+    real t00, t01, t10, t11;
+    section(triangle0_in, distance0, t00, t01);
+    section(triangle1_in, distance1, t10, t11);
+    return std::max(t00, t10) <= std::min(t01, t11) + tolerance;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  intersection(
+      ball const &ball_in,
+      vec3 const &displacement,
+      triangle const &triangle_in,
+      real &time,
+      point &point_out,
+      vec3 &normal,
+      real tolerance)
+  {
+    point const &center = ball_in.center();
+    real radius = ball_in.radius();
+
+    // Already in contact at the start of the motion
+    point closest(triangle_in.closestPoint(center));
+    vec3 direction(center - closest);
+    real distance = direction.norm();
+    vec3 face((triangle_in.vertex(1) - triangle_in.vertex(0)).cross(triangle_in.vertex(2) - triangle_in.vertex(0)));
+    real area = face.norm();
+    if (area > 0.0)
+      face /= area;
+    if (distance <= radius + tolerance)
+    {
+      time = 0.0;
+      point_out = closest;
+      if (distance > tolerance)
+        normal = direction / distance;
+      else
+        normal = face.dot(displacement) > 0.0 ? vec3(-face) : face;
+      return true;
+    }
+
+    bool hit = false;
+    real t_hit = 1.0;
+    // First root in [0, t_hit] of |m + t * displacement|^2 = radius^2
+    auto firstRoot = [radius, &t_hit](vec3 const &m, vec3 const &d, real &t) {
+      real a = d.dot(d);
+      real b = m.dot(d);
+      real c = m.dot(m) - radius * radius;
+      real discriminant = b * b - a * c;
+      if (!(a > 0.0) || b >= 0.0 || discriminant < 0.0)
+        return false;
+      t = (-b - std::sqrt(discriminant)) / a;
+      return t >= 0.0 && t <= t_hit;
+    };
+
+    // Face: the center reaches the triangle plane offset by the radius
+    if (area > 0.0)
+    {
+      real distance0 = face.dot(center - triangle_in.vertex(0));
+      if (distance0 < 0.0)
+      {
+        face = -face;
+        distance0 = -distance0;
+      }
+      real speed = face.dot(displacement);
+      if (speed < 0.0)
+      {
+        real t = (distance0 - radius) / -speed;
+        point contact(center + t * displacement - radius * face);
+        if (t >= 0.0 && t <= t_hit && triangle_in.isInside(contact, tolerance))
+        {
+          hit = true;
+          t_hit = t;
+          point_out = contact;
+          normal = face;
+        }
+      }
+    }
+
+    // Edges: the center reaches the cylinder of given radius around the edge
+    real t;
+    for (integer i = 0; i < 3; ++i)
+    {
+      point const &vertex = triangle_in.vertex(i);
+      vec3 edge(triangle_in.vertex((i + 1) % 3) - vertex);
+      real length = edge.dot(edge);
+      if (!(length > 0.0))
+        continue;
+      vec3 m(center - vertex);
+      vec3 m_ortho(m - edge * (edge.dot(m) / length));
+      vec3 d_ortho(displacement - edge * (edge.dot(displacement) / length));
+      if (!firstRoot(m_ortho, d_ortho, t))
+        continue;
+      real s = edge.dot(m + t * displacement) / length;
+      if (s < 0.0 || s > 1.0)
+        continue;
+      hit = true;
+      t_hit = t;
+      point_out = vertex + s * edge;
+      normal = (center + t * displacement - point_out).normalized();
+    }
+
+    // Vertices: the center reaches the ball of given radius around the vertex
+    for (integer i = 0; i < 3; ++i)
+    {
+      point const &vertex = triangle_in.vertex(i);
+      if (!firstRoot(center - vertex, displacement, t))
+        continue;
+      hit = true;
+      t_hit = t;
+      point_out = vertex;
+      normal = (center + t * displacement - point_out).normalized();
+    }
+
+    if (hit)
+      time = t_hit;
+    return hit;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  intersection(
+      disk const &disk_in,
+      vec3 const &displacement,
+      vec3 const &rotation,
+      triangle const &triangle_in,
+      real resolution,
+      real &time,
+      point &point_out,
+      vec3 &normal,
+      real tolerance)
+  {
+    ACME_ASSERT(resolution > 0.0,
+                "acme::intersection(disk, displacement, rotation, triangle): non-positive resolution.")
+
+    // The disk lies inside its bounding ball, so nothing happens before the ball impact
+    real t_lower;
+    point point_tmp;
+    vec3 normal_tmp;
+    if (!intersection(ball(disk_in.radius(), disk_in.center()), displacement, triangle_in,
+                      t_lower, point_tmp, normal_tmp, tolerance))
+      return false;
+
+    real angle = rotation.norm();
+    vec3 axis(angle > 0.0 ? vec3(rotation / angle) : vec3(vec3::UnitZ()));
+    vec3 normal0(disk_in.normal().normalized());
+    segment segment_tmp;
+    auto contact = [&](real t) {
+      disk disk_t(disk_in.radius(), disk_in.center() + t * displacement, angleaxis(t * angle, axis) * normal0);
+      return intersection(triangle_in, disk_t, segment_tmp, tolerance);
+    };
+
+    // Sample the motion so that disk points move at most the resolution per step
+    real sweep = displacement.norm() + angle * disk_in.radius();
+    integer steps = std::max(1, integer(std::ceil(sweep * (1.0 - t_lower) / resolution)));
+    real t_prev = t_lower;
+    real t_next = t_lower;
+    bool hit = contact(t_lower);
+    for (integer k = 1; !hit && k <= steps; ++k)
+    {
+      t_prev = t_next;
+      t_next = t_lower + (1.0 - t_lower) * real(k) / real(steps);
+      hit = contact(t_next);
+    }
+    if (!hit)
+      return false;
+
+    // Refine the first contact between the last free sample and the contact one
+    segment segment_hit(segment_tmp);
+    for (integer k = 0; k < 64 && (t_next - t_prev) * sweep > tolerance; ++k)
+    {
+      real t_mid = 0.5 * (t_prev + t_next);
+      if (contact(t_mid))
+      {
+        t_next = t_mid;
+        segment_hit = segment_tmp;
+      }
+      else
+        t_prev = t_mid;
+    }
+
+    time = t_next;
+    point_out = segment_hit.centroid();
+    normal = triangle_in.normal();
+    if (normal.dot(disk_in.center() + time * displacement - point_out) < 0.0)
+      normal = -normal;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
 } // namespace acme
 
 ///
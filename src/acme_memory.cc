@@ -0,0 +1,480 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_memory.cc
+///
+
+#include "acme_memory.hh"
+
+#include <atomic>
+#include <new>
+
+namespace acme
+{
+
+  /*\
+   |                                             ____                                    
+   |   _ __ ___   ___ _ __ ___   ___  _ __ _   _|  _ \ ___  ___  ___  _   _ _ __ ___ ___ 
+   |  | '_ ` _ \ / _ \ '_ ` _ \ / _ \| '__| | | | |_) / _ \/ __|/ _ \| | | | '__/ __/ _ \
+   |  | | | | | |  __/ | | | | | (_) | |  | |_| |  _ <  __/\__ \ (_) | |_| | | | (_|  __/
+   |  |_| |_| |_|\___|_| |_| |_|\___/|_|   \__, |_| \_\___||___/\___/ \__,_|_|  \___\___|
+   |                                       |___/                                         
+  \*/
+
+  //! Memory resource using global operator new and delete \n
+  //! Over-aligned blocks (beyond std::max_align_t) are carved out of a larger block,
+  //! whose address is stored just before the aligned one.
+  class newDeleteMemoryResource : public memoryResource
+  {
+  public:
+    //! Allocate memory block
+    void *
+    allocate(
+        size_t bytes,
+        size_t alignment)
+        override
+    {
+      if (alignment <= alignof(std::max_align_t))
+        return ::operator new(bytes);
+      ACME_ASSERT_DEBUG((alignment & (alignment - 1)) == 0,
+                        "acme::newDeleteMemoryResource::allocate(): alignment not a power of two.")
+      void *block = ::operator new(bytes + alignment + sizeof(void *));
+      size_t address = reinterpret_cast<size_t>(block) + sizeof(void *);
+      void *pointer = reinterpret_cast<void *>((address + alignment - 1) & ~(alignment - 1));
+      static_cast<void **>(pointer)[-1] = block;
+      return pointer;
+    }
+
+    //! Deallocate memory block
+    void
+    deallocate(
+        void *pointer,
+        size_t bytes,
+        size_t alignment)
+        override
+    {
+      (void)bytes;
+      if (alignment <= alignof(std::max_align_t))
+        ::operator delete(pointer);
+      else
+        ::operator delete(static_cast<void **>(pointer)[-1]);
+    }
+  };
+
+  static std::atomic<memoryResource *> default_resource(nullptr); //!< Default memory resource (nullptr for new and delete)
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  memoryResource *
+  newDeleteResource(void)
+      noexcept
+  {
+    static newDeleteMemoryResource resource;
+    return &resource;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  memoryResource *
+  defaultResource(void)
+      noexcept
+  {
+    memoryResource *resource = default_resource.load();
+    return resource != nullptr ? resource : newDeleteResource();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  memoryResource *
+  setDefaultResource(
+      memoryResource *resource_in)
+      noexcept
+  {
+    memoryResource *previous = default_resource.exchange(resource_in);
+    return previous != nullptr ? previous : newDeleteResource();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*\
+   |                               _              _      ____                                    
+   |   _ __ ___   ___  _ __   ___ | |_ ___  _ __ (_) ___|  _ \ ___  ___  ___  _   _ _ __ ___ ___ 
+   |  | '_ ` _ \ / _ \| '_ \ / _ \| __/ _ \| '_ \| |/ __| |_) / _ \/ __|/ _ \| | | | '__/ __/ _ \
+   |  | | | | | | (_) | | | | (_) | || (_) | | | | | (__|  _ <  __/\__ \ (_) | |_| | | | (_|  __/
+   |  |_| |_| |_|\___/|_| |_|\___/ \__\___/|_| |_|_|\___|_| \_\___||___/\___/ \__,_|_|  \___\___|
+   |                                                                                             
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  monotonicResource::~monotonicResource()
+  {
+    this->release();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  monotonicResource::monotonicResource(
+      size_t initial_size,
+      memoryResource *upstream)
+      : m_upstream(upstream != nullptr ? upstream : defaultResource()),
+        m_buffer(nullptr),
+        m_buffer_size(0),
+        m_chunks(nullptr),
+        m_current(nullptr),
+        m_left(0),
+        m_next_size(initial_size > 64 ? initial_size : 64),
+        m_used(0),
+        m_capacity(0)
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  monotonicResource::monotonicResource(
+      void *buffer,
+      size_t buffer_size,
+      memoryResource *upstream)
+      : m_upstream(upstream != nullptr ? upstream : defaultResource()),
+        m_buffer(static_cast<char *>(buffer)),
+        m_buffer_size(buffer_size),
+        m_chunks(nullptr),
+        m_current(static_cast<char *>(buffer)),
+        m_left(buffer_size),
+        m_next_size(buffer_size > 64 ? buffer_size : 64),
+        m_used(0),
+        m_capacity(buffer_size)
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void *
+  monotonicResource::allocate(
+      size_t bytes,
+      size_t alignment)
+  {
+    size_t padding = (alignment - reinterpret_cast<size_t>(this->m_current) % alignment) % alignment;
+    if (this->m_current == nullptr || padding + bytes > this->m_left)
+    {
+      // Get a new chunk, growing geometrically
+      size_t size = sizeof(chunk) + alignment + bytes;
+      if (size < this->m_next_size)
+        size = this->m_next_size;
+      chunk *new_chunk = static_cast<chunk *>(this->m_upstream->allocate(size, alignof(std::max_align_t)));
+      new_chunk->next = this->m_chunks;
+      new_chunk->size = size;
+      this->m_chunks = new_chunk;
+      this->m_current = reinterpret_cast<char *>(new_chunk) + sizeof(chunk);
+      this->m_left = size - sizeof(chunk);
+      this->m_next_size = 2 * size;
+      this->m_capacity += size;
+      padding = (alignment - reinterpret_cast<size_t>(this->m_current) % alignment) % alignment;
+    }
+    void *pointer = this->m_current + padding;
+    this->m_current += padding + bytes;
+    this->m_left -= padding + bytes;
+    this->m_used += padding + bytes;
+    return pointer;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  monotonicResource::deallocate(
+      void *pointer,
+      size_t bytes,
+      size_t alignment)
+  {
+    (void)pointer;
+    (void)bytes;
+    (void)alignment;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  monotonicResource::release(void)
+  {
+    while (this->m_chunks != nullptr)
+    {
+      chunk *next = this->m_chunks->next;
+      this->m_upstream->deallocate(this->m_chunks, this->m_chunks->size, alignof(std::max_align_t));
+      this->m_chunks = next;
+    }
+    this->m_current = this->m_buffer;
+    this->m_left = this->m_buffer_size;
+    this->m_used = 0;
+    this->m_capacity = this->m_buffer_size;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  monotonicResource::used(void)
+      const
+  {
+    return this->m_used;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  monotonicResource::capacity(void)
+      const
+  {
+    return this->m_capacity;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  memoryResource *
+  monotonicResource::upstream(void)
+      const
+  {
+    return this->m_upstream;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*\
+   |                     _ ____                                    
+   |   _ __   ___   ___ | |  _ \ ___  ___  ___  _   _ _ __ ___ ___ 
+   |  | '_ \ / _ \ / _ \| | |_) / _ \/ __|/ _ \| | | | '__/ __/ _ \
+   |  | |_) | (_) | (_) | |  _ <  __/\__ \ (_) | |_| | | | (_|  __/
+   |  | .__/ \___/ \___/|_|_| \_\___||___/\___/ \__,_|_|  \___\___|
+   |  |_|                                                          
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  poolResource::~poolResource()
+  {
+    this->release();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  poolResource::poolResource(
+      memoryResource *upstream)
+      : m_upstream(upstream != nullptr ? upstream : defaultResource()),
+        m_chunks(nullptr),
+        m_used(0),
+        m_capacity(0)
+  {
+    for (integer i = 0; i < CLASSES; ++i)
+      this->m_free[i] = nullptr;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  poolResource::sizeClass(
+      size_t bytes,
+      size_t alignment)
+  {
+    size_t size = bytes > alignment ? bytes : alignment;
+    integer i = 0;
+    for (size_t block_size = MIN_BLOCK; block_size < size; block_size *= 2)
+      ++i;
+    return i < CLASSES ? i : -1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void *
+  poolResource::allocate(
+      size_t bytes,
+      size_t alignment)
+  {
+    integer i = sizeClass(bytes, alignment);
+    if (i < 0)
+      return this->m_upstream->allocate(bytes, alignment);
+    size_t block_size = MIN_BLOCK << i;
+    if (this->m_free[i] == nullptr)
+    {
+      // Carve a new chunk into blocks of this size class (blocks are aligned to their size)
+      size_t size = sizeof(chunk) + MAX_BLOCK + CHUNK_SIZE;
+      chunk *new_chunk = static_cast<chunk *>(this->m_upstream->allocate(size, alignof(std::max_align_t)));
+      new_chunk->next = this->m_chunks;
+      new_chunk->size = size;
+      this->m_chunks = new_chunk;
+      this->m_capacity += size;
+      char *begin = reinterpret_cast<char *>(new_chunk) + sizeof(chunk);
+      begin += (block_size - reinterpret_cast<size_t>(begin) % block_size) % block_size;
+      char *end = reinterpret_cast<char *>(new_chunk) + size;
+      for (; begin + block_size <= end; begin += block_size)
+      {
+        block *free_block = reinterpret_cast<block *>(begin);
+        free_block->next = this->m_free[i];
+        this->m_free[i] = free_block;
+      }
+    }
+    block *free_block = this->m_free[i];
+    this->m_free[i] = free_block->next;
+    this->m_used += block_size;
+    return free_block;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  poolResource::deallocate(
+      void *pointer,
+      size_t bytes,
+      size_t alignment)
+  {
+    integer i = sizeClass(bytes, alignment);
+    if (i < 0)
+    {
+      this->m_upstream->deallocate(pointer, bytes, alignment);
+      return;
+    }
+    block *free_block = static_cast<block *>(pointer);
+    free_block->next = this->m_free[i];
+    this->m_free[i] = free_block;
+    this->m_used -= MIN_BLOCK << i;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  poolResource::release(void)
+  {
+    while (this->m_chunks != nullptr)
+    {
+      chunk *next = this->m_chunks->next;
+      this->m_upstream->deallocate(this->m_chunks, this->m_chunks->size, alignof(std::max_align_t));
+      this->m_chunks = next;
+    }
+    for (integer i = 0; i < CLASSES; ++i)
+      this->m_free[i] = nullptr;
+    this->m_used = 0;
+    this->m_capacity = 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  poolResource::used(void)
+      const
+  {
+    return this->m_used;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  poolResource::capacity(void)
+      const
+  {
+    return this->m_capacity;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*\
+   |    __             _              _       _   
+   |   / _| ___   ___ | |_ _ __  _ __(_)_ __ | |_ 
+   |  | |_ / _ \ / _ \| __| '_ \| '__| | '_ \| __|
+   |  |  _| (_) | (_) | |_| |_) | |  | | | | | |_ 
+   |  |_|  \___/ \___/ \__| .__/|_|  |_|_| |_|\__|
+   |                      |_|                     
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  footprint::add(
+      std::string const &component,
+      size_t bytes)
+  {
+    this->m_components[component] += bytes;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  footprint::add(
+      footprint const &footprint_in)
+  {
+    std::map<std::string, size_t>::const_iterator it;
+    for (it = footprint_in.m_components.begin(); it != footprint_in.m_components.end(); ++it)
+      this->m_components[it->first] += it->second;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  footprint::bytes(
+      std::string const &prefix)
+      const
+  {
+    size_t sum = 0;
+    std::map<std::string, size_t>::const_iterator it;
+    for (it = this->m_components.lower_bound(prefix);
+         it != this->m_components.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+      sum += it->second;
+    return sum;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  footprint::total(void)
+      const
+  {
+    return this->bytes("");
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  std::map<std::string, size_t> const &
+  footprint::components(void)
+      const
+  {
+    return this->m_components;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  footprint::controlBlock(void)
+  {
+    // Virtual table pointer plus use and weak counters
+    return sizeof(void *) + 2 * sizeof(int);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme_memory.cc
+///
@@ -0,0 +1,693 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_recorder.cc
+///
+
+#include "acme_recorder.hh"
+
+#include <cstring>
+
+namespace acme
+{
+
+  /*\
+   |                              _           
+   |   _ __ ___  ___ ___  _ __ __| | ___ _ __ 
+   |  | '__/ _ \/ __/ _ \| '__/ _` |/ _ \ '__|
+   |  | | |  __/ (_| (_) | | | (_| |  __/ |   
+   |  |_|  \___|\___\___/|_|  \__,_|\___|_|   
+   |                                          
+  \*/
+
+  static char const TRACE_MAGIC[8] = {'A', 'C', 'M', 'E', 'T', 'R', 'C', '\0'}; //!< Trace file magic
+  static uint32_t const TRACE_VERSION = 1;                                      //!< Trace file version
+
+  //! Trace snapshot flags
+  enum traceFlags
+  {
+    TRACE_TREE = 1,    //!< Collection AABB tree built
+    TRACE_RECORDS = 2, //!< Collection triangle records built
+    TRACE_BLOCKS = 4   //!< Collection triangle blocks built
+  };
+
+  //! Trace snapshot entity types
+  enum traceEntity
+  {
+    TRACE_NONE = 0,     //!< None (non-clampable entity)
+    TRACE_POINT = 1,    //!< Point
+    TRACE_SEGMENT = 2,  //!< Segment
+    TRACE_TRIANGLE = 3, //!< Triangle
+    TRACE_DISK = 4,     //!< Disk
+    TRACE_BALL = 5      //!< Ball
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  template <typename T>
+  static bool
+  put(
+      std::FILE *file,
+      T const &value)
+  {
+    return std::fwrite(&value, sizeof(T), 1, file) == 1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  template <typename T>
+  static bool
+  get(
+      std::FILE *file,
+      T &value)
+  {
+    return std::fread(&value, sizeof(T), 1, file) == 1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static bool
+  putVector(
+      std::FILE *file,
+      vec3 const &vector)
+  {
+    return put(file, vector.x()) && put(file, vector.y()) && put(file, vector.z());
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static bool
+  getVector(
+      std::FILE *file,
+      vec3 &vector)
+  {
+    return get(file, vector.x()) && get(file, vector.y()) && get(file, vector.z());
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  recorder::guard::start(
+      recorder *recorder_in,
+      query kind,
+      real tolerance)
+  {
+    this->m_recorder = recorder_in != nullptr && recorder_in->isOpen() ? recorder_in : nullptr;
+    if (this->m_recorder == nullptr)
+      return;
+    std::memset(&this->m_entry, 0, sizeof(entry));
+    this->m_entry.kind = kind;
+    this->m_entry.tolerance = tolerance;
+    this->m_entry.hit = false;
+    this->m_entry.id = -1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::guard::~guard()
+  {
+    if (this->m_recorder == nullptr)
+      return;
+    this->m_entry.duration = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       std::chrono::steady_clock::now() - this->m_start)
+                                                       .count());
+    this->m_recorder->write(this->m_entry);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::guard::guard(
+      recorder *recorder_in,
+      ray const &ray_in,
+      real tolerance)
+  {
+    this->start(recorder_in, QUERY_RAY, tolerance);
+    if (this->m_recorder == nullptr)
+      return;
+    Eigen::Map<vec3>(this->m_entry.parameters) = ray_in.origin();
+    Eigen::Map<vec3>(this->m_entry.parameters + 3) = ray_in.direction();
+    this->m_start = std::chrono::steady_clock::now();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::guard::guard(
+      recorder *recorder_in,
+      segment const &segment_in,
+      real tolerance)
+  {
+    this->start(recorder_in, QUERY_SEGMENT, tolerance);
+    if (this->m_recorder == nullptr)
+      return;
+    Eigen::Map<vec3>(this->m_entry.parameters) = segment_in.vertex(0);
+    Eigen::Map<vec3>(this->m_entry.parameters + 3) = segment_in.vertex(1);
+    this->m_start = std::chrono::steady_clock::now();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::guard::guard(
+      recorder *recorder_in,
+      disk const &disk_in,
+      real tolerance)
+  {
+    this->start(recorder_in, QUERY_DISK, tolerance);
+    if (this->m_recorder == nullptr)
+      return;
+    this->m_entry.parameters[0] = disk_in.radius();
+    Eigen::Map<vec3>(this->m_entry.parameters + 1) = disk_in.center();
+    Eigen::Map<vec3>(this->m_entry.parameters + 4) = disk_in.normal();
+    this->m_start = std::chrono::steady_clock::now();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::guard::guard(
+      recorder *recorder_in,
+      ball const &ball_in,
+      real tolerance)
+  {
+    this->start(recorder_in, QUERY_BALL, tolerance);
+    if (this->m_recorder == nullptr)
+      return;
+    this->m_entry.parameters[0] = ball_in.radius();
+    Eigen::Map<vec3>(this->m_entry.parameters + 1) = ball_in.center();
+    this->m_start = std::chrono::steady_clock::now();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::guard::guard(
+      recorder *recorder_in,
+      ball const &ball_in,
+      vec3 const &displacement,
+      real tolerance)
+  {
+    this->start(recorder_in, QUERY_BALL_SWEPT, tolerance);
+    if (this->m_recorder == nullptr)
+      return;
+    this->m_entry.parameters[0] = ball_in.radius();
+    Eigen::Map<vec3>(this->m_entry.parameters + 1) = ball_in.center();
+    Eigen::Map<vec3>(this->m_entry.parameters + 4) = displacement;
+    this->m_start = std::chrono::steady_clock::now();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::guard::guard(
+      recorder *recorder_in,
+      disk const &disk_in,
+      vec3 const &displacement,
+      vec3 const &rotation,
+      real resolution,
+      real tolerance)
+  {
+    this->start(recorder_in, QUERY_DISK_SWEPT, tolerance);
+    if (this->m_recorder == nullptr)
+      return;
+    this->m_entry.parameters[0] = disk_in.radius();
+    Eigen::Map<vec3>(this->m_entry.parameters + 1) = disk_in.center();
+    Eigen::Map<vec3>(this->m_entry.parameters + 4) = disk_in.normal();
+    Eigen::Map<vec3>(this->m_entry.parameters + 7) = displacement;
+    Eigen::Map<vec3>(this->m_entry.parameters + 10) = rotation;
+    this->m_entry.parameters[13] = resolution;
+    this->m_start = std::chrono::steady_clock::now();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  recorder::guard::result(
+      integer id,
+      integer count,
+      real value0,
+      vec3 const &values123)
+  {
+    if (this->m_recorder == nullptr)
+      return;
+    this->m_entry.hit = true;
+    this->m_entry.id = id;
+    this->m_entry.count = count;
+    this->m_entry.values[0] = value0;
+    Eigen::Map<vec3>(this->m_entry.values + 1) = values123;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::~recorder()
+  {
+    this->close();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  recorder::recorder()
+      : m_file(nullptr),
+        m_size(0)
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  recorder::open(
+      std::string const &file,
+      collection const &snapshot)
+  {
+    this->close();
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    std::FILE *out = std::fopen(file.c_str(), "wb");
+    if (out == nullptr)
+      return false;
+    uint32_t flags = 0;
+    if (!snapshot.ptrAABBtree()->isEmpty())
+      flags |= TRACE_TREE;
+    if (snapshot.hasRecords())
+      flags |= TRACE_RECORDS;
+    if (snapshot.hasBlocks())
+      flags |= TRACE_BLOCKS;
+    bool good = std::fwrite(TRACE_MAGIC, sizeof(TRACE_MAGIC), 1, out) == 1 &&
+                put(out, TRACE_VERSION) && put(out, flags) && put(out, int64_t(snapshot.size()));
+    for (integer i = 0; good && i < snapshot.size(); ++i)
+    {
+      entity const *entity_i = snapshot[i].get();
+      if (entity_i->isPoint())
+      {
+        point const &p = *dynamic_cast<point const *>(entity_i);
+        good = put(out, uint8_t(TRACE_POINT)) && putVector(out, p);
+      }
+      else if (entity_i->isSegment())
+      {
+        segment const &s = *dynamic_cast<segment const *>(entity_i);
+        good = put(out, uint8_t(TRACE_SEGMENT)) && putVector(out, s.vertex(0)) && putVector(out, s.vertex(1));
+      }
+      else if (entity_i->isTriangle())
+      {
+        triangle const &t = *dynamic_cast<triangle const *>(entity_i);
+        good = put(out, uint8_t(TRACE_TRIANGLE)) &&
+               putVector(out, t.vertex(0)) && putVector(out, t.vertex(1)) && putVector(out, t.vertex(2));
+      }
+      else if (entity_i->isDisk())
+      {
+        disk const &d = *dynamic_cast<disk const *>(entity_i);
+        good = put(out, uint8_t(TRACE_DISK)) && put(out, d.radius()) &&
+               putVector(out, d.center()) && putVector(out, d.normal());
+      }
+      else if (entity_i->isBall())
+      {
+        ball const &b = *dynamic_cast<ball const *>(entity_i);
+        good = put(out, uint8_t(TRACE_BALL)) && put(out, b.radius()) && putVector(out, b.center());
+      }
+      else
+        good = put(out, uint8_t(TRACE_NONE));
+    }
+    if (!good)
+    {
+      std::fclose(out);
+      return false;
+    }
+    this->m_file = out;
+    this->m_size = 0;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  recorder::close(void)
+  {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    if (this->m_file == nullptr)
+      return true;
+    bool good = std::fclose(this->m_file) == 0;
+    this->m_file = nullptr;
+    return good;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  recorder::isOpen(void)
+      const
+  {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    return this->m_file != nullptr;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  recorder::size(void)
+      const
+  {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    return this->m_size;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  recorder::write(
+      entry const &entry_in)
+  {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    if (this->m_file == nullptr)
+      return;
+    std::FILE *out = this->m_file;
+    put(out, uint8_t(entry_in.kind));
+    put(out, uint8_t(entry_in.hit));
+    put(out, int32_t(entry_in.id));
+    put(out, int32_t(entry_in.count));
+    put(out, entry_in.tolerance);
+    put(out, entry_in.duration);
+    std::fwrite(entry_in.parameters, sizeof(real), parameters(entry_in.kind), out);
+    std::fwrite(entry_in.values, sizeof(real), VALUES, out);
+    ++this->m_size;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  recorder::parameters(
+      query kind)
+  {
+    switch (kind)
+    {
+    case QUERY_RAY:
+    case QUERY_SEGMENT:
+      return 6;
+    case QUERY_DISK:
+      return 7;
+    case QUERY_BALL:
+      return 4;
+    case QUERY_BALL_SWEPT:
+      return 7;
+    case QUERY_DISK_SWEPT:
+      return 14;
+    default:
+      return 0;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  char const *
+  recorder::name(
+      query kind)
+  {
+    switch (kind)
+    {
+    case QUERY_RAY:
+      return "ray";
+    case QUERY_SEGMENT:
+      return "segment";
+    case QUERY_DISK:
+      return "disk";
+    case QUERY_BALL:
+      return "ball";
+    case QUERY_BALL_SWEPT:
+      return "ball-swept";
+    case QUERY_DISK_SWEPT:
+      return "disk-swept";
+    default:
+      return "none";
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  recorder::load(
+      std::string const &file,
+      collection &snapshot,
+      std::vector<entry> &entries)
+  {
+    snapshot.clear();
+    entries.clear();
+    std::FILE *in = std::fopen(file.c_str(), "rb");
+    if (in == nullptr)
+      return false;
+    char magic[sizeof(TRACE_MAGIC)];
+    uint32_t version, flags;
+    int64_t size;
+    bool good = std::fread(magic, sizeof(magic), 1, in) == 1 &&
+                std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0 &&
+                get(in, version) && version == TRACE_VERSION && get(in, flags) && get(in, size);
+
+    // Collection snapshot
+    for (int64_t i = 0; good && i < size; ++i)
+    {
+      uint8_t type;
+      real radius;
+      point p0, p1, p2;
+      vec3 normal;
+      good = get(in, type);
+      if (!good)
+        break;
+      switch (type)
+      {
+      case TRACE_POINT:
+        good = getVector(in, p0);
+        snapshot.emplace_back<point>(p0);
+        break;
+      case TRACE_SEGMENT:
+        good = getVector(in, p0) && getVector(in, p1);
+        snapshot.emplace_back<segment>(p0, p1);
+        break;
+      case TRACE_TRIANGLE:
+        good = getVector(in, p0) && getVector(in, p1) && getVector(in, p2);
+        snapshot.emplace_back<triangle>(p0, p1, p2);
+        break;
+      case TRACE_DISK:
+        good = get(in, radius) && getVector(in, p0) && getVector(in, normal);
+        snapshot.emplace_back<disk>(radius, p0, normal);
+        break;
+      case TRACE_BALL:
+        good = get(in, radius) && getVector(in, p0);
+        snapshot.emplace_back<ball>(radius, p0);
+        break;
+      case TRACE_NONE:
+        snapshot.emplace_back<none>();
+        break;
+      default:
+        good = false;
+        break;
+      }
+    }
+    if (good && (flags & (TRACE_TREE | TRACE_BLOCKS)) != 0)
+      snapshot.buildAABBtree((flags & TRACE_RECORDS) != 0);
+    if (good && (flags & TRACE_BLOCKS) != 0)
+      snapshot.buildBlocks();
+
+    // Recorded queries (until the end of the file)
+    uint8_t kind;
+    while (good && get(in, kind))
+    {
+      entry entry_in;
+      std::memset(&entry_in, 0, sizeof(entry));
+      uint8_t hit;
+      int32_t id, count;
+      good = kind < QUERIES && get(in, hit) && get(in, id) && get(in, count) &&
+             get(in, entry_in.tolerance) && get(in, entry_in.duration);
+      if (!good)
+        break;
+      entry_in.kind = static_cast<query>(kind);
+      entry_in.hit = hit != 0;
+      entry_in.id = id;
+      entry_in.count = count;
+      integer n = parameters(entry_in.kind);
+      good = std::fread(entry_in.parameters, sizeof(real), n, in) == size_t(n) &&
+             std::fread(entry_in.values, sizeof(real), VALUES, in) == size_t(VALUES);
+      if (good)
+        entries.push_back(entry_in);
+    }
+    std::fclose(in);
+    return good;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  recorder::execute(
+      collection const &collection_in,
+      entry const &query_in,
+      entry &result_out,
+      context &scratch)
+  {
+    result_out = query_in;
+    result_out.hit = false;
+    result_out.id = -1;
+    result_out.count = 0;
+    std::fill(result_out.values, result_out.values + VALUES, 0.0);
+    Eigen::Map<vec3> values(result_out.values + 1);
+    real const *p = query_in.parameters;
+    real tolerance = query_in.tolerance;
+
+    integer id;
+    point point_out;
+    vec3 normal;
+    real value;
+    std::vector<segment> segments;
+    std::vector<integer> ids;
+    std::vector<vec3> normals;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    switch (query_in.kind)
+    {
+    case QUERY_RAY:
+    {
+      ray ray_in(p[0], p[1], p[2], p[3], p[4], p[5]);
+      start = std::chrono::steady_clock::now();
+      result_out.hit = collection_in.intersection(ray_in, id, point_out, scratch, tolerance);
+      if (result_out.hit)
+      {
+        result_out.id = id;
+        result_out.count = 1;
+        result_out.values[0] = (point_out - ray_in.origin()).dot(ray_in.direction()) / ray_in.direction().squaredNorm();
+        values = point_out;
+      }
+      break;
+    }
+    case QUERY_SEGMENT:
+    {
+      segment segment_in(point(p[0], p[1], p[2]), point(p[3], p[4], p[5]));
+      start = std::chrono::steady_clock::now();
+      result_out.hit = collection_in.intersection(segment_in, id, point_out, scratch, tolerance);
+      if (result_out.hit)
+      {
+        vec3 direction(segment_in.toVector());
+        result_out.id = id;
+        result_out.count = 1;
+        result_out.values[0] = (point_out - segment_in.vertex(0)).dot(direction) / direction.squaredNorm();
+        values = point_out;
+      }
+      break;
+    }
+    case QUERY_DISK:
+    {
+      disk disk_in(p[0], point(p[1], p[2], p[3]), vec3(p[4], p[5], p[6]));
+      start = std::chrono::steady_clock::now();
+      result_out.hit = collection_in.intersection(disk_in, segments, ids, normals, scratch, tolerance);
+      if (result_out.hit)
+      {
+        result_out.id = ids.front();
+        result_out.count = segments.size();
+        for (size_t i = 0; i < segments.size(); ++i)
+          result_out.values[0] += segments[i].length();
+        values = segments.front().vertex(0);
+      }
+      break;
+    }
+    case QUERY_BALL:
+    {
+      ball ball_in(p[0], point(p[1], p[2], p[3]));
+      start = std::chrono::steady_clock::now();
+      result_out.hit = collection_in.intersection(ball_in, value, normal, ids, point_out, scratch, tolerance);
+      if (result_out.hit)
+      {
+        result_out.id = ids.front();
+        result_out.count = ids.size();
+        result_out.values[0] = value;
+        values = normal;
+      }
+      break;
+    }
+    case QUERY_BALL_SWEPT:
+    {
+      ball ball_in(p[0], point(p[1], p[2], p[3]));
+      vec3 displacement(p[4], p[5], p[6]);
+      start = std::chrono::steady_clock::now();
+      result_out.hit = collection_in.intersection(ball_in, displacement, value, id, normal, point_out, scratch, tolerance);
+      if (result_out.hit)
+      {
+        result_out.id = id;
+        result_out.count = 1;
+        result_out.values[0] = value;
+        values = normal;
+      }
+      break;
+    }
+    case QUERY_DISK_SWEPT:
+    {
+      disk disk_in(p[0], point(p[1], p[2], p[3]), vec3(p[4], p[5], p[6]));
+      vec3 displacement(p[7], p[8], p[9]);
+      vec3 rotation(p[10], p[11], p[12]);
+      start = std::chrono::steady_clock::now();
+      result_out.hit = collection_in.intersection(disk_in, displacement, rotation, p[13],
+                                                  value, id, normal, point_out, scratch, tolerance);
+      if (result_out.hit)
+      {
+        result_out.id = id;
+        result_out.count = 1;
+        result_out.values[0] = value;
+        values = normal;
+      }
+      break;
+    }
+    default:
+      ACME_ERROR("acme::recorder::execute(): invalid query kind.")
+      break;
+    }
+    result_out.duration = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                     std::chrono::steady_clock::now() - start)
+                                                     .count());
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  recorder::compare(
+      entry const &entry0,
+      entry const &entry1,
+      real tolerance)
+  {
+    if (entry0.kind != entry1.kind || entry0.hit != entry1.hit ||
+        entry0.id != entry1.id || entry0.count != entry1.count)
+      return false;
+    for (integer i = 0; i < VALUES; ++i)
+    {
+      real a = entry0.values[i];
+      real b = entry1.values[i];
+      if (std::isnan(a) || std::isnan(b))
+      {
+        if (std::isnan(a) != std::isnan(b))
+          return false;
+      }
+      else if (std::abs(a - b) > tolerance * std::max(1.0, std::max(std::abs(a), std::abs(b))))
+        return false;
+    }
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme_recorder.cc
+///
@@ -0,0 +1,394 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+///
+/// file: acme_scene.cc
+///
+
+#include "acme_scene.hh"
+
+namespace acme
+{
+
+  /*\
+   |                           
+   |   ___  ___ ___ _ __   ___ 
+   |  / __|/ __/ _ \ '_ \ / _ \
+   |  \__ \ (_|  __/ | | |  __/
+   |  |___/\___\___|_| |_|\___|
+   |                           
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  scene::scene()
+      : m_AABBtree(std::make_shared<AABBtree>()),
+        m_updated(true)
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  scene::clear(void)
+  {
+    this->m_geometries.clear();
+    this->m_transforms.clear();
+    this->m_inverses.clear();
+    this->m_boxes.clear();
+    this->m_AABBtree->clear();
+    this->m_changed.clear();
+    this->m_updated = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  scene::size(void)
+      const
+  {
+    return this->m_geometries.size();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  scene::push_back(
+      geometry const &geometry_in,
+      affine const &transform_in)
+  {
+    ACME_ASSERT(geometry_in && !geometry_in->ptrAABBtree()->isEmpty(),
+                "acme::scene::push_back(): instance geometry AABB tree not built.")
+    integer i = this->m_geometries.size();
+    this->m_geometries.push_back(geometry_in);
+    this->m_transforms.push_back(transform_in);
+    this->m_inverses.push_back(transform_in.inverse());
+    this->m_boxes.push_back(aabb::ptr());
+    this->updateBox(i);
+    this->m_updated = false;
+    return i;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  scene::geometry const &
+  scene::instanceGeometry(
+      integer i)
+      const
+  {
+    return this->m_geometries[i];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  affine const &
+  scene::instanceTransform(
+      integer i)
+      const
+  {
+    return this->m_transforms[i];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  scene::instanceTransform(
+      integer i,
+      affine const &transform_in)
+  {
+    this->m_transforms[i] = transform_in;
+    this->m_inverses[i] = transform_in.inverse();
+    this->updateBox(i);
+    this->m_updated = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  aabb const &
+  scene::instanceBox(
+      integer i)
+      const
+  {
+    return *this->m_boxes[i];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  scene::updateBox(
+      integer i)
+  {
+    aabb const &box = this->m_geometries[i]->ptrAABBtree()->box();
+    affine const &transform = this->m_transforms[i];
+    vec3 min(vec3::Constant(INFTY));
+    vec3 max(vec3::Constant(-INFTY));
+    for (integer k = 0; k < 8; ++k)
+    {
+      vec3 corner(k & 1 ? box.max(0) : box.min(0),
+                  k & 2 ? box.max(1) : box.min(1),
+                  k & 4 ? box.max(2) : box.min(2));
+      corner = transform * corner;
+      min = min.cwiseMin(corner);
+      max = max.cwiseMax(corner);
+    }
+    if (this->m_boxes[i])
+    {
+      // Instances boxes are allocated by the scene itself and shared with the
+      // top-level tree leaves, so they are updated in place for the refit
+      aabb &box_i = *std::const_pointer_cast<aabb>(this->m_boxes[i]);
+      box_i.min() = min;
+      box_i.max() = max;
+      if (size_t(i) < this->m_changed.size())
+        this->m_changed[i] = true;
+    }
+    else
+      this->m_boxes[i] = std::make_shared<aabb>(min, max, i, 0);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  scene::buildAABBtree(void)
+  {
+    // Moved instances only: same leaves, refit their ancestors
+    if (!this->m_AABBtree->isEmpty() && this->m_changed.size() == this->m_boxes.size())
+      this->m_AABBtree->refit(this->m_changed);
+    else
+      this->m_AABBtree->build(this->m_boxes);
+    this->m_changed.assign(this->m_boxes.size(), false);
+    this->m_updated = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  scene::isUpdated(void)
+      const
+  {
+    return this->m_updated;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  footprint
+  scene::memoryUsage(void)
+      const
+  {
+    footprint usage;
+    size_t control = footprint::controlBlock();
+    size_t instances = this->m_geometries.size();
+    usage.add("scene/object", sizeof(scene));
+    usage.add("scene/geometries", instances * sizeof(geometry));
+    usage.add("scene/transforms", 2 * instances * sizeof(affine));
+    usage.add("scene/boxes", instances * sizeof(aabb::ptr));
+    usage.add("overhead/vector slack",
+              (this->m_geometries.capacity() - instances) * sizeof(geometry) +
+                  (this->m_transforms.capacity() + this->m_inverses.capacity() - 2 * instances) * sizeof(affine) +
+                  (this->m_boxes.capacity() - instances) * sizeof(aabb::ptr));
+
+    // Instance world boxes are the top-level tree leaves once it is up to date
+    if (!this->m_updated)
+    {
+      usage.add("scene/boxes", instances * sizeof(aabb));
+      usage.add("overhead/control blocks", instances * control);
+    }
+    usage.add(this->m_AABBtree->memoryUsage("scene tree"));
+
+    // Distinct geometries
+    std::vector<collection const *> geometries;
+    for (size_t i = 0; i < instances; ++i)
+      geometries.push_back(this->m_geometries[i].get());
+    std::sort(geometries.begin(), geometries.end());
+    geometries.erase(std::unique(geometries.begin(), geometries.end()), geometries.end());
+    for (size_t i = 0; i < geometries.size(); ++i)
+    {
+      usage.add(geometries[i]->memoryUsage());
+      usage.add("overhead/control blocks", control);
+    }
+    return usage;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  scene::nearestHit(
+      ray const &ray_in,
+      real t_max,
+      integer &instance,
+      integer &id,
+      real &t,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    ACME_ASSERT(this->m_updated, "acme::scene::nearestHit(): top-level AABB tree not updated.")
+
+    // Sort instances by ray entry parameter to stop at the first hit
+    context::vecentry &entries = scratch.instances();
+    entries.clear();
+    this->m_AABBtree->intersection(ray_in, entries, t_max);
+    std::sort(entries.begin(), entries.end());
+
+    t = t_max;
+    instance = -1;
+    integer id_hit;
+    point point_hit;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+      if (entries[i].first > t)
+        break;
+      integer k = entries[i].second;
+      point origin(this->m_inverses[k] * ray_in.origin());
+      vec3 direction(this->m_inverses[k].linear() * ray_in.direction());
+      bool hit = t_max < INFTY
+                     ? this->m_geometries[k]->intersection(segment(origin, origin + t_max * direction), id_hit, point_hit, scratch, tolerance)
+                     : this->m_geometries[k]->intersection(ray(origin, direction), id_hit, point_hit, scratch, tolerance);
+      if (hit)
+      {
+        real t_hit = (point_hit - origin).dot(direction) / direction.squaredNorm();
+        if (t_hit <= t)
+        {
+          t = t_hit;
+          instance = k;
+          id = id_hit;
+        }
+      }
+    }
+    return instance >= 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  scene::intersection(
+      ray const &ray_in,
+      integer &instance,
+      integer &id,
+      point &point_out,
+      real tolerance)
+      const
+  {
+    context scratch;
+    return this->intersection(ray_in, instance, id, point_out, scratch, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  scene::intersection(
+      ray const &ray_in,
+      integer &instance,
+      integer &id,
+      point &point_out,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    real t;
+    if (!this->nearestHit(ray_in, INFTY, instance, id, t, scratch, tolerance))
+      return false;
+    point_out = ray_in.origin() + t * ray_in.direction();
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  scene::intersection(
+      segment const &segment_in,
+      integer &instance,
+      integer &id,
+      point &point_out,
+      real tolerance)
+      const
+  {
+    context scratch;
+    return this->intersection(segment_in, instance, id, point_out, scratch, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  scene::intersection(
+      segment const &segment_in,
+      integer &instance,
+      integer &id,
+      point &point_out,
+      context &scratch,
+      real tolerance)
+      const
+  {
+    real t;
+    ray ray_in(segment_in.vertex(0), segment_in.toVector());
+    if (!this->nearestHit(ray_in, 1.0, instance, id, t, scratch, tolerance))
+      return false;
+    point_out = ray_in.origin() + t * ray_in.direction();
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  scene::intersection(
+      aabb const &box,
+      aabb::vecpairid &candidates)
+      const
+  {
+    ACME_ASSERT(this->m_updated, "acme::scene::intersection(): top-level AABB tree not updated.")
+    candidates.clear();
+    aabb::vecid instances, ids;
+    this->m_AABBtree->select(
+        [&box](aabb const &box_k) { return box.intersects(box_k); },
+        instances);
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+      integer k = instances[i];
+      vec3 min(vec3::Constant(INFTY));
+      vec3 max(vec3::Constant(-INFTY));
+      for (integer c = 0; c < 8; ++c)
+      {
+        vec3 corner(c & 1 ? box.max(0) : box.min(0),
+                    c & 2 ? box.max(1) : box.min(1),
+                    c & 4 ? box.max(2) : box.min(2));
+        corner = this->m_inverses[k] * corner;
+        min = min.cwiseMin(corner);
+        max = max.cwiseMax(corner);
+      }
+      this->m_geometries[k]->intersection(aabb(min, max), ids);
+      for (size_t j = 0; j < ids.size(); ++j)
+        candidates.push_back(aabb::pairid(k, ids[j]));
+    }
+    return !candidates.empty();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme_scene.cc
+///
@@ -120,9 +120,9 @@ namespace acme
   point const &
   triangle::vertex(
       size_t i)
-      const
+      const ACME_NOEXCEPT
   {
-    ACME_ASSERT(i < 3, "acme::triangle::vertex(): index out of bounds [0,2]");
+    ACME_ASSERT_DEBUG(i < 3, "acme::triangle::vertex(): index out of bounds [0,2]");
     return this->m_vertex[i];
   }
 
@@ -131,8 +131,9 @@ namespace acme
   point &
   triangle::vertex(
       size_t i)
+      ACME_NOEXCEPT
   {
-    ACME_ASSERT(i < 3, "acme::triangle::vertex(): index out of bounds [0,2]");
+    ACME_ASSERT_DEBUG(i < 3, "acme::triangle::vertex(): index out of bounds [0,2]");
     return this->m_vertex[i];
   }
 
@@ -141,9 +142,9 @@ namespace acme
   point const &
   triangle::operator[](
       size_t i)
-      const
+      const ACME_NOEXCEPT
   {
-    ACME_ASSERT(i < 3, "acme::triangle::operator[]: index out of bounds [0,2]");
+    ACME_ASSERT_DEBUG(i < 3, "acme::triangle::operator[]: index out of bounds [0,2]");
     return this->m_vertex[i];
   }
 
@@ -152,8 +153,9 @@ namespace acme
   point &
   triangle::operator[](
       size_t i)
+      ACME_NOEXCEPT
   {
-    ACME_ASSERT(i < 3, "acme::triangle::operator[]: index out of bounds [0,2]");
+    ACME_ASSERT_DEBUG(i < 3, "acme::triangle::operator[]: index out of bounds [0,2]");
     return this->m_vertex[i];
   }
 
@@ -173,7 +175,7 @@ namespace acme
       size_t i)
       const
   {
-    ACME_ASSERT(i < 3, "acme::triangle::edge(): index out of bounds [0,2]");
+    ACME_ASSERT_DEBUG(i < 3, "acme::triangle::edge(): index out of bounds [0,2]");
     if (i == 0)
       return segment(this->m_vertex[0], this->m_vertex[1]);
     else if (i == 1)
@@ -259,6 +261,53 @@ namespace acme
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  point
+  triangle::closestPoint(
+      point const &point_in)
+      const
+  {
+    // Voronoi regions of vertices, edges and face (Ericson, Real-Time Collision Detection)
+    point const &a = this->m_vertex[0];
+    point const &b = this->m_vertex[1];
+    point const &c = this->m_vertex[2];
+    vec3 ab(b - a);
+    vec3 ac(c - a);
+    vec3 ap(point_in - a);
+    real d1 = ab.dot(ap);
+    real d2 = ac.dot(ap);
+    if (d1 <= 0.0 && d2 <= 0.0)
+      return a;
+
+    vec3 bp(point_in - b);
+    real d3 = ab.dot(bp);
+    real d4 = ac.dot(bp);
+    if (d3 >= 0.0 && d4 <= d3)
+      return b;
+
+    real vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+      return a + d1 / (d1 - d3) * ab;
+
+    vec3 cp(point_in - c);
+    real d5 = ab.dot(cp);
+    real d6 = ac.dot(cp);
+    if (d6 >= 0.0 && d5 <= d6)
+      return c;
+
+    real vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+      return a + d2 / (d2 - d6) * ac;
+
+    real va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+      return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+
+    real denom = 1.0 / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   triangle::translate(
       vec3 const &vector_in)
@@ -0,0 +1,361 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+///
+/// file: acme_triangleBlock.cc
+///
+
+#include "acme_triangleBlock.hh"
+
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace acme
+{
+
+  /*\
+   |   _        _                   _      ____  _            _    
+   |  | |_ _ __(_) __ _ _ __   __ _| | ___| __ )| | ___   ___| | __
+   |  | __| '__| |/ _` | '_ \ / _` | |/ _ \  _ \| |/ _ \ / __| |/ /
+   |  | |_| |  | | (_| | | | | (_| | |  __/ |_) | | (_) | (__|   < 
+   |   \__|_|  |_|\__,_|_| |_|\__, |_|\___|____/|_|\___/ \___|_|\_\
+   |                          |___/                                
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer const triangleBlock::LANES;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  triangleBlock::triangleBlock()
+  {
+    this->clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  triangleBlock::clear(void)
+  {
+    for (integer i = 0; i < 3; ++i)
+      for (integer j = 0; j < 3; ++j)
+        for (integer k = 0; k < LANES; ++k)
+          this->m_vertex[i][j][k] = QUIET_NAN;
+    for (integer k = 0; k < LANES; ++k)
+      this->m_id[k] = -1;
+    this->m_size = 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  triangleBlock::size(void)
+      const
+  {
+    return this->m_size;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  triangleBlock::isFull(void)
+      const
+  {
+    return this->m_size == LANES;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  triangleBlock::isEmpty(void)
+      const
+  {
+    return this->m_size == 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  triangleBlock::push_back(
+      triangle const &triangle_in,
+      integer id)
+  {
+    if (this->isFull())
+      return false;
+    for (integer i = 0; i < 3; ++i)
+      for (integer j = 0; j < 3; ++j)
+        this->m_vertex[i][j][this->m_size] = triangle_in.vertex(i)[j];
+    this->m_id[this->m_size] = id;
+    ++this->m_size;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  triangleBlock::set(
+      integer i,
+      triangle const &triangle_in)
+  {
+    ACME_ASSERT_DEBUG(i >= 0 && i < this->m_size,
+                      "acme::triangleBlock::set(): lane out of range.");
+    for (integer j = 0; j < 3; ++j)
+      for (integer k = 0; k < 3; ++k)
+        this->m_vertex[j][k][i] = triangle_in.vertex(j)[k];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  triangleBlock::id(
+      integer i)
+      const ACME_NOEXCEPT
+  {
+    ACME_ASSERT_DEBUG(i >= 0 && i < this->m_size,
+                      "acme::triangleBlock::id(): lane out of range.");
+    return this->m_id[i];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  triangle
+  triangleBlock::getTriangle(
+      integer i)
+      const
+  {
+    ACME_ASSERT_DEBUG(i >= 0 && i < this->m_size,
+                      "acme::triangleBlock::getTriangle(): lane out of range.");
+    return triangle(point(this->m_vertex[0][0][i], this->m_vertex[0][1][i], this->m_vertex[0][2][i]),
+                    point(this->m_vertex[1][0][i], this->m_vertex[1][1][i], this->m_vertex[1][2][i]),
+                    point(this->m_vertex[2][0][i], this->m_vertex[2][1][i], this->m_vertex[2][2][i]));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  triangleBlock::clamp(
+      aabb &aabb_out)
+      const
+  {
+    for (integer j = 0; j < 3; ++j)
+    {
+      real min = INFTY;
+      real max = -INFTY;
+      for (integer i = 0; i < 3; ++i)
+        for (integer k = 0; k < this->m_size; ++k)
+        {
+          min = std::min(min, this->m_vertex[i][j][k]);
+          max = std::max(max, this->m_vertex[i][j][k]);
+        }
+      aabb_out.min(j) = min;
+      aabb_out.max(j) = max;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  triangleBlock::intersection(
+      ray const &ray_in,
+      integer &lane,
+      real &t,
+      real &u,
+      real &v)
+      const
+  {
+    // Permute the axes so that the ray direction has its largest component along z
+    vec3 const &origin = ray_in.origin();
+    vec3 const &direction = ray_in.direction();
+    integer kz = 0;
+    direction.cwiseAbs().maxCoeff(&kz);
+    integer kx = (kz + 1) % 3;
+    integer ky = (kx + 1) % 3;
+    if (direction[kz] < 0.0)
+      std::swap(kx, ky);
+
+    // Shear constants that map the ray direction to the unit z axis
+    real Sx = direction[kx] / direction[kz];
+    real Sy = direction[ky] / direction[kz];
+    real Sz = 1.0 / direction[kz];
+    real Ox = origin[kx];
+    real Oy = origin[ky];
+    real Oz = origin[kz];
+    real t_max = t;
+
+    real const *Ax_ptr = this->m_vertex[0][kx];
+    real const *Ay_ptr = this->m_vertex[0][ky];
+    real const *Az_ptr = this->m_vertex[0][kz];
+    real const *Bx_ptr = this->m_vertex[1][kx];
+    real const *By_ptr = this->m_vertex[1][ky];
+    real const *Bz_ptr = this->m_vertex[1][kz];
+    real const *Cx_ptr = this->m_vertex[2][kx];
+    real const *Cy_ptr = this->m_vertex[2][ky];
+    real const *Cz_ptr = this->m_vertex[2][kz];
+
+    // Lanes results (missed lanes get an infinite ray parameter)
+    EIGEN_ALIGN_MAX real hit_t[LANES];
+    EIGEN_ALIGN_MAX real hit_u[LANES];
+    EIGEN_ALIGN_MAX real hit_v[LANES];
+
+#if defined(__AVX512F__)
+    __m512d const zero = _mm512_setzero_pd();
+    __m512d const infty = _mm512_set1_pd(INFTY);
+    __m512d const sx = _mm512_set1_pd(Sx);
+    __m512d const sy = _mm512_set1_pd(Sy);
+    __m512d const sz = _mm512_set1_pd(Sz);
+    __m512d const ox = _mm512_set1_pd(Ox);
+    __m512d const oy = _mm512_set1_pd(Oy);
+    __m512d const oz = _mm512_set1_pd(Oz);
+    __m512d const tmax = _mm512_set1_pd(t_max);
+    for (integer k = 0; k < LANES; k += 8)
+    {
+      __m512d Az = _mm512_sub_pd(_mm512_loadu_pd(Az_ptr + k), oz);
+      __m512d Bz = _mm512_sub_pd(_mm512_loadu_pd(Bz_ptr + k), oz);
+      __m512d Cz = _mm512_sub_pd(_mm512_loadu_pd(Cz_ptr + k), oz);
+      __m512d Ax = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(Ax_ptr + k), ox), _mm512_mul_pd(sx, Az));
+      __m512d Ay = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(Ay_ptr + k), oy), _mm512_mul_pd(sy, Az));
+      __m512d Bx = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(Bx_ptr + k), ox), _mm512_mul_pd(sx, Bz));
+      __m512d By = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(By_ptr + k), oy), _mm512_mul_pd(sy, Bz));
+      __m512d Cx = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(Cx_ptr + k), ox), _mm512_mul_pd(sx, Cz));
+      __m512d Cy = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(Cy_ptr + k), oy), _mm512_mul_pd(sy, Cz));
+      __m512d U = _mm512_sub_pd(_mm512_mul_pd(Cx, By), _mm512_mul_pd(Cy, Bx));
+      __m512d V = _mm512_sub_pd(_mm512_mul_pd(Ax, Cy), _mm512_mul_pd(Ay, Cx));
+      __m512d W = _mm512_sub_pd(_mm512_mul_pd(Bx, Ay), _mm512_mul_pd(By, Ax));
+      __mmask8 pos = _mm512_cmp_pd_mask(U, zero, _CMP_GE_OQ) &
+                     _mm512_cmp_pd_mask(V, zero, _CMP_GE_OQ) &
+                     _mm512_cmp_pd_mask(W, zero, _CMP_GE_OQ);
+      __mmask8 neg = _mm512_cmp_pd_mask(U, zero, _CMP_LE_OQ) &
+                     _mm512_cmp_pd_mask(V, zero, _CMP_LE_OQ) &
+                     _mm512_cmp_pd_mask(W, zero, _CMP_LE_OQ);
+      __m512d det = _mm512_add_pd(_mm512_add_pd(U, V), W);
+      __m512d T = _mm512_mul_pd(sz, _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(U, Az), _mm512_mul_pd(V, Bz)), _mm512_mul_pd(W, Cz)));
+      __m512d inv_det = _mm512_div_pd(_mm512_set1_pd(1.0), det);
+      __m512d tt = _mm512_mul_pd(T, inv_det);
+      __mmask8 valid = (pos | neg) &
+                       _mm512_cmp_pd_mask(det, zero, _CMP_NEQ_OQ) &
+                       _mm512_cmp_pd_mask(tt, zero, _CMP_GE_OQ) &
+                       _mm512_cmp_pd_mask(tt, tmax, _CMP_LT_OQ);
+      _mm512_storeu_pd(hit_t + k, _mm512_mask_blend_pd(valid, infty, tt));
+      _mm512_storeu_pd(hit_u + k, _mm512_mul_pd(V, inv_det));
+      _mm512_storeu_pd(hit_v + k, _mm512_mul_pd(W, inv_det));
+    }
+#elif defined(__AVX__)
+    __m256d const zero = _mm256_setzero_pd();
+    __m256d const infty = _mm256_set1_pd(INFTY);
+    __m256d const sx = _mm256_set1_pd(Sx);
+    __m256d const sy = _mm256_set1_pd(Sy);
+    __m256d const sz = _mm256_set1_pd(Sz);
+    __m256d const ox = _mm256_set1_pd(Ox);
+    __m256d const oy = _mm256_set1_pd(Oy);
+    __m256d const oz = _mm256_set1_pd(Oz);
+    __m256d const tmax = _mm256_set1_pd(t_max);
+    for (integer k = 0; k < LANES; k += 4)
+    {
+      __m256d Az = _mm256_sub_pd(_mm256_loadu_pd(Az_ptr + k), oz);
+      __m256d Bz = _mm256_sub_pd(_mm256_loadu_pd(Bz_ptr + k), oz);
+      __m256d Cz = _mm256_sub_pd(_mm256_loadu_pd(Cz_ptr + k), oz);
+      __m256d Ax = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(Ax_ptr + k), ox), _mm256_mul_pd(sx, Az));
+      __m256d Ay = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(Ay_ptr + k), oy), _mm256_mul_pd(sy, Az));
+      __m256d Bx = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(Bx_ptr + k), ox), _mm256_mul_pd(sx, Bz));
+      __m256d By = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(By_ptr + k), oy), _mm256_mul_pd(sy, Bz));
+      __m256d Cx = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(Cx_ptr + k), ox), _mm256_mul_pd(sx, Cz));
+      __m256d Cy = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(Cy_ptr + k), oy), _mm256_mul_pd(sy, Cz));
+      __m256d U = _mm256_sub_pd(_mm256_mul_pd(Cx, By), _mm256_mul_pd(Cy, Bx));
+      __m256d V = _mm256_sub_pd(_mm256_mul_pd(Ax, Cy), _mm256_mul_pd(Ay, Cx));
+      __m256d W = _mm256_sub_pd(_mm256_mul_pd(Bx, Ay), _mm256_mul_pd(By, Ax));
+      __m256d pos = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(U, zero, _CMP_GE_OQ),
+                                                _mm256_cmp_pd(V, zero, _CMP_GE_OQ)),
+                                  _mm256_cmp_pd(W, zero, _CMP_GE_OQ));
+      __m256d neg = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(U, zero, _CMP_LE_OQ),
+                                                _mm256_cmp_pd(V, zero, _CMP_LE_OQ)),
+                                  _mm256_cmp_pd(W, zero, _CMP_LE_OQ));
+      __m256d det = _mm256_add_pd(_mm256_add_pd(U, V), W);
+      __m256d T = _mm256_mul_pd(sz, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(U, Az), _mm256_mul_pd(V, Bz)), _mm256_mul_pd(W, Cz)));
+      __m256d inv_det = _mm256_div_pd(_mm256_set1_pd(1.0), det);
+      __m256d tt = _mm256_mul_pd(T, inv_det);
+      __m256d valid = _mm256_and_pd(_mm256_or_pd(pos, neg),
+                                    _mm256_and_pd(_mm256_cmp_pd(det, zero, _CMP_NEQ_OQ),
+                                                  _mm256_and_pd(_mm256_cmp_pd(tt, zero, _CMP_GE_OQ),
+                                                                _mm256_cmp_pd(tt, tmax, _CMP_LT_OQ))));
+      _mm256_storeu_pd(hit_t + k, _mm256_blendv_pd(infty, tt, valid));
+      _mm256_storeu_pd(hit_u + k, _mm256_mul_pd(V, inv_det));
+      _mm256_storeu_pd(hit_v + k, _mm256_mul_pd(W, inv_det));
+    }
+#else
+    // Branch-free lanes loop (auto-vectorized by the compiler)
+    for (integer k = 0; k < LANES; ++k)
+    {
+      real Az = Az_ptr[k] - Oz;
+      real Bz = Bz_ptr[k] - Oz;
+      real Cz = Cz_ptr[k] - Oz;
+      real Ax = Ax_ptr[k] - Ox - Sx * Az;
+      real Ay = Ay_ptr[k] - Oy - Sy * Az;
+      real Bx = Bx_ptr[k] - Ox - Sx * Bz;
+      real By = By_ptr[k] - Oy - Sy * Bz;
+      real Cx = Cx_ptr[k] - Ox - Sx * Cz;
+      real Cy = Cy_ptr[k] - Oy - Sy * Cz;
+      real U = Cx * By - Cy * Bx;
+      real V = Ax * Cy - Ay * Cx;
+      real W = Bx * Ay - By * Ax;
+      bool pos = (U >= 0.0) & (V >= 0.0) & (W >= 0.0);
+      bool neg = (U <= 0.0) & (V <= 0.0) & (W <= 0.0);
+      real det = U + V + W;
+      real T = Sz * (U * Az + V * Bz + W * Cz);
+      real inv_det = 1.0 / det;
+      real tt = T * inv_det;
+      bool valid = (pos | neg) & (det != 0.0) & (tt >= 0.0) & (tt < t_max);
+      hit_t[k] = valid ? tt : INFTY;
+      hit_u[k] = V * inv_det;
+      hit_v[k] = W * inv_det;
+    }
+#endif
+
+    // Nearest hit among the lanes
+    integer nearest = -1;
+    for (integer k = 0; k < this->m_size; ++k)
+    {
+      if (hit_t[k] < t_max && (nearest < 0 || hit_t[k] < hit_t[nearest]))
+        nearest = k;
+    }
+    if (nearest < 0)
+      return false;
+    lane = nearest;
+    t = hit_t[nearest];
+    u = hit_u[nearest];
+    v = hit_v[nearest];
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme_triangleBlock.cc
+///
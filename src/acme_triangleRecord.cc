@@ -0,0 +1,217 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+///
+/// file: acme_triangleRecord.cc
+///
+
+#include "acme_triangleRecord.hh"
+
+namespace acme
+{
+
+  /*\
+   |   _        _                   _      ____                        _ 
+   |  | |_ _ __(_) __ _ _ __   __ _| | ___|  _ \ ___  ___ ___  _ __ __| |
+   |  | __| '__| |/ _` | '_ \ / _` | |/ _ \ |_) / _ \/ __/ _ \| '__/ _` |
+   |  | |_| |  | | (_| | | | | (_| | |  __/  _ <  __/ (_| (_) | | | (_| |
+   |   \__|_|  |_|\__,_|_| |_|\__, |_|\___|_| \_\___|\___\___/|_|  \__,_|
+   |                          |___/                                      
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  triangleRecord::triangleRecord()
+  {
+    this->clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  triangleRecord::triangleRecord(
+      triangle const &triangle_in)
+  {
+    this->build(triangle_in);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  triangleRecord &
+  triangleRecord::operator=(
+      triangleRecord const &triangleRecord_in)
+  {
+    if (this == &triangleRecord_in)
+    {
+      return *this;
+    }
+    else
+    {
+      this->m_normal = triangleRecord_in.m_normal;
+      this->m_d = triangleRecord_in.m_d;
+      this->m_beta = triangleRecord_in.m_beta;
+      this->m_beta_d = triangleRecord_in.m_beta_d;
+      this->m_gamma = triangleRecord_in.m_gamma;
+      this->m_gamma_d = triangleRecord_in.m_gamma_d;
+      return *this;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  triangleRecord::build(
+      triangle const &triangle_in)
+  {
+    point const &vertex0 = triangle_in.vertex(0);
+    vec3 edge1(triangle_in.vertex(1) - vertex0);
+    vec3 edge2(triangle_in.vertex(2) - vertex0);
+    vec3 normal(edge1.cross(edge2));
+    real norm2 = normal.squaredNorm();
+    if (norm2 > EPSILON_MACHINE * EPSILON_MACHINE)
+    {
+      // Rows of the inverse of [edge1, edge2, normal] matrix
+      this->m_beta = edge2.cross(normal) / norm2;
+      this->m_gamma = normal.cross(edge1) / norm2;
+      this->m_beta_d = -this->m_beta.dot(vertex0);
+      this->m_gamma_d = -this->m_gamma.dot(vertex0);
+      this->m_normal = normal / std::sqrt(norm2);
+      this->m_d = -this->m_normal.dot(vertex0);
+    }
+    else
+    {
+      this->clear();
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  triangleRecord::clear(void)
+  {
+    this->m_normal = NAN_VEC3;
+    this->m_d = QUIET_NAN;
+    this->m_beta = NAN_VEC3;
+    this->m_beta_d = QUIET_NAN;
+    this->m_gamma = NAN_VEC3;
+    this->m_gamma_d = QUIET_NAN;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  triangleRecord::isDegenerated(void)
+      const
+  {
+    return !std::isfinite(this->m_d);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  vec3 const &
+  triangleRecord::normal(void)
+      const
+  {
+    return this->m_normal;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  triangleRecord::d(void)
+      const
+  {
+    return this->m_d;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  plane
+  triangleRecord::layingPlane(void)
+      const
+  {
+    return plane(-this->m_d * this->m_normal, this->m_normal);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  triangleRecord::signedDistance(
+      point const &point_in)
+      const
+  {
+    return this->m_normal.dot(point_in) + this->m_d;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  triangleRecord::barycentric(
+      point const &point_in,
+      real &u,
+      real &v,
+      real &w)
+      const
+  {
+    v = this->m_beta.dot(point_in) + this->m_beta_d;
+    w = this->m_gamma.dot(point_in) + this->m_gamma_d;
+    u = 1.0 - v - w;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  triangleRecord::isInside(
+      point const &point_in,
+      real tolerance)
+      const
+  {
+    if (!(std::abs(this->signedDistance(point_in)) <= tolerance))
+      return false;
+    real u, v, w;
+    this->barycentric(point_in, u, v, w);
+    return triangleRecord::isInside(u, v, w, tolerance);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  triangleRecord::isInside(
+      real u,
+      real v,
+      real w,
+      real tolerance)
+  {
+    return v >= -tolerance && w >= -tolerance && u >= -tolerance;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme_triangleRecord.cc
+///
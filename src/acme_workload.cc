@@ -0,0 +1,530 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+///
+/// file: acme_workload.cc
+///
+
+#include "acme_workload.hh"
+
+#include <cmath>
+
+namespace acme
+{
+
+  // Uniform random value in [a, b) from the raw std::mt19937 output (distributions are
+  // implementation-defined, the raw output is not)
+  static real
+  uniform(
+      std::mt19937 &generator,
+      real a,
+      real b)
+  {
+    return a + (b - a) * (generator() / 4294967296.0);
+  }
+
+  // Smooth step from 0 to 1 over [0, 1]
+  static real
+  smoothStep(
+      real t)
+  {
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    return t * t * (3.0 - 2.0 * t);
+  }
+
+  /*\
+   |                       _ 
+   |   _ __ ___   __ _  __| |
+   |  | '__/ _ \ / _` |/ _` |
+   |  | | | (_) | (_| | (_| |
+   |  |_|  \___/ \__,_|\__,_|
+   |                         
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  road::road(
+      unsigned int seed,
+      real length,
+      real width,
+      real resolution)
+      : m_seed(seed),
+        m_length(length),
+        m_width(width),
+        m_sidewalk(2.0),
+        m_resolution(resolution),
+        m_kerb(0.0)
+  {
+    std::mt19937 generator(this->m_seed);
+    this->m_phase = uniform(generator, 0.0, 2.0 * PI);
+    this->m_grade = uniform(generator, -0.02, 0.02);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  road::features(
+      integer potholes,
+      integer bridges,
+      real kerb)
+  {
+    // Skip the values drawn by the constructor so the features only depend on the seed
+    std::mt19937 generator(this->m_seed);
+    generator.discard(2);
+    this->m_kerb = kerb;
+
+    this->m_potholes.clear();
+    for (integer i = 0; i < potholes; ++i)
+    {
+      pothole hole;
+      hole.radius = uniform(generator, 0.2, 0.6);
+      hole.depth = uniform(generator, 0.03, 0.10);
+      hole.x = uniform(generator, 0.0, this->m_length);
+      hole.offset = uniform(generator, -0.5 * this->m_width + hole.radius, 0.5 * this->m_width - hole.radius);
+      this->m_potholes.push_back(hole);
+    }
+
+    // One bridge per road slot, with room for the access ramps
+    this->m_bridges.clear();
+    real ramp = 30.0;
+    real slot = bridges > 0 ? this->m_length / bridges : 0.0;
+    for (integer i = 0; i < bridges; ++i)
+    {
+      real span = std::min(uniform(generator, 40.0, 80.0), slot - 2.0 * ramp);
+      real start = i * slot + ramp + uniform(generator, 0.0, 1.0) * (slot - 2.0 * ramp - span);
+      real height = uniform(generator, 4.0, 6.0);
+      if (span <= 0.0)
+        continue;
+      bridge deck;
+      deck.start = start;
+      deck.end = start + span;
+      deck.height = height;
+      this->m_bridges.push_back(deck);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  road::fit(
+      integer triangles)
+  {
+    real bridged = 0.0;
+    for (size_t i = 0; i < this->m_bridges.size(); ++i)
+      bridged += this->m_bridges[i].end - this->m_bridges[i].start;
+    real area = this->m_length * (this->m_width + 2.0 * this->m_sidewalk);
+    this->m_resolution = std::sqrt(2.0 * area * (1.0 + bridged / this->m_length) / std::max(triangles, integer(2)));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  road::length(void)
+      const
+  {
+    return this->m_length;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  road::width(void)
+      const
+  {
+    return this->m_width;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  road::resolution(void)
+      const
+  {
+    return this->m_resolution;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  road::grid(
+      integer &nx,
+      integer &ny)
+      const
+  {
+    nx = std::max(integer(std::ceil(this->m_length / this->m_resolution)), integer(1));
+    ny = std::max(integer(std::ceil((this->m_width + 2.0 * this->m_sidewalk) / this->m_resolution)), integer(1));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  road::bridgeCells(
+      bridge const &bridge_in,
+      integer &start,
+      integer &cells)
+      const
+  {
+    integer nx, ny;
+    this->grid(nx, ny);
+    real dx = this->m_length / nx;
+    start = integer(std::ceil(bridge_in.start / dx));
+    cells = std::max(integer(std::floor(bridge_in.end / dx)) - start, integer(0));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  road::size(void)
+      const
+  {
+    integer nx, ny, start, cells;
+    this->grid(nx, ny);
+    integer size = 2 * nx * ny;
+    for (size_t i = 0; i < this->m_bridges.size(); ++i)
+    {
+      this->bridgeCells(this->m_bridges[i], start, cells);
+      size += 2 * cells * ny;
+    }
+    return size;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  road::centerline(
+      real x)
+      const
+  {
+    return 15.0 * std::sin(2.0 * PI * x / 400.0 + this->m_phase) +
+           5.0 * std::sin(2.0 * PI * x / 150.0);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  vec3
+  road::tangent(
+      real x)
+      const
+  {
+    real slope = 15.0 * 2.0 * PI / 400.0 * std::cos(2.0 * PI * x / 400.0 + this->m_phase) +
+                 5.0 * 2.0 * PI / 150.0 * std::cos(2.0 * PI * x / 150.0);
+    return vec3(1.0, slope, 0.0).normalized();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  road::noise(
+      integer i,
+      integer j)
+      const
+  {
+    unsigned int h = static_cast<unsigned int>(i) * 73856093u ^
+                     static_cast<unsigned int>(j) * 19349663u ^
+                     this->m_seed * 83492791u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h / 2147483647.5 - 1.0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  road::smoothNoise(
+      real x,
+      real y)
+      const
+  {
+    real fx = std::floor(x);
+    real fy = std::floor(y);
+    integer i = integer(fx);
+    integer j = integer(fy);
+    real u = smoothStep(x - fx);
+    real v = smoothStep(y - fy);
+    return (1.0 - v) * ((1.0 - u) * this->noise(i, j) + u * this->noise(i + 1, j)) +
+           v * ((1.0 - u) * this->noise(i, j + 1) + u * this->noise(i + 1, j + 1));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  road::groundHeight(
+      real x,
+      real offset)
+      const
+  {
+    // Grade, undulations, camber and roughness
+    real z = this->m_grade * x +
+             0.5 * std::sin(2.0 * PI * x / 200.0 + this->m_phase) +
+             0.2 * std::sin(2.0 * PI * x / 57.0 + 2.0 * this->m_phase) -
+             0.02 * std::abs(offset) +
+             0.01 * this->smoothNoise(x, offset);
+
+    // Kerbs and sidewalks
+    real half = 0.5 * this->m_width;
+    if (std::abs(offset) > half)
+      return z + this->m_kerb;
+
+    // Potholes
+    for (size_t i = 0; i < this->m_potholes.size(); ++i)
+    {
+      pothole const &hole = this->m_potholes[i];
+      real dx = x - hole.x;
+      real dy = offset - hole.offset;
+      real squared = (dx * dx + dy * dy) / (hole.radius * hole.radius);
+      if (squared < 1.0)
+        z -= hole.depth * (1.0 - squared);
+    }
+    return z;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real
+  road::height(
+      real x,
+      real y)
+      const
+  {
+    real z = this->groundHeight(x, y - this->centerline(x));
+    real ramp = 30.0;
+    for (size_t i = 0; i < this->m_bridges.size(); ++i)
+    {
+      bridge const &deck = this->m_bridges[i];
+      z += deck.height * smoothStep((x - deck.start + ramp) / ramp) * smoothStep((deck.end + ramp - x) / ramp);
+    }
+    return z;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  road::patch(
+      collection &collection_out,
+      integer start,
+      integer cells,
+      bool ground)
+      const
+  {
+    integer nx, ny;
+    this->grid(nx, ny);
+    real dx = this->m_length / nx;
+    real half = 0.5 * this->m_width + this->m_sidewalk;
+    real dy = 2.0 * half / ny;
+
+    // Nodes of two consecutive grid rows
+    std::vector<point> row0(ny + 1), row1(ny + 1);
+    for (integer i = start; i <= start + cells; ++i)
+    {
+      real x = i * dx;
+      real c = this->centerline(x);
+      for (integer j = 0; j <= ny; ++j)
+      {
+        real offset = -half + j * dy;
+        real z = ground ? this->groundHeight(x, offset) : this->height(x, c + offset);
+        row1[j] = point(x, c + offset, z);
+      }
+      if (i > start)
+        for (integer j = 0; j < ny; ++j)
+        {
+          collection_out.emplace_back<triangle>(row0[j], row1[j], row1[j + 1]);
+          collection_out.emplace_back<triangle>(row0[j], row1[j + 1], row0[j + 1]);
+        }
+      row0.swap(row1);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  road::generate(
+      collection &collection_out)
+      const
+  {
+    integer nx, ny, start, cells;
+    this->grid(nx, ny);
+    this->patch(collection_out, 0, nx, false);
+    for (size_t i = 0; i < this->m_bridges.size(); ++i)
+    {
+      this->bridgeCells(this->m_bridges[i], start, cells);
+      if (cells > 0)
+        this->patch(collection_out, start, cells, true);
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*\
+   |                      _    _                 _ 
+   |  __      _____  _ __| | _| | ___   __ _  __| |
+   |  \ \ /\ / / _ \| '__| |/ / |/ _ \ / _` |/ _` |
+   |   \ V  V / (_) | |  |   <| | (_) | (_| | (_| |
+   |    \_/\_/ \___/|_|  |_|\_\_|\___/ \__,_|\__,_|
+   |                                               
+  \*/
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  workload::workload()
+      : m_frames(0),
+        m_rays(0)
+  {
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  workload::clear(void)
+  {
+    this->m_frames = 0;
+    this->m_rays = 0;
+    this->m_tires.clear();
+    this->m_fan.clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  workload::generate(
+      road const &road_in,
+      integer frames,
+      integer rays,
+      unsigned int seed,
+      real speed,
+      real step)
+  {
+    this->clear();
+    this->m_frames = frames;
+    this->m_rays = rays;
+    this->m_tires.reserve(4 * frames);
+    this->m_fan.reserve(rays * frames);
+
+    // Vehicle data and seeded lateral wander
+    real wheelbase = 2.7;
+    real track = 1.6;
+    real radius = 0.32;
+    real sink = 0.02;
+    std::mt19937 generator(seed);
+    real wander = std::max(0.5 * road_in.width() - 0.5 * track - 0.3, 0.0);
+    real amplitude0 = uniform(generator, 0.3, 0.7) * wander;
+    real amplitude1 = uniform(generator, 0.0, 0.3) * wander;
+    real omega0 = uniform(generator, 0.1, 0.3);
+    real omega1 = uniform(generator, 0.5, 1.5);
+    real phase0 = uniform(generator, 0.0, 2.0 * PI);
+    real phase1 = uniform(generator, 0.0, 2.0 * PI);
+    real start = uniform(generator, 0.0, 0.1) * road_in.length();
+
+    real stretch = std::max(road_in.length() - wheelbase - 20.0, 1.0);
+    for (integer k = 0; k < frames; ++k)
+    {
+      real t = k * step;
+      real x = 5.0 + std::fmod(start + speed * t, stretch);
+      real offset = amplitude0 * std::sin(omega0 * t + phase0) + amplitude1 * std::sin(omega1 * t + phase1);
+
+      // Tires: front left, front right, rear left, rear right
+      real wheel_x[4] = {x + wheelbase, x + wheelbase, x, x};
+      real wheel_offset[4] = {offset + 0.5 * track, offset - 0.5 * track, offset + 0.5 * track, offset - 0.5 * track};
+      for (integer w = 0; w < 4; ++w)
+      {
+        vec3 tangent(road_in.tangent(wheel_x[w]));
+        vec3 normal(-tangent.y(), tangent.x(), 0.0);
+        real y = road_in.centerline(wheel_x[w]) + wheel_offset[w];
+        point center(wheel_x[w], y, road_in.height(wheel_x[w], y) + radius - sink);
+        this->m_tires.push_back(disk(radius, center, normal));
+      }
+
+      // Sensor rays fan looking at the road ahead
+      real sensor_x = x + wheelbase + 1.0;
+      real sensor_y = road_in.centerline(sensor_x) + offset;
+      point origin(sensor_x, sensor_y, road_in.height(sensor_x, sensor_y) + 1.5);
+      vec3 tangent(road_in.tangent(sensor_x));
+      real heading = std::atan2(tangent.y(), tangent.x());
+      real pitch = -10.0 * PI / 180.0;
+      for (integer i = 0; i < rays; ++i)
+      {
+        real yaw = heading + (rays > 1 ? (-20.0 + 40.0 * i / (rays - 1)) * PI / 180.0 : 0.0);
+        vec3 direction(std::cos(pitch) * std::cos(yaw), std::cos(pitch) * std::sin(yaw), std::sin(pitch));
+        this->m_fan.push_back(ray(origin, direction));
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  workload::frames(void)
+      const
+  {
+    return this->m_frames;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  workload::rays(void)
+      const
+  {
+    return this->m_rays;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  disk const &
+  workload::tire(
+      integer frame,
+      integer wheel)
+      const
+  {
+    ACME_ASSERT_DEBUG(frame >= 0 && frame < this->m_frames && wheel >= 0 && wheel < 4,
+                      "acme::workload::tire(): frame or wheel out of range.");
+    return this->m_tires[4 * frame + wheel];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  ray const &
+  workload::sensor(
+      integer frame,
+      integer i)
+      const
+  {
+    ACME_ASSERT_DEBUG(frame >= 0 && frame < this->m_frames && i >= 0 && i < this->m_rays,
+                      "acme::workload::sensor(): frame or ray out of range.");
+    return this->m_fan[this->m_rays * frame + i];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+} // namespace acme
+
+///
+/// eof: acme_workload.cc
+///
@@ -0,0 +1,155 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 17 - TRIANGLE RECORD INTERSECTIONS
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_triangle.hh"
+#include "acme_triangleRecord.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 17 - TRIANGLE RECORD INTERSECTIONS" << std::endl;
+
+  std::mt19937 generator(17);
+  std::uniform_real_distribution<real> distribution(-1.0, 1.0);
+
+  integer samples = 10000;
+  integer ray_hits = 0, ray_mismatch = 0;
+  integer segment_hits = 0, segment_mismatch = 0;
+  integer line_hits = 0, line_mismatch = 0;
+  integer point_mismatch = 0;
+  for (integer i = 0; i < samples; ++i)
+  {
+    triangle Triangle(point(distribution(generator), distribution(generator), distribution(generator)),
+                      point(distribution(generator), distribution(generator), distribution(generator)),
+                      point(distribution(generator), distribution(generator), distribution(generator)));
+    triangleRecord Record(Triangle);
+
+    point Origin(2.0 * distribution(generator), 2.0 * distribution(generator), 2.0 * distribution(generator));
+    vec3 Direction(distribution(generator), distribution(generator), distribution(generator));
+
+    point Point0, Point1;
+    bool Bool0, Bool1;
+
+    // Ray/triangle
+    ray Ray(Origin, Direction);
+    Bool0 = intersection(Ray, Triangle, Point0);
+    Bool1 = intersection(Ray, Record, Point1);
+    ray_hits += Bool0;
+    if (Bool0 != Bool1 || (Bool0 && !Point0.isApprox(Point1, EPSILON_LOW)))
+      ++ray_mismatch;
+
+    // Segment/triangle
+    segment Segment(Origin, Origin + 2.0 * Direction);
+    Bool0 = intersection(Segment, Triangle, Point0);
+    Bool1 = intersection(Segment, Record, Point1);
+    segment_hits += Bool0;
+    if (Bool0 != Bool1 || (Bool0 && !Point0.isApprox(Point1, EPSILON_LOW)))
+      ++segment_mismatch;
+
+    // Line/triangle
+    line Line(Origin, Direction);
+    Bool0 = intersection(Line, Triangle, Point0);
+    Bool1 = intersection(Line, Record, Point1);
+    line_hits += Bool0;
+    if (Bool0 != Bool1 || (Bool0 && !Point0.isApprox(Point1, EPSILON_LOW)))
+      ++line_mismatch;
+
+    // Point/triangle (point laying on the triangle plane)
+    point Point(Origin - Record.signedDistance(Origin) * Record.normal());
+    if (Triangle.isInside(Point) != Record.isInside(Point, EPSILON_LOW))
+      ++point_mismatch;
+  }
+
+  std::cout
+      << "Ray/triangle hits:     " << ray_hits << "\tmismatches: " << ray_mismatch << std::endl
+      << "Segment/triangle hits: " << segment_hits << "\tmismatches: " << segment_mismatch << std::endl
+      << "Line/triangle hits:    " << line_hits << "\tmismatches: " << line_mismatch << std::endl
+      << "Point/triangle mismatches: " << point_mismatch << std::endl;
+
+  // Shared edges: a ray through a point of the edge shared by two triangles hits at
+  // least one of the two records whenever it hits one of the two triangles
+  integer cracks = 0;
+  for (integer i = 0; i < samples; ++i)
+  {
+    point Vertex0(distribution(generator), distribution(generator), distribution(generator));
+    point Vertex1(distribution(generator), distribution(generator), distribution(generator));
+    point Vertex2(distribution(generator), distribution(generator), distribution(generator));
+    point Vertex3(distribution(generator), distribution(generator), distribution(generator));
+    triangle Triangle0(Vertex0, Vertex1, Vertex2);
+    triangle Triangle1(Vertex1, Vertex0, Vertex3);
+    triangleRecord Record0(Triangle0), Record1(Triangle1);
+    point Edge(Vertex0 + 0.5 * (distribution(generator) + 1.0) * (Vertex1 - Vertex0));
+    point Origin(distribution(generator), distribution(generator), distribution(generator));
+    ray Ray(Origin, Edge - Origin);
+    if ((intersection(Ray, Triangle0, THROWAWAY_POINT) || intersection(Ray, Triangle1, THROWAWAY_POINT)) &&
+        !intersection(Ray, Record0, THROWAWAY_POINT) && !intersection(Ray, Record1, THROWAWAY_POINT))
+      ++cracks;
+  }
+  std::cout << "Shared edge cracks: " << cracks << std::endl;
+
+  // Build records together with the collection AABB tree
+  entity::vecptr Entities;
+  Entities.push_back(std::make_shared<triangle>(point(0.0, 0.0, 0.0), point(1.0, 0.0, 0.0), point(0.0, 1.0, 0.0)));
+  Entities.push_back(std::make_shared<triangle>(point(0.0, 0.0, 1.0), point(1.0, 0.0, 1.0), point(0.0, 1.0, 1.0)));
+  Entities.push_back(std::make_shared<segment>(point(0.0, 0.0, 0.0), point(1.0, 1.0, 1.0)));
+  collection Collection(Entities);
+  Collection.buildAABBtree(true);
+
+  ray Ray(point(0.25, 0.25, -1.0), vec3(0.0, 0.0, 1.0));
+  for (integer i = 0; i < Collection.size(); ++i)
+  {
+    point Point;
+    std::cout
+        << "Entity " << i << " (" << Collection[i]->type() << ") record degenerated: "
+        << Collection.record(i).isDegenerated();
+    if (intersection(Ray, Collection.record(i), Point))
+      std::cout << "\thit: " << Point.transpose();
+    std::cout << std::endl;
+  }
+
+  std::cout
+      << std::endl
+      << std::endl
+      << "TEST 17: Completed" << std::endl;
+
+  // Exit the program
+  return cracks == 0 ? 0 : 1;
+}
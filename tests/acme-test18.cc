@@ -0,0 +1,165 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 18 - TRIANGLE BLOCK RAY INTERSECTIONS
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_triangle.hh"
+#include "acme_triangleBlock.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 18 - TRIANGLE BLOCK RAY INTERSECTIONS" << std::endl;
+
+  std::mt19937 generator(18);
+  std::uniform_real_distribution<real> distribution(-1.0, 1.0);
+
+  // Block kernel against scalar kernel on random triangles
+  integer samples = 2000;
+  integer hits = 0, mismatch = 0;
+  for (integer i = 0; i < samples; ++i)
+  {
+    triangleBlock Block;
+    std::vector<triangle> Triangles;
+    while (!Block.isFull())
+    {
+      triangle Triangle(point(distribution(generator), distribution(generator), distribution(generator)),
+                        point(distribution(generator), distribution(generator), distribution(generator)),
+                        point(distribution(generator), distribution(generator), distribution(generator)));
+      Block.push_back(Triangle, Triangles.size());
+      Triangles.push_back(Triangle);
+    }
+    ray Ray(point(2.0 * distribution(generator), 2.0 * distribution(generator), 2.0 * distribution(generator)),
+            vec3(distribution(generator), distribution(generator), distribution(generator)));
+
+    // Scalar nearest hit
+    real t_scalar = INFTY;
+    integer id_scalar = -1;
+    for (size_t j = 0; j < Triangles.size(); ++j)
+    {
+      point Point;
+      if (intersection(Ray, Triangles[j], Point))
+      {
+        real t = (Point - Ray.origin()).dot(Ray.direction()) / Ray.direction().squaredNorm();
+        if (t < t_scalar)
+        {
+          t_scalar = t;
+          id_scalar = j;
+        }
+      }
+    }
+
+    // Block nearest hit
+    integer lane;
+    real t = INFTY, u, v;
+    bool hit = Block.intersection(Ray, lane, t, u, v);
+    hits += hit;
+    if (hit != (id_scalar >= 0) || (hit && (Block.id(lane) != id_scalar || !isApprox(t, t_scalar, EPSILON_LOW))))
+      ++mismatch;
+    if (hit)
+    {
+      triangle Triangle(Block.getTriangle(lane));
+      point Point(Ray.origin() + t * Ray.direction());
+      point Barycentric(Triangle.vertex(0) + u * (Triangle.vertex(1) - Triangle.vertex(0)) + v * (Triangle.vertex(2) - Triangle.vertex(0)));
+      if (!Point.isApprox(Barycentric, EPSILON_LOW))
+        ++mismatch;
+    }
+  }
+  std::cout
+      << "Block/scalar hits: " << hits << "\tmismatches: " << mismatch << std::endl;
+
+  // Watertightness on a regular grid: rays through shared vertices and edges
+  integer n = 16;
+  entity::vecptr Entities;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point P00(i, j, 0.0), P10(i + 1, j, 0.0), P01(i, j + 1, 0.0), P11(i + 1, j + 1, 0.0);
+      Entities.push_back(std::make_shared<triangle>(P00, P10, P11));
+      Entities.push_back(std::make_shared<triangle>(P00, P11, P01));
+    }
+  collection Collection(Entities);
+  Collection.buildAABBtree();
+  Collection.buildBlocks();
+
+  integer rays = 0, block_hits = 0, tree_hits = 0;
+  collection Tree(Entities);
+  Tree.buildAABBtree();
+  for (integer i = 1; i < 2 * n; ++i)
+    for (integer j = 1; j < 2 * n; ++j)
+    {
+      point Target(0.5 * i, 0.5 * j, 0.0);
+      vec3 Direction(0.1, -0.2, -1.0);
+      ray Ray(Target - Direction, Direction);
+      ++rays;
+      integer id;
+      if (Collection.intersection(Ray, id))
+        ++block_hits;
+      if (Tree.intersection(Ray, id))
+        ++tree_hits;
+    }
+  std::cout
+      << "Grid rays: " << rays
+      << "\tblock hits: " << block_hits
+      << "\ttree hits: " << tree_hits << std::endl;
+
+  // Blocks are not used once new entities are added
+  collection Growing;
+  Growing.push_back(std::make_shared<triangle>(point(0.0, 0.0, 0.0), point(1.0, 0.0, 0.0), point(0.0, 1.0, 0.0)));
+  Growing.buildAABBtree();
+  Growing.buildBlocks();
+  bool built = Growing.hasBlocks();
+  Growing.push_back(std::make_shared<triangle>(point(2.0, 0.0, 0.0), point(3.0, 0.0, 0.0), point(2.0, 1.0, 0.0)));
+  bool pushed = Growing.hasBlocks();
+  Growing.buildAABBtree();
+  integer id = -1;
+  bool hit = Growing.intersection(ray(point(2.25, 0.25, 1.0), vec3(0.0, 0.0, -1.0)), id);
+  std::cout
+      << "Added entity:	blocks built " << built << "	after push " << pushed
+      << "	hit " << hit << "	id " << id << std::endl;
+  integer failed = !built || pushed || !hit || id != 1;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 18: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 19 - BATCH RAY AND SEGMENT QUERIES
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 19 - BATCH RAY AND SEGMENT QUERIES" << std::endl;
+
+  // Wavy terrain made of triangles
+  integer n = 32;
+  entity::vecptr Entities;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point P00(i, j, 0.1 * std::sin(i + j));
+      point P10(i + 1, j, 0.1 * std::sin(i + j + 1));
+      point P01(i, j + 1, 0.1 * std::sin(i + j + 1));
+      point P11(i + 1, j + 1, 0.1 * std::sin(i + j + 2));
+      Entities.push_back(std::make_shared<triangle>(P00, P10, P11));
+      Entities.push_back(std::make_shared<triangle>(P00, P11, P01));
+    }
+  collection Terrain(Entities);
+  Terrain.buildAABBtree(true);
+  Terrain.buildBlocks();
+
+  // Probe rays and segments
+  std::mt19937 generator(19);
+  std::uniform_real_distribution<real> distribution(0.0, n);
+  integer size = 10000;
+  std::vector<ray> Rays;
+  std::vector<segment> Segments;
+  for (integer i = 0; i < size; ++i)
+  {
+    point Origin(distribution(generator), distribution(generator), 1.0);
+    Rays.push_back(ray(Origin, vec3(0.01, -0.02, -1.0)));
+    Segments.push_back(segment(Origin, Origin + vec3(0.0, 0.0, -1.0 - 0.1 * (i % 3))));
+  }
+
+  std::vector<integer> RayIds, SegmentIds;
+  std::vector<point> RayPoints, SegmentPoints;
+  Terrain.intersection(Rays, RayIds, RayPoints);
+  Terrain.intersection(Segments, SegmentIds, SegmentPoints);
+
+  // Compare with one query at a time
+  integer ray_hits = 0, segment_hits = 0, mismatch = 0;
+  for (integer i = 0; i < size; ++i)
+  {
+    integer id;
+    point Point;
+    bool hit = Terrain.intersection(Rays[i], id, Point);
+    ray_hits += hit;
+    if (hit != (RayIds[i] >= 0) || (hit && (id != RayIds[i] || !Point.isApprox(RayPoints[i]))))
+      ++mismatch;
+    hit = Terrain.intersection(Segments[i], id, Point);
+    segment_hits += hit;
+    if (hit != (SegmentIds[i] >= 0) || (hit && (id != SegmentIds[i] || !Point.isApprox(SegmentPoints[i]))))
+      ++mismatch;
+  }
+
+  std::cout
+      << "Rays: " << size << "\thits: " << ray_hits << std::endl
+      << "Segments: " << size << "\thits: " << segment_hits << std::endl
+      << "Mismatches: " << mismatch << std::endl
+      << "Failed checks: " << mismatch << std::endl
+      << std::endl
+      << "TEST 19: Completed" << std::endl;
+
+  // Exit the program
+  return mismatch == 0 ? 0 : 1;
+}
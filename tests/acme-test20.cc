@@ -0,0 +1,141 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 20 - DISK CONTACT POLYLINE
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 20 - DISK CONTACT POLYLINE" << std::endl;
+
+  // Wavy terrain made of triangles
+  integer n = 16;
+  entity::vecptr Entities;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point P00(i, j, 0.1 * std::sin(i + j));
+      point P10(i + 1, j, 0.1 * std::sin(i + j + 1));
+      point P01(i, j + 1, 0.1 * std::sin(i + j + 1));
+      point P11(i + 1, j + 1, 0.1 * std::sin(i + j + 2));
+      Entities.push_back(std::make_shared<triangle>(P00, P10, P11));
+      Entities.push_back(std::make_shared<triangle>(P00, P11, P01));
+    }
+  collection Terrain(Entities);
+  Terrain.buildAABBtree(true);
+
+  // Tire cross-section sinking into the terrain
+  disk Tire(2.0, point(8.3, 7.7, 1.9), vec3(0.0, 1.0, 0.0));
+  std::vector<segment> Segments;
+  std::vector<integer> Ids;
+  std::vector<vec3> Normals;
+  bool hit = Terrain.intersection(Tire, Segments, Ids, Normals);
+
+  // Check polyline continuity
+  integer breaks = 0;
+  real length = 0.0;
+  for (size_t i = 0; i < Segments.size(); ++i)
+  {
+    length += Segments[i].length();
+    if (i > 0 && !Segments[i].vertex(0).isApprox(Segments[i - 1].vertex(1)))
+      ++breaks;
+  }
+  std::cout
+      << "Contact: " << hit << std::endl
+      << "Segments: " << Segments.size() << "\tbreaks: " << breaks
+      << "\tlength: " << length << std::endl;
+  for (size_t i = 0; i < Segments.size(); ++i)
+    std::cout
+        << "Id: " << Ids[i]
+        << "\tnormal: " << Normals[i].transpose() << std::endl;
+
+  // Flat terrain: collinear contact segments are merged into one
+  entity::vecptr Flat_entities;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point P00(i, j, 0.0), P10(i + 1, j, 0.0), P01(i, j + 1, 0.0), P11(i + 1, j + 1, 0.0);
+      Flat_entities.push_back(std::make_shared<triangle>(P00, P10, P11));
+      Flat_entities.push_back(std::make_shared<triangle>(P00, P11, P01));
+    }
+  collection Flat(Flat_entities);
+  Flat.buildAABBtree();
+  bool flat_hit = Flat.intersection(Tire, Segments, Ids, Normals);
+  real flat_length = 0.0;
+  for (size_t i = 0; i < Segments.size(); ++i)
+    flat_length += Segments[i].length();
+  real chord = 2.0 * std::sqrt(2.0 * 2.0 - 1.9 * 1.9);
+  std::cout
+      << "Flat contact: " << flat_hit << "	segments: " << Segments.size()
+      << "	chord length error: " << (std::abs(flat_length - chord) < EPSILON_LOW) << std::endl;
+  integer failed = !flat_hit || Segments.size() != 1 || std::abs(flat_length - chord) >= EPSILON_LOW;
+
+  // Disk-box test against a sampled reference
+  std::mt19937 generator(20);
+  std::uniform_real_distribution<real> distribution(-1.0, 1.0);
+  integer size = 2000, mismatch = 0;
+  for (integer i = 0; i < size; ++i)
+  {
+    vec3 Normal(distribution(generator), distribution(generator), distribution(generator));
+    disk Disk(0.5, point::Zero(), Normal.normalized());
+    point Center(distribution(generator), distribution(generator), distribution(generator));
+    aabb Box(Center - vec3(0.3, 0.2, 0.1), Center + vec3(0.3, 0.2, 0.1));
+    vec3 U = Disk.normal().unitOrthogonal();
+    vec3 V = Disk.normal().cross(U);
+    bool sampled = false;
+    for (integer r = 0; r <= 50 && !sampled; ++r)
+      for (integer k = 0; k < 200 && !sampled; ++k)
+      {
+        real angle = k * 2.0 * PI / 200.0;
+        point Point(0.01 * r * (std::cos(angle) * U + std::sin(angle) * V));
+        sampled = Box.intersects(aabb(Point, Point));
+      }
+    if (sampled && !intersection(Disk, Box))
+      ++mismatch;
+  }
+  std::cout
+      << "Disk-box samples: " << size << "\tmissed: " << mismatch << std::endl
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 20: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 21 - BALL PENETRATION
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 21 - BALL PENETRATION" << std::endl;
+
+  // Closest point against a sampled reference
+  std::mt19937 generator(21);
+  std::uniform_real_distribution<real> distribution(-1.0, 1.0);
+  integer size = 1000, mismatch = 0;
+  for (integer i = 0; i < size; ++i)
+  {
+    triangle Triangle(
+        point(distribution(generator), distribution(generator), distribution(generator)),
+        point(distribution(generator), distribution(generator), distribution(generator)),
+        point(distribution(generator), distribution(generator), distribution(generator)));
+    point Query(2.0 * point(distribution(generator), distribution(generator), distribution(generator)));
+    real distance = (Triangle.closestPoint(Query) - Query).norm();
+    real sampled = INFTY;
+    for (integer j = 0; j <= 100; ++j)
+      for (integer k = 0; j + k <= 100; ++k)
+      {
+        point Point(Triangle.vertex(0) + 0.01 * j * (Triangle.vertex(1) - Triangle.vertex(0)) +
+                    0.01 * k * (Triangle.vertex(2) - Triangle.vertex(0)));
+        sampled = std::min(sampled, (Point - Query).norm());
+      }
+    if (distance > sampled + EPSILON || sampled - distance > 0.05)
+      ++mismatch;
+  }
+  std::cout
+      << "Closest point samples: " << size << "\tmismatches: " << mismatch << std::endl;
+
+  // Disk and ball
+  disk Disk(1.0, point(0.0, 0.0, 0.0), vec3(0.0, 0.0, 1.0));
+  point Point;
+  bool hit = intersection(Disk, ball(0.5, point(1.2, 0.0, 0.3)), Point);
+  std::cout
+      << "Disk-ball: " << hit << "\tpoint: " << Point.transpose() << std::endl;
+
+  // Wavy terrain made of triangles
+  integer n = 16;
+  entity::vecptr Entities;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point P00(i, j, 0.1 * std::sin(i + j));
+      point P10(i + 1, j, 0.1 * std::sin(i + j + 1));
+      point P01(i, j + 1, 0.1 * std::sin(i + j + 1));
+      point P11(i + 1, j + 1, 0.1 * std::sin(i + j + 2));
+      Entities.push_back(std::make_shared<triangle>(P00, P10, P11));
+      Entities.push_back(std::make_shared<triangle>(P00, P11, P01));
+    }
+  collection Terrain(Entities);
+  Terrain.buildAABBtree();
+
+  // Rigid ring sinking into the terrain
+  ball Ring(1.0, point(8.3, 7.7, 0.8));
+  real depth;
+  vec3 Normal;
+  std::vector<integer> Ids;
+  hit = Terrain.intersection(Ring, depth, Normal, Ids, Point);
+
+  // Compare with all the triangles
+  real reference = -INFTY;
+  integer count = 0;
+  for (integer i = 0; i < Terrain.size(); ++i)
+  {
+    triangle const &Triangle = *dynamic_cast<triangle const *>(Entities[i].get());
+    if (intersection(Triangle, Ring))
+    {
+      ++count;
+      reference = std::max(reference, Ring.radius() - (Triangle.closestPoint(Ring.center()) - Ring.center()).norm());
+    }
+  }
+  std::cout
+      << "Contact: " << hit << "\ttriangles: " << Ids.size() << " (" << count << ")" << std::endl
+      << "Depth: " << depth << " (" << reference << ")" << std::endl
+      << "Normal: " << Normal.transpose() << std::endl
+      << "Point: " << Point.transpose() << std::endl;
+  integer failed = mismatch + (integer(Ids.size()) != count) + (std::abs(depth - reference) > EPSILON);
+
+  // Ring center sunk below the terrain: depth beyond the radius, normal still upwards
+  ball Sunk(1.0, point(8.3, 7.7, -0.3));
+  hit = Terrain.intersection(Sunk, depth, Normal, Ids, Point);
+  std::cout
+      << "Sunk: " << hit << "\tdepth: " << depth << "\tnormal: " << Normal.transpose() << std::endl;
+  if (!hit || depth < Sunk.radius() + 0.2 || Normal.z() < 0.9)
+    ++failed;
+
+  // Steep ridge: center above the roof but behind the other face plane (not sunk)
+  collection Roof;
+  Roof.push_back(std::make_shared<triangle>(point(0.0, -2.0, 0.0), point(0.0, 2.0, 0.0), point(-2.0, -2.0, -2.0)));
+  Roof.push_back(std::make_shared<triangle>(point(0.0, -2.0, 0.0), point(2.0, -2.0, -2.0), point(0.0, 2.0, 0.0)));
+  Roof.buildAABBtree();
+  ball Ridge(1.0, point(-0.2, 0.0, 0.05));
+  hit = Roof.intersection(Ridge, depth, Normal, Ids, Point);
+  std::cout
+      << "Ridge: " << hit << "\tdepth: " << depth << "\tnormal: " << Normal.transpose() << std::endl;
+  if (!hit || depth >= Ridge.radius() || Normal.z() <= 0.0 || Normal.x() >= 0.0)
+    ++failed;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 21: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
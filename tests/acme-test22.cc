@@ -0,0 +1,108 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 22 - TRIANGLE-TRIANGLE INTERSECTION
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 22 - TRIANGLE-TRIANGLE INTERSECTION" << std::endl;
+
+  std::mt19937 generator(22);
+  std::uniform_real_distribution<real> distribution(-1.0, 1.0);
+  integer size = 100000, hits = 0, mismatch = 0;
+  for (integer i = 0; i < size; ++i)
+  {
+    triangle Triangle0(
+        point(distribution(generator), distribution(generator), distribution(generator)),
+        point(distribution(generator), distribution(generator), distribution(generator)),
+        point(distribution(generator), distribution(generator), distribution(generator)));
+    triangle Triangle1(
+        point(distribution(generator), distribution(generator), distribution(generator)),
+        point(distribution(generator), distribution(generator), distribution(generator)),
+        point(distribution(generator), distribution(generator), distribution(generator)));
+
+    // Reference: planes line, line sections and sections overlap
+    segment Reference;
+    bool reference = false;
+    line Line;
+    if (intersection(Triangle0.layingPlane(), Triangle1.layingPlane(), Line))
+    {
+      segment Section0, Section1;
+      if (intersection(Line, Triangle0, Section0) && intersection(Line, Triangle1, Section1))
+        reference = intersection(Section0, Section1, Reference);
+    }
+
+    segment Segment;
+    bool hit = intersection(Triangle0, Triangle1, Segment);
+    bool test = intersection(Triangle0, Triangle1, EPSILON);
+    hits += hit;
+    if (hit != test || hit != reference ||
+        (hit && !((Segment.vertex(0).isApprox(Reference.vertex(0), 1e-8) && Segment.vertex(1).isApprox(Reference.vertex(1), 1e-8)) ||
+                  (Segment.vertex(0).isApprox(Reference.vertex(1), 1e-8) && Segment.vertex(1).isApprox(Reference.vertex(0), 1e-8)))))
+      ++mismatch;
+  }
+
+  // Small tilted triangle within tolerance of the other plane (not coplanar): the
+  // result must not depend on the arguments order
+  triangle Flat(point(0.0, 0.0, 0.0), point(1.0, 0.0, 0.0), point(0.0, 1.0, 0.0));
+  triangle Tilted(point(0.3, 0.3, 0.0), point(0.3 + 1.0e-6, 0.3, 1.0e-11), point(0.3, 0.3 + 1.0e-6, 0.0));
+  segment Segment01, Segment10;
+  bool hit01 = intersection(Flat, Tilted, Segment01, 1.0e-10);
+  bool hit10 = intersection(Tilted, Flat, Segment10, 1.0e-10);
+  bool test01 = intersection(Flat, Tilted, 1.0e-10);
+  bool test10 = intersection(Tilted, Flat, 1.0e-10);
+  std::cout
+      << "Near plane: hits " << hit01 << " " << hit10 << "\ttests " << test01 << " " << test10 << std::endl;
+  integer failed = mismatch;
+  if (hit01 != hit10 || test01 != test10 || hit01 != test01 ||
+      (hit01 && (Segment01.vertex(0).hasNaN() || Segment01.vertex(1).hasNaN())))
+    ++failed;
+
+  std::cout
+      << "Pairs: " << size << "\thits: " << hits << std::endl
+      << "Mismatches: " << mismatch << std::endl
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 22: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 23 - PLUCKER LINE AND SEGMENT KERNELS
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 23 - PLUCKER LINE AND SEGMENT KERNELS" << std::endl;
+
+  // Compare with the triangle record kernels
+  std::mt19937 generator(23);
+  std::uniform_real_distribution<real> distribution(-1.0, 1.0);
+  integer size = 100000, line_hits = 0, segment_hits = 0, mismatch = 0;
+  for (integer i = 0; i < size; ++i)
+  {
+    triangle Triangle(
+        point(distribution(generator), distribution(generator), distribution(generator)),
+        point(distribution(generator), distribution(generator), distribution(generator)),
+        point(distribution(generator), distribution(generator), distribution(generator)));
+    triangleRecord Record(Triangle);
+    point Origin(distribution(generator), distribution(generator), distribution(generator));
+    vec3 Direction(distribution(generator), distribution(generator), distribution(generator));
+
+    point Point, Reference;
+    bool hit = intersection(line(Origin, Direction), Triangle, Point);
+    bool reference = intersection(line(Origin, Direction), Record, Reference);
+    line_hits += hit;
+    if (hit != reference || (hit && !Point.isApprox(Reference, 1e-8)))
+      ++mismatch;
+
+    hit = intersection(segment(Origin, Origin + Direction), Triangle, Point);
+    reference = intersection(segment(Origin, Origin + Direction), Record, Reference);
+    segment_hits += hit;
+    if (hit != reference || (hit && !Point.isApprox(Reference, 1e-8)))
+      ++mismatch;
+  }
+
+  // Shared vertices: a line through each grid vertex hits at least one triangle
+  integer n = 8, cracks = 0;
+  std::vector<triangle> Grid;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point P00(0.1 * i, 0.1 * j, 0.01 * i), P10(0.1 * (i + 1), 0.1 * j, 0.01 * (i + 1));
+      point P01(0.1 * i, 0.1 * (j + 1), 0.01 * i), P11(0.1 * (i + 1), 0.1 * (j + 1), 0.01 * (i + 1));
+      Grid.push_back(triangle(P00, P10, P11));
+      Grid.push_back(triangle(P00, P11, P01));
+    }
+  for (integer i = 1; i < n; ++i)
+    for (integer j = 1; j < n; ++j)
+    {
+      bool hit = false;
+      line Line(point(0.1 * i, 0.1 * j, 1.0), vec3(0.0, 0.0, -1.0));
+      for (size_t k = 0; k < Grid.size() && !hit; ++k)
+        hit = intersection(Line, Grid[k], THROWAWAY_POINT);
+      cracks += !hit;
+    }
+
+  std::cout
+      << "Lines: " << size << "\thits: " << line_hits << std::endl
+      << "Segments: " << size << "\thits: " << segment_hits << std::endl
+      << "Mismatches: " << mismatch << std::endl
+      << "Shared edge cracks: " << cracks << std::endl
+      << std::endl
+      << "TEST 23: Completed" << std::endl;
+
+  // Exit the program
+  return 0;
+}
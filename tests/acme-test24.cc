@@ -0,0 +1,121 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 24 - COLLECTION SELF-INTERSECTION
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 24 - COLLECTION SELF-INTERSECTION" << std::endl;
+
+  // Small random triangles
+  std::mt19937 generator(24);
+  std::uniform_real_distribution<real> position(0.0, 10.0);
+  std::uniform_real_distribution<real> offset(-0.5, 0.5);
+  entity::vecptr Entities;
+  for (integer i = 0; i < 2000; ++i)
+  {
+    point P(position(generator), position(generator), position(generator));
+    point P0(P + vec3(offset(generator), offset(generator), offset(generator)));
+    point P1(P + vec3(offset(generator), offset(generator), offset(generator)));
+    Entities.push_back(std::make_shared<triangle>(P, P0, P1));
+  }
+  collection Soup(Entities);
+  Soup.buildAABBtree();
+
+  // Tree-based all-pairs intersection
+  collection Results;
+  Soup.intersection(Results);
+
+  // Compare with all the pairs
+  integer count = 0, mismatch = 0;
+  for (size_t i = 0; i < Entities.size(); ++i)
+    for (size_t j = i + 1; j < Entities.size(); ++j)
+    {
+      entity::ptr Result(intersection(Entities[i].get(), Entities[j].get()));
+      if (Result->isNone())
+        continue;
+      if (count >= Results.size() || Results[count]->type() != Result->type())
+        ++mismatch;
+      ++count;
+    }
+
+  // Without the collection tree
+  collection Unbuilt(Entities);
+  collection Results_unbuilt;
+  Unbuilt.intersection(Results_unbuilt);
+
+  integer failed = mismatch + (count != Results.size()) + (Results_unbuilt.size() != Results.size());
+
+  // Out of date collection tree (a moved entity, then a new one) against no tree
+  collection Stale(Entities);
+  Stale.push_back(std::make_shared<triangle>(point(0.0, 0.0, 5.0), point(10.0, 0.0, 5.0), point(0.0, 10.0, 5.0)));
+  Stale.buildAABBtree();
+  integer stale_mismatch = 0;
+  for (integer k = 0; k < 2; ++k)
+  {
+    if (k == 0)
+      Stale.modify(Stale.size() - 1)->translate(vec3(0.0, 0.0, 2.0));
+    else
+      Stale.push_back(std::make_shared<triangle>(point(0.0, 5.0, 0.0), point(10.0, 5.0, 0.0), point(0.0, 5.0, 10.0)));
+    entity::vecptr Stale_entities;
+    for (integer i = 0; i < Stale.size(); ++i)
+      Stale_entities.push_back(Stale[i]);
+    collection Fresh(Stale_entities);
+    collection Results_stale, Results_fresh;
+    Stale.intersection(Results_stale);
+    Fresh.intersection(Results_fresh);
+    stale_mismatch += Results_stale.size() != Results_fresh.size();
+  }
+  failed += stale_mismatch;
+
+  std::cout
+      << "Entities: " << Soup.size() << std::endl
+      << "Intersections: " << Results.size() << " (" << count << ")" << std::endl
+      << "Intersections without tree: " << Results_unbuilt.size() << std::endl
+      << "Mismatches: " << mismatch << std::endl
+      << "Out of date tree mismatches: " << stale_mismatch << std::endl
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 24: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 25 - COLLECTION TYPE INDEXES
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 25 - COLLECTION TYPE INDEXES" << std::endl;
+
+  // Mixed collection
+  collection Mixed;
+  for (integer i = 0; i < 10; ++i)
+  {
+    point P(i, 0.0, 0.0);
+    Mixed.push_back(std::make_shared<point>(P));
+    Mixed.push_back(std::make_shared<segment>(P, point(i, 1.0, 0.0)));
+    Mixed.push_back(std::make_shared<triangle>(P, point(i + 1, 0.0, 0.0), point(i, 1.0, 0.0)));
+    if (i % 2 == 0)
+      Mixed.push_back(std::make_shared<ball>(0.5, P));
+    if (i % 5 == 0)
+      Mixed.push_back(std::make_shared<line>(P, vec3(0.0, 0.0, 1.0)));
+  }
+
+  std::map<std::string, integer> Count(Mixed.count());
+  std::cout << "Indexed: " << Mixed.hasIndexes() << std::endl;
+  for (std::map<std::string, integer>::iterator it = Count.begin(); it != Count.end(); ++it)
+    std::cout << it->first << ": " << it->second << std::endl;
+
+  std::vector<integer> Triangles;
+  Mixed.indexes("triangle", Triangles);
+  std::cout << "Triangle indexes:";
+  for (size_t i = 0; i < Triangles.size(); ++i)
+    std::cout << " " << Triangles[i];
+  std::cout << std::endl;
+
+  // Removed entities are erased
+  Mixed.removeLine();
+  Mixed.removeBall();
+  std::cout
+      << "Size after removing lines and balls: " << Mixed.size() << std::endl
+      << "Lines: " << Mixed.countLine() << "\tballs: " << Mixed.countBall()
+      << "\tnon-clampable: " << Mixed.countNonClampable() << std::endl;
+
+  // Replacing an entity keeps the indexes valid
+  Mixed.set(0, std::make_shared<disk>(1.0, point(0.0, 0.0, 0.0), vec3(0.0, 0.0, 1.0)));
+  Mixed.indexes("triangle", Triangles);
+  std::cout
+      << "Indexed: " << Mixed.hasIndexes()
+      << "\tdisks: " << Mixed.countDisk() << "\tpoints: " << Mixed.countPoint()
+      << "\ttriangles: " << Triangles.size() << std::endl;
+  integer disks = Mixed.countDisk(), points = Mixed.countPoint(), triangles = Triangles.size();
+  Mixed.buildIndexes();
+  Mixed.indexes("triangle", Triangles);
+  std::cout
+      << "Rebuilt:\tdisks: " << Mixed.countDisk() << "\tpoints: " << Mixed.countPoint()
+      << "\ttriangles: " << Triangles.size() << std::endl;
+  integer failed = !Mixed.hasIndexes() || disks != Mixed.countDisk() || points != Mixed.countPoint() ||
+                   triangles != integer(Triangles.size());
+
+  // Element access and resize keep the indexes valid
+  integer last = Mixed.size() - 1;
+  Mixed[last]->translate(vec3(1.0, 0.0, 0.0));
+  Mixed.resize(last);
+  integer scanned = 0;
+  for (integer i = 0; i < Mixed.size(); ++i)
+    scanned += Mixed[i]->isTriangle();
+  std::cout
+      << "Resized:\tindexed: " << Mixed.hasIndexes() << "\ttriangles: " << Mixed.countTriangle()
+      << "\tscanned: " << scanned << std::endl;
+  if (!Mixed.hasIndexes() || Mixed.countTriangle() != scanned || scanned != triangles - 1)
+    ++failed;
+
+  // Null entities are stored but not indexed
+  entity::ptr Segment(Mixed[1]);
+  Mixed.push_back(entity::ptr());
+  Mixed.set(1, entity::ptr());
+  integer segments = Mixed.countSegment();
+  Mixed.set(1, Segment);
+  integer restored = Mixed.countSegment();
+  Mixed.buildIndexes();
+  std::cout
+      << "Null entities:\tsize: " << Mixed.size() << "\tsegments: " << segments
+      << "\trestored: " << restored << "\trebuilt: " << Mixed.countSegment() << std::endl;
+  if (!Mixed.hasIndexes() || !Segment->isSegment() || segments != restored - 1 || restored != Mixed.countSegment())
+    ++failed;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 25: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 26 - INDEX-BASED CANDIDATES
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 26 - INDEX-BASED CANDIDATES" << std::endl;
+
+  // Two random triangle soups
+  std::mt19937 generator(26);
+  std::uniform_real_distribution<real> position(0.0, 10.0);
+  std::uniform_real_distribution<real> offset(-0.5, 0.5);
+  entity::vecptr Entities0, Entities1;
+  for (integer i = 0; i < 1000; ++i)
+  {
+    point P(position(generator), position(generator), position(generator));
+    point P0(P + vec3(offset(generator), offset(generator), offset(generator)));
+    point P1(P + vec3(offset(generator), offset(generator), offset(generator)));
+    (i % 2 == 0 ? Entities0 : Entities1).push_back(std::make_shared<triangle>(P, P0, P1));
+  }
+  collection Soup0(Entities0), Soup1(Entities1);
+  Soup0.buildAABBtree();
+  Soup1.buildAABBtree();
+
+  // Pairs of indexes against interleaved shared pointers
+  collection Candidates;
+  aabb::vecpairid Pairs;
+  Soup0.intersection(Soup1, Candidates);
+  Soup0.intersection(Soup1, Pairs);
+  integer mismatch = integer(2 * Pairs.size()) != Candidates.size();
+  for (size_t i = 0; i < Pairs.size() && !mismatch; ++i)
+    mismatch += Candidates[2 * i] != Entities0[Pairs[i].first] ||
+                Candidates[2 * i + 1] != Entities1[Pairs[i].second];
+
+  // Indexes against shared pointers for a box
+  aabb Box(point(2.0, 2.0, 2.0), point(5.0, 5.0, 5.0));
+  aabb::vecid Ids;
+  Soup0.intersection(Box, Ids);
+  Soup0.intersection(std::make_shared<aabb>(Box), Candidates);
+  mismatch += integer(Ids.size()) != Candidates.size();
+  for (size_t i = 0; i < Ids.size(); ++i)
+  {
+    bool found = false;
+    for (integer j = 0; j < Candidates.size() && !found; ++j)
+      found = Candidates[j] == Entities0[Ids[i]];
+    mismatch += !found;
+  }
+
+  // Unique indexes against an external tree
+  aabb::vecid Tree_ids;
+  Soup0.intersection(Soup1.ptrAABBtree(), Tree_ids);
+  std::vector<integer> Firsts;
+  for (size_t i = 0; i < Pairs.size(); ++i)
+    Firsts.push_back(Pairs[i].first);
+  std::sort(Firsts.begin(), Firsts.end());
+  Firsts.erase(std::unique(Firsts.begin(), Firsts.end()), Firsts.end());
+  mismatch += Firsts != Tree_ids;
+
+  std::cout
+      << "Candidate pairs: " << Pairs.size() << std::endl
+      << "Box candidates: " << Ids.size() << std::endl
+      << "Tree candidates: " << Tree_ids.size() << std::endl
+      << "Mismatches: " << mismatch << std::endl
+      << "Failed checks: " << mismatch << std::endl
+      << std::endl
+      << "TEST 26: Completed" << std::endl;
+
+  // Exit the program
+  return mismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 27 - INSTANCED SCENE
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_scene.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Flatten a scene into a world space collection
+collection
+flatten(scene const &Scene)
+{
+  collection World;
+  for (integer i = 0; i < Scene.size(); ++i)
+  {
+    collection const &Geometry = *Scene.instanceGeometry(i);
+    for (integer j = 0; j < Geometry.size(); ++j)
+    {
+      triangle Triangle(*dynamic_cast<triangle const *>(Geometry[j].get()));
+      Triangle.transform(Scene.instanceTransform(i));
+      World.push_back(std::make_shared<triangle>(Triangle));
+    }
+  }
+  World.buildAABBtree();
+  return World;
+}
+
+// Compare scene and flattened collection ray and segment queries
+integer
+compare(scene const &Scene, collection const &World, integer size, integer &hits, integer &instanced)
+{
+  std::mt19937 generator(27);
+  std::uniform_real_distribution<real> distribution(0.0, 16.0);
+  integer mismatch = 0;
+  context scratch;
+  hits = 0;
+  instanced = 0;
+  for (integer i = 0; i < size; ++i)
+  {
+    point Origin(distribution(generator), distribution(generator), 5.0);
+    vec3 Direction(0.1 * distribution(generator) - 0.8, 0.1 * distribution(generator) - 0.8, -1.0);
+    integer instance, id, world_id;
+    point Point, World_point;
+    bool hit = Scene.intersection(ray(Origin, Direction), instance, id, Point);
+    bool world_hit = World.intersection(ray(Origin, Direction), world_id, World_point);
+    hits += hit;
+    instanced += hit && instance > 0;
+    if (hit != world_hit || (hit && !Point.isApprox(World_point, 1e-8)))
+      ++mismatch;
+    integer scratch_instance, scratch_id;
+    point Scratch_point;
+    bool scratch_hit = Scene.intersection(ray(Origin, Direction), scratch_instance, scratch_id, Scratch_point, scratch);
+    if (scratch_hit != hit || (hit && (scratch_instance != instance || scratch_id != id || !Scratch_point.isApprox(Point))))
+      ++mismatch;
+    hit = Scene.intersection(segment(Origin, Origin + 5.5 * Direction), instance, id, Point);
+    world_hit = World.intersection(segment(Origin, Origin + 5.5 * Direction), world_id, World_point);
+    if (hit != world_hit || (hit && !Point.isApprox(World_point, 1e-8)))
+      ++mismatch;
+    scratch_hit = Scene.intersection(segment(Origin, Origin + 5.5 * Direction), scratch_instance, scratch_id, Scratch_point, scratch);
+    if (scratch_hit != hit || (hit && (scratch_instance != instance || scratch_id != id || !Scratch_point.isApprox(Point))))
+      ++mismatch;
+  }
+  return mismatch;
+}
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 27 - INSTANCED SCENE" << std::endl;
+
+  // Static terrain
+  integer n = 16;
+  std::shared_ptr<collection> Terrain(std::make_shared<collection>());
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point P00(i, j, 0.1 * std::sin(i + j));
+      point P10(i + 1, j, 0.1 * std::sin(i + j + 1));
+      point P01(i, j + 1, 0.1 * std::sin(i + j + 1));
+      point P11(i + 1, j + 1, 0.1 * std::sin(i + j + 2));
+      Terrain->push_back(std::make_shared<triangle>(P00, P10, P11));
+      Terrain->push_back(std::make_shared<triangle>(P00, P11, P01));
+    }
+  Terrain->buildAABBtree();
+
+  // Shared cone geometry (pyramid)
+  std::shared_ptr<collection> Cone(std::make_shared<collection>());
+  point Apex(0.0, 0.0, 1.0);
+  point Base[4] = {point(-0.5, -0.5, 0.0), point(0.5, -0.5, 0.0), point(0.5, 0.5, 0.0), point(-0.5, 0.5, 0.0)};
+  for (integer k = 0; k < 4; ++k)
+    Cone->push_back(std::make_shared<triangle>(Base[k], Base[(k + 1) % 4], Apex));
+  Cone->buildAABBtree();
+
+  scene Scene;
+  Scene.push_back(Terrain);
+  for (integer k = 0; k < 20; ++k)
+  {
+    affine Transform(translate(vec3(0.75 * k + 1.0, 0.5 * k + 2.0, 0.3)) * angleaxis(0.3 * k, vec3::UnitZ()) * scale(vec3(1.0, 1.0, 1.0 + 0.1 * k)));
+    Scene.push_back(Cone, Transform);
+  }
+  Scene.buildAABBtree();
+
+  integer hits, instanced;
+  integer mismatch = compare(Scene, flatten(Scene), 5000, hits, instanced);
+  integer failed = mismatch;
+  std::cout
+      << "Instances: " << Scene.size() << std::endl
+      << "Hits: " << hits << "\tinstanced: " << instanced << "\tmismatches: " << mismatch << std::endl;
+
+  // Move some instances: one transformation each plus the top-level tree refit
+  for (integer k = 1; k < Scene.size(); k += 2)
+    Scene.instanceTransform(k, translate(vec3(0.0, 1.0, 0.0)) * Scene.instanceTransform(k));
+  std::cout << "Updated: " << Scene.isUpdated() << std::endl;
+  Scene.buildAABBtree();
+  mismatch = compare(Scene, flatten(Scene), 5000, hits, instanced);
+  failed += mismatch;
+  std::cout
+      << "Updated: " << Scene.isUpdated() << std::endl
+      << "Hits: " << hits << "\tinstanced: " << instanced << "\tmismatches: " << mismatch << std::endl;
+
+  // Move and add instances: the top-level tree is fully rebuilt
+  Scene.instanceTransform(2, translate(vec3(4.0, -1.0, 0.0)) * Scene.instanceTransform(2));
+  Scene.push_back(Cone, affine(translate(vec3(12.0, 3.0, 0.2))));
+  Scene.buildAABBtree();
+  mismatch = compare(Scene, flatten(Scene), 5000, hits, instanced);
+  failed += mismatch;
+  std::cout
+      << "Added: " << Scene.size() << "\tinstances" << std::endl
+      << "Hits: " << hits << "\tinstanced: " << instanced << "\tmismatches: " << mismatch << std::endl;
+
+  // Box candidates
+  aabb::vecpairid Candidates;
+  Scene.intersection(aabb(point(3.0, 3.0, -1.0), point(6.0, 6.0, 2.0)), Candidates);
+  integer cones = 0;
+  for (size_t i = 0; i < Candidates.size(); ++i)
+    cones += Candidates[i].first > 0;
+  std::cout
+      << "Box candidates: " << Candidates.size() << "\tcone triangles: " << cones << std::endl
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 27: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 28 - SWEPT BALL AND DISK
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 28 - SWEPT BALL AND DISK" << std::endl;
+
+  // Flat road with a thin vertical kerb across it at x = 10
+  collection Road;
+  integer n = 20;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < 4; ++j)
+    {
+      Road.push_back(std::make_shared<triangle>(point(i, j, 0.0), point(i + 1, j, 0.0), point(i + 1, j + 1, 0.0)));
+      Road.push_back(std::make_shared<triangle>(point(i, j, 0.0), point(i + 1, j + 1, 0.0), point(i, j + 1, 0.0)));
+    }
+  Road.push_back(std::make_shared<triangle>(point(10.0, 0.0, 0.0), point(10.0, 4.0, 0.0), point(10.0, 4.0, 0.15)));
+  Road.push_back(std::make_shared<triangle>(point(10.0, 0.0, 0.0), point(10.0, 4.0, 0.15), point(10.0, 0.0, 0.15)));
+  Road.buildAABBtree();
+
+  // Ball jumping over the kerb within one step: static queries miss it
+  ball Ball(0.3, point(9.5, 2.0, 0.35));
+  vec3 Step(1.0, 0.0, 0.0);
+  real depth;
+  vec3 Normal;
+  std::vector<integer> Ids;
+  ball Ball_end(Ball.radius(), point(Ball.center() + Step));
+  bool static_hit = Road.intersection(Ball, depth, Normal, Ids) || Road.intersection(Ball_end, depth, Normal, Ids);
+
+  real time;
+  integer id;
+  point Point;
+  bool swept_hit = Road.intersection(Ball, Step, time, id, Normal, Point);
+
+  // Reference by dense sampling of the static query
+  real reference = QUIET_NAN;
+  integer samples = 100000;
+  for (integer k = 0; k <= samples; ++k)
+  {
+    ball Ball_k(Ball.radius(), point(Ball.center() + (real(k) / samples) * Step));
+    if (Road.intersection(Ball_k, depth, Normal, Ids))
+    {
+      reference = real(k) / samples;
+      break;
+    }
+  }
+  std::cout
+      << "Ball static hit: " << static_hit << "\tswept hit: " << swept_hit << std::endl
+      << "Ball time: " << time << "\treference: " << reference << std::endl
+      << "Ball id: " << id << "\tpoint: " << Point.transpose() << "\tnormal: " << Normal.transpose() << std::endl
+      << "Ball time check: " << (std::abs(time - reference) <= 1.0 / samples) << std::endl;
+
+  // Random sweeps against the sampled reference
+  std::mt19937 generator(28);
+  std::uniform_real_distribution<real> distribution(-1.0, 1.0);
+  integer mismatch = 0, hits = 0;
+  for (integer i = 0; i < 200; ++i)
+  {
+    ball Ball_i(0.2 + 0.1 * distribution(generator), point(10.0 + distribution(generator), 2.0 + distribution(generator), 0.3 + 0.2 * distribution(generator)));
+    vec3 Step_i(2.0 * distribution(generator), distribution(generator), 0.3 * distribution(generator));
+    bool hit = Road.intersection(Ball_i, Step_i, time, id, Normal, Point);
+    bool reference_hit = false;
+    for (integer k = 0; k <= 2000 && !reference_hit; ++k)
+    {
+      ball Ball_k(Ball_i.radius(), point(Ball_i.center() + (real(k) / 2000) * Step_i));
+      if (Road.intersection(Ball_k, depth, Normal, Ids))
+      {
+        reference_hit = true;
+        reference = real(k) / 2000;
+      }
+    }
+    hits += hit;
+    if (hit != reference_hit || (hit && (time > reference + 1e-10 || time < reference - 1.0 / 2000)))
+      ++mismatch;
+  }
+  std::cout
+      << "Random ball sweeps hits: " << hits << "\tmismatches: " << mismatch << std::endl;
+
+  // Rolling tire (vertical disk) hitting the kerb within one step
+  disk Tire(0.3, point(9.5, 2.0, 0.35), vec3(0.0, 1.0, 0.0));
+  vec3 Rotation(0.0, Step.norm() / Tire.radius(), 0.0);
+  real resolution = 1.0e-3;
+  swept_hit = Road.intersection(Tire, Step, Rotation, resolution, time, id, Normal, Point);
+  std::vector<segment> Segments;
+  std::vector<vec3> Normals;
+  reference = QUIET_NAN;
+  for (integer k = 0; k <= samples; ++k)
+  {
+    disk Tire_k(Tire.radius(), point(Tire.center() + (real(k) / samples) * Step), Tire.normal());
+    if (Road.intersection(Tire_k, Segments, Ids, Normals))
+    {
+      reference = real(k) / samples;
+      break;
+    }
+  }
+  std::cout
+      << "Disk swept hit: " << swept_hit << std::endl
+      << "Disk time: " << time << "\treference: " << reference << std::endl
+      << "Disk id: " << id << "\tpoint: " << Point.transpose() << "\tnormal: " << Normal.transpose() << std::endl
+      << "Disk time check: " << (std::abs(time - reference) <= resolution / Step.norm() + 1.0 / samples) << std::endl
+      << std::endl
+      << "TEST 28: Completed" << std::endl;
+
+  // Exit the program
+  return 0;
+}
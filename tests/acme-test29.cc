@@ -0,0 +1,155 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 29 - THREAD SAFETY
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Wheel queries result
+struct wheel
+{
+  integer ray_id, segment_id, contacts, penetrations;
+  point ray_point, segment_point;
+  real depth;
+};
+
+// Run the four wheel queries (ray, segment, disk and ball) at a given position
+void
+query(collection const &Terrain, point const &Hub, context &Context, wheel &Wheel)
+{
+  std::vector<segment> Segments;
+  std::vector<integer> Ids;
+  std::vector<vec3> Normals;
+  vec3 Normal;
+  point Point;
+  Terrain.intersection(ray(Hub, vec3(0.0, 0.0, -1.0)), Wheel.ray_id, Wheel.ray_point, Context);
+  Terrain.intersection(segment(Hub, Hub - vec3(0.0, 0.0, 1.0)), Wheel.segment_id, Wheel.segment_point, Context);
+  Terrain.intersection(disk(0.3, Hub, vec3(0.0, 1.0, 0.0)), Segments, Ids, Normals, Context);
+  Wheel.contacts = Segments.size();
+  Terrain.intersection(ball(0.3, Hub), Wheel.depth, Normal, Ids, Point, Context);
+  Wheel.penetrations = Ids.size();
+}
+
+// Compare two wheel queries results
+bool
+same(wheel const &Wheel0, wheel const &Wheel1)
+{
+  return Wheel0.ray_id == Wheel1.ray_id && Wheel0.segment_id == Wheel1.segment_id &&
+         Wheel0.contacts == Wheel1.contacts && Wheel0.penetrations == Wheel1.penetrations &&
+         Wheel0.ray_point.isApprox(Wheel1.ray_point) && Wheel0.segment_point.isApprox(Wheel1.segment_point) &&
+         Wheel0.depth == Wheel1.depth;
+}
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 29 - THREAD SAFETY" << std::endl;
+
+  // Shared read-only terrain
+  integer n = 32;
+  collection Terrain;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point P00(i, j, 0.1 * std::sin(i + j));
+      point P10(i + 1, j, 0.1 * std::sin(i + j + 1));
+      point P01(i, j + 1, 0.1 * std::sin(i + j + 1));
+      point P11(i + 1, j + 1, 0.1 * std::sin(i + j + 2));
+      Terrain.push_back(std::make_shared<triangle>(P00, P10, P11));
+      Terrain.push_back(std::make_shared<triangle>(P00, P11, P01));
+    }
+  Terrain.buildAABBtree();
+
+  // Wheel hub trajectories and single thread reference results
+  integer wheels = 4, steps = 2000;
+  std::vector<std::vector<point>> Hubs(wheels);
+  std::vector<std::vector<wheel>> References(wheels);
+  context Context;
+  for (integer w = 0; w < wheels; ++w)
+  {
+    Hubs[w].resize(steps);
+    References[w].resize(steps);
+    for (integer k = 0; k < steps; ++k)
+    {
+      real s = 1.0 + 29.0 * k / steps;
+      Hubs[w][k] = point(s, 1.0 + 7.0 * w + 0.5 * std::sin(s), 0.32);
+      query(Terrain, Hubs[w][k], Context, References[w][k]);
+    }
+  }
+
+  // One thread per wheel, each one with its own context
+  std::vector<integer> Mismatches(wheels, 0);
+  std::vector<std::thread> Threads;
+  for (integer w = 0; w < wheels; ++w)
+    Threads.push_back(std::thread([&, w]() {
+      context Context_w;
+      wheel Wheel;
+      for (integer r = 0; r < 10; ++r)
+        for (integer k = 0; k < steps; ++k)
+        {
+          query(Terrain, Hubs[w][k], Context_w, Wheel);
+          Mismatches[w] += !same(Wheel, References[w][k]);
+        }
+    }));
+  for (integer w = 0; w < wheels; ++w)
+    Threads[w].join();
+
+  // Queries with defaulted (thread-local throwaway) outputs in parallel
+  std::vector<integer> Hits(wheels, 0);
+  Threads.clear();
+  for (integer w = 0; w < wheels; ++w)
+    Threads.push_back(std::thread([&, w]() {
+      integer id;
+      for (integer k = 0; k < steps; ++k)
+        Hits[w] += Terrain.intersection(ray(Hubs[w][k], vec3(0.0, 0.0, -1.0)), id) && id == References[w][k].ray_id;
+    }));
+  for (integer w = 0; w < wheels; ++w)
+    Threads[w].join();
+
+  for (integer w = 0; w < wheels; ++w)
+    std::cout
+        << "Wheel " << w << "\tmismatches: " << Mismatches[w]
+        << "\tdefaulted outputs hits: " << Hits[w] << "/" << steps << std::endl;
+  std::cout
+      << std::endl
+      << "TEST 29: Completed" << std::endl;
+
+  // Exit the program
+  return 0;
+}
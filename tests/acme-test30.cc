@@ -0,0 +1,180 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 30 - ALLOCATION-FREE QUERIES
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Heap allocations counter (counting is enabled only inside the checked queries)
+static bool counting = false;
+static integer allocations = 0;
+
+void *
+operator new(std::size_t size)
+{
+  if (counting)
+    ++allocations;
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+  {
+#ifdef ACME_NO_EXCEPTIONS
+    std::abort();
+#else
+    throw std::bad_alloc();
+#endif
+  }
+  return ptr;
+}
+
+void *
+operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete[](void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 30 - ALLOCATION-FREE QUERIES" << std::endl;
+
+  // Terrain with a kerb
+  integer n = 32;
+  collection Terrain;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < 4; ++j)
+    {
+      point P00(i, j, 0.1 * std::sin(i + j));
+      point P10(i + 1, j, 0.1 * std::sin(i + j + 1));
+      point P01(i, j + 1, 0.1 * std::sin(i + j + 1));
+      point P11(i + 1, j + 1, 0.1 * std::sin(i + j + 2));
+      Terrain.push_back(std::make_shared<triangle>(P00, P10, P11));
+      Terrain.push_back(std::make_shared<triangle>(P00, P11, P01));
+    }
+  Terrain.push_back(std::make_shared<triangle>(point(16.0, 0.0, 0.0), point(16.0, 4.0, 0.0), point(16.0, 4.0, 0.25)));
+  Terrain.push_back(std::make_shared<triangle>(point(16.0, 0.0, 0.0), point(16.0, 4.0, 0.25), point(16.0, 0.0, 0.25)));
+  Terrain.buildAABBtree();
+
+  // External boxes and tree for the candidate queries
+  aabb::vecptr Boxes;
+  for (integer i = 0; i < 4; ++i)
+    Boxes.push_back(std::make_shared<aabb>(point(4.0 * i, 1.0, -1.0), point(4.0 * i + 1.0, 2.0, 1.0), i, 0));
+  AABBtree::ptr Tree(std::make_shared<AABBtree>());
+  Tree->build(Boxes);
+
+  // Caller owned context and outputs
+  context Context;
+  Context.reserve(256);
+  std::vector<segment> Segments;
+  std::vector<integer> Ids;
+  std::vector<vec3> Normals;
+  aabb::vecid Candidates;
+  integer id, queries = 0, hits = 0;
+  real depth, time;
+  vec3 Normal;
+  point Point;
+
+  // Run the wheel queries along a trajectory (warm-up pass, then counted passes)
+  integer steps = 500;
+  for (integer pass = 0; pass < 3; ++pass)
+  {
+    counting = pass > 0;
+    for (integer k = 0; k < steps; ++k)
+    {
+      point Hub(1.0 + 30.0 * k / steps, 2.0 + 0.5 * std::sin(0.1 * k), 0.33);
+      hits += Terrain.intersection(ray(Hub, vec3(0.0, 0.0, -1.0)), id, Point, Context);
+      hits += Terrain.intersection(segment(Hub, Hub - vec3(0.0, 0.0, 1.0)), id, Point, Context);
+      hits += Terrain.intersection(disk(0.3, Hub, vec3(0.0, 1.0, 0.0)), Segments, Ids, Normals, Context);
+      hits += Terrain.intersection(ball(0.3, Hub), depth, Normal, Ids, Point, Context);
+      hits += Terrain.intersection(ball(0.3, Hub), vec3(0.1, 0.0, 0.0), time, id, Normal, Point, Context);
+      hits += Terrain.intersection(disk(0.3, Hub, vec3(0.0, 1.0, 0.0)), vec3(0.1, 0.0, 0.0), vec3(0.0, 0.33, 0.0), 1.0e-3, time, id, Normal, Point, Context);
+      hits += Terrain.intersection(Boxes, Candidates);
+      hits += Terrain.intersection(Tree, Candidates, Context);
+      queries += 8;
+    }
+  }
+  counting = false;
+  integer steady = allocations;
+
+  // Same queries through the legacy overloads (local scratch buffers)
+  allocations = 0;
+  counting = true;
+  for (integer k = 0; k < steps; ++k)
+  {
+    point Hub(1.0 + 30.0 * k / steps, 2.0 + 0.5 * std::sin(0.1 * k), 0.33);
+    Terrain.intersection(ray(Hub, vec3(0.0, 0.0, -1.0)), id, Point);
+    Terrain.intersection(ball(0.3, Hub), depth, Normal, Ids, Point);
+  }
+  counting = false;
+
+  std::cout
+      << "Queries: " << queries << "\thits: " << hits << std::endl
+      << "Steady state allocations (context): " << steady << std::endl
+      << "Allocations without context: " << (allocations > 0 ? "yes" : "no") << std::endl
+      << "Allocation check: " << (steady == 0 ? "passed" : "FAILED") << std::endl
+      << std::endl
+      << "TEST 30: Completed" << std::endl;
+
+  // Exit the program
+  return steady == 0 ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 31 - QUERY BUDGETS
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 31 - QUERY BUDGETS" << std::endl;
+
+  // Terrain with a badly-behaved region: a pile of overlapping triangles
+  integer n = 32;
+  collection Terrain;
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      Terrain.push_back(std::make_shared<triangle>(point(i, j, 0.0), point(i + 1, j, 0.0), point(i + 1, j + 1, 0.0)));
+      Terrain.push_back(std::make_shared<triangle>(point(i, j, 0.0), point(i + 1, j + 1, 0.0), point(i, j + 1, 0.0)));
+    }
+  for (integer k = 0; k < 20000; ++k)
+    Terrain.push_back(std::make_shared<triangle>(point(10.0 + 1.0e-5 * k, 10.0, 1.0e-6 * k), point(12.0 + 1.0e-5 * k, 10.0, 1.0e-6 * k), point(10.0 + 1.0e-5 * k, 12.0, 1.0e-6 * k)));
+  Terrain.buildAABBtree();
+
+  context Context;
+  integer id;
+  point Point, Nearest;
+  real depth;
+  vec3 Normal;
+  std::vector<integer> Ids;
+  ray Ray(point(10.5, 10.5, 1.0), vec3(0.0, 0.0, -1.0));
+  ball Ball(0.3, point(10.5, 10.5, 0.0));
+
+  // Unlimited queries
+  bool hit = Terrain.intersection(Ray, id, Nearest, Context);
+  std::cout
+      << "Unlimited ray:\thit " << hit << "\tpoint " << Nearest.transpose()
+      << "\tnodes " << Context.nodes() << "\tprimitives " << Context.primitives()
+      << "\texhausted " << Context.isExhausted() << std::endl;
+  Terrain.intersection(Ball, depth, Normal, Ids, Point, Context);
+  size_t contacts = Ids.size();
+  std::cout
+      << "Unlimited ball:\tcontacts " << contacts << "\tnodes " << Context.nodes()
+      << "\tprimitives " << Context.primitives() << "\texhausted " << Context.isExhausted() << std::endl;
+
+  // Primitives budget: the ray tests the nearest candidates first
+  Context.budget(0, 16);
+  point Partial;
+  hit = Terrain.intersection(Ray, id, Partial, Context);
+  std::cout
+      << "Budgeted ray:\thit " << hit << "\tpoint " << Partial.transpose()
+      << "\tprimitives " << Context.primitives() << "\texhausted " << Context.isExhausted()
+      << "\tsame point " << Partial.isApprox(Nearest) << std::endl;
+  Terrain.intersection(Ball, depth, Normal, Ids, Point, Context);
+  std::cout
+      << "Budgeted ball:\tcontacts " << Ids.size() << "/" << contacts << "\tprimitives " << Context.primitives()
+      << "\texhausted " << Context.isExhausted() << std::endl;
+
+  // Nodes budget
+  Context.budget(1024, 0);
+  Terrain.intersection(Ball, depth, Normal, Ids, Point, Context);
+  std::cout
+      << "Node budget:\tcontacts " << Ids.size() << "/" << contacts << "\tnodes " << Context.nodes()
+      << "\texhausted " << Context.isExhausted() << std::endl;
+
+  // Deadline already passed: nothing is tested
+  Context.unlimited();
+  Context.deadline(context::clock::now());
+  hit = Terrain.intersection(Ray, id, Point, Context);
+  std::cout
+      << "Past deadline:\thit " << hit << "\tprimitives " << Context.primitives()
+      << "\texhausted " << Context.isExhausted() << std::endl;
+
+  // Short deadline on the pile of triangles
+  Context.unlimited();
+  Context.deadline(1.0e-4);
+  context::timepoint start = context::clock::now();
+  Terrain.intersection(Ball, depth, Normal, Ids, Point, Context);
+  real elapsed = std::chrono::duration<real>(context::clock::now() - start).count();
+  std::cout
+      << "Short deadline:\tpartial " << (Context.isExhausted() ? Ids.size() < contacts : Ids.size() == contacts)
+      << "\tbounded " << (elapsed < 1.0e-2) << std::endl;
+
+  // Budget removed
+  Context.unlimited();
+  Terrain.intersection(Ball, depth, Normal, Ids, Point, Context);
+  std::cout
+      << "Unlimited ball:\tcontacts " << Ids.size() << "\texhausted " << Context.isExhausted() << std::endl
+      << std::endl
+      << "TEST 31: Completed" << std::endl;
+
+  // Exit the program
+  return 0;
+}
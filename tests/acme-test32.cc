@@ -0,0 +1,113 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 32 - EXCEPTION-FREE MODE
+
+#include <iostream>
+#include <string>
+
+#include "acme.hh"
+#include "acme_intersection.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 32 - EXCEPTION-FREE MODE" << std::endl;
+
+#ifdef ACME_NO_EXCEPTIONS
+  std::cout << "Mode: exception-free (ACME_NO_EXCEPTIONS)" << std::endl;
+#else
+  std::cout << "Mode: exceptions" << std::endl;
+#endif
+  triangle Triangle(point(0.0, 0.0, 0.0), point(1.0, 0.0, 0.0), point(0.0, 1.0, 0.0));
+  std::cout << "triangle::vertex() noexcept: " << noexcept(Triangle.vertex(0)) << std::endl;
+
+  // Status starts clean
+  clearStatus();
+  integer failed = 0;
+  if (lastStatus() != STATUS_OK || std::string(lastError()) != "")
+  {
+    std::cout << "Status not clean at start" << std::endl;
+    ++failed;
+  }
+
+  // Unsupported intersection pair
+  disk Disk0(1.0, point(0.0, 0.0, 0.0), vec3(0.0, 0.0, 1.0));
+  disk Disk1(1.0, point(0.5, 0.0, 0.0), vec3(0.0, 1.0, 0.0));
+  none None;
+  bool collide = true;
+#ifdef ACME_NO_EXCEPTIONS
+  collide = intersection(Disk0, Disk1, None);
+  std::cout << "Unsupported pair: status " << lastStatus() << ", message \"" << lastError() << "\"" << std::endl;
+  if (collide || lastStatus() != STATUS_ERROR)
+    ++failed;
+#else
+  try
+  {
+    collide = intersection(Disk0, Disk1, None);
+  }
+  catch (std::runtime_error const &error)
+  {
+    collide = false;
+    std::cout << "Unsupported pair: exception caught" << std::endl;
+  }
+  if (collide || lastStatus() != STATUS_OK)
+    ++failed;
+#endif
+
+  // Reset and check that supported queries leave the status untouched
+  clearStatus();
+  ray Ray(point(0.25, 0.25, 1.0), vec3(0.0, 0.0, -1.0));
+  point Point;
+  collide = intersection(Ray, Triangle, Point);
+  std::cout << "Supported pair: collide " << collide << ", status " << lastStatus() << std::endl;
+  if (!collide || lastStatus() != STATUS_OK)
+    ++failed;
+
+  // Entity dispatcher
+  entity *Entity = intersection(&Ray, &Triangle);
+  std::cout << "Dispatcher result type: " << Entity->type() << std::endl;
+  if (!Entity->isPoint() || lastStatus() != STATUS_OK)
+    ++failed;
+  delete Entity;
+
+  // Hot-path accessors
+  real sum = 0.0;
+  for (size_t i = 0; i < 3; ++i)
+    sum += Triangle.vertex(i).norm() + Triangle[i].norm();
+  std::cout << "Vertex accessors sum: " << sum << std::endl;
+
+  std::cout << "Failed checks: " << failed << std::endl;
+  std::cout << std::endl
+            << "TEST 32: Completed" << std::endl;
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 33 - MEMORY RESOURCES
+
+#include <iostream>
+#include <vector>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_memory.hh"
+#include "acme_utils.hh"
+
+using namespace acme;
+
+// Upstream memory resource counting the chunks requested by the arena
+class countingResource : public memoryResource
+{
+public:
+  integer allocations = 0;
+  integer deallocations = 0;
+
+  void *allocate(size_t bytes, size_t alignment) override
+  {
+    ++allocations;
+    return newDeleteResource()->allocate(bytes, alignment);
+  }
+
+  void deallocate(void *pointer, size_t bytes, size_t alignment) override
+  {
+    ++deallocations;
+    newDeleteResource()->deallocate(pointer, bytes, alignment);
+  }
+};
+
+// Fill a terrain collection
+void
+fill(collection &terrain, integer n, bool emplace)
+{
+  for (integer i = 0; i < n; ++i)
+    for (integer j = 0; j < n; ++j)
+    {
+      point p0(i, j, 0.1 * ((i + j) % 3)), p1(i + 1, j, 0.0), p2(i + 1, j + 1, 0.1), p3(i, j + 1, 0.0);
+      if (emplace)
+      {
+        terrain.emplace_back<triangle>(p0, p1, p2);
+        terrain.emplace_back<triangle>(p0, p2, p3);
+      }
+      else
+      {
+        terrain.push_back(std::make_shared<triangle>(p0, p1, p2));
+        terrain.push_back(std::make_shared<triangle>(p0, p2, p3));
+      }
+    }
+}
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 33 - MEMORY RESOURCES" << std::endl;
+
+  integer n = 64;
+  integer failed = 0;
+
+  // Reference terrain on the global heap
+  collection Reference;
+  fill(Reference, n, false);
+  Reference.buildAABBtree();
+
+  // Terrain built in an arena on a pre-reserved block
+  countingResource Upstream;
+  std::vector<char> Block(1 << 20);
+  monotonicResource Arena(Block.data(), Block.size(), &Upstream);
+  {
+    collection Terrain(&Arena);
+    fill(Terrain, n, true);
+    Terrain.buildAABBtree();
+    std::cout
+        << "Arena:\tused " << Arena.used() << " bytes\tcapacity " << Arena.capacity()
+        << " bytes\tupstream chunks " << Upstream.allocations << std::endl;
+    if (Terrain.ptrAABBtree()->resource() != &Arena)
+      ++failed;
+
+    // Same query results as the heap terrain (results in a pool)
+    poolResource Pool;
+    allocator<integer> PoolAllocator(&Pool);
+    context Context;
+    integer mismatches = 0;
+    for (integer k = 0; k < 256; ++k)
+    {
+      real x = 0.5 + (k * 37 % 631) / 10.0;
+      real y = 0.5 + (k * 91 % 631) / 10.0;
+      ray Ray(point(x, y, 5.0), vec3(0.0, 0.0, -1.0));
+      integer id0, id1;
+      point Point0, Point1;
+      bool hit0 = Reference.intersection(Ray, id0, Point0, Context);
+      bool hit1 = Terrain.intersection(Ray, id1, Point1, Context);
+      std::vector<integer, allocator<integer>> Hits(PoolAllocator);
+      if (hit1)
+        Hits.push_back(id1);
+      if (hit0 != hit1 || (hit0 && (id0 != Hits.front() || !Point0.isApprox(Point1))))
+        ++mismatches;
+    }
+    std::cout
+        << "Ray queries:\tmismatches " << mismatches << "\tpool in use " << Pool.used()
+        << " bytes\tpool capacity " << Pool.capacity() << " bytes" << std::endl;
+    if (mismatches != 0 || Pool.used() != 0)
+      ++failed;
+  }
+
+  // Teardown: the whole terrain is given back at once
+  Arena.release();
+  std::cout
+      << "Released:\tused " << Arena.used() << " bytes\tcapacity " << Arena.capacity()
+      << " bytes\tupstream chunks freed " << Upstream.deallocations << "/" << Upstream.allocations << std::endl;
+  if (Arena.used() != 0 || Upstream.deallocations != Upstream.allocations)
+    ++failed;
+
+  // Over-aligned blocks from the global heap and through a pool
+  poolResource Pool(&Upstream);
+  integer misaligned = 0;
+  for (size_t alignment = 8; alignment <= 256; alignment *= 2)
+  {
+    void *pointer = newDeleteResource()->allocate(24, alignment);
+    misaligned += reinterpret_cast<size_t>(pointer) % alignment != 0;
+    newDeleteResource()->deallocate(pointer, 24, alignment);
+    pointer = Pool.allocate(4096, alignment);
+    misaligned += reinterpret_cast<size_t>(pointer) % alignment != 0;
+    Pool.deallocate(pointer, 4096, alignment);
+  }
+  std::cout << "Over-aligned:	misaligned " << misaligned << std::endl;
+  if (misaligned != 0)
+    ++failed;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 33: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
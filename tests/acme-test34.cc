@@ -0,0 +1,150 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+// TEST 34 - ROAD AND WORKLOAD GENERATORS
+
+#include <iostream>
+#include <vector>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_utils.hh"
+#include "acme_workload.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 34 - ROAD AND WORKLOAD GENERATORS" << std::endl;
+
+  integer failed = 0;
+
+  // Road with potholes, kerbs and one bridge
+  road Road(42, 400.0, 7.0, 0.5);
+  Road.features(20, 1);
+  collection Terrain;
+  Road.generate(Terrain);
+  std::cout
+      << "Road:\ttriangles " << Terrain.size() << "\tpredicted " << Road.size()
+      << "\tresolution " << Road.resolution() << std::endl;
+  if (integer(Terrain.size()) != Road.size())
+    ++failed;
+
+  // Same seed, same mesh
+  collection Again;
+  road(Road).generate(Again);
+  integer different = Again.size() != Terrain.size();
+  for (integer i = 0; !different && i < Terrain.size(); ++i)
+  {
+    triangle const &T0 = *std::dynamic_pointer_cast<triangle>(Terrain[i]);
+    triangle const &T1 = *std::dynamic_pointer_cast<triangle>(Again[i]);
+    for (integer k = 0; k < 3; ++k)
+      different += T0[k] != T1[k];
+  }
+  road Other(43, 400.0, 7.0, 0.5);
+  Other.features(20, 1);
+  std::cout
+      << "Seeds:\tsame seed differences " << different
+      << "\tother seed height change " << (Other.height(100.0, Other.centerline(100.0)) != Road.height(100.0, Road.centerline(100.0))) << std::endl;
+  if (different != 0)
+    ++failed;
+
+  // Mesh follows the analytic surface (top layer seen from above)
+  Terrain.buildAABBtree();
+  context Context;
+  integer id;
+  point Point;
+  real error = 0.0;
+  integer misses = 0;
+  for (integer i = 0; i < 200; ++i)
+  {
+    real x = 1.0 + 1.99 * i;
+    real y = Road.centerline(x) + 3.0 * std::sin(0.7 * i);
+    if (!Terrain.intersection(ray(point(x, y, 100.0), vec3(0.0, 0.0, -1.0)), id, Point, Context))
+      ++misses;
+    else
+      error = std::max(error, std::abs(Point.z() - Road.height(x, y)));
+  }
+  std::cout << "Surface:\tmisses " << misses << "\tmaximum height error " << (error < 0.05) << std::endl;
+  if (misses != 0 || error >= 0.05)
+    ++failed;
+
+  // Target size
+  road Large(7, 1000.0);
+  Large.features(50, 2);
+  Large.fit(100000);
+  std::cout
+      << "Fit:\ttarget 100000\tpredicted within 5% " << (std::abs(Large.size() - 100000) < 5000) << std::endl;
+  if (std::abs(Large.size() - 100000) >= 5000)
+    ++failed;
+
+  // Vehicle workload: tires touch the road (except some over the coarsely meshed
+  // potholes), sensor rays see it
+  workload Workload;
+  Workload.generate(Road, 200, 16, 3);
+  std::vector<segment> Segments;
+  std::vector<integer> Ids;
+  std::vector<vec3> Normals;
+  integer contacts = 0;
+  integer hits = 0;
+  for (integer k = 0; k < Workload.frames(); ++k)
+  {
+    for (integer w = 0; w < 4; ++w)
+    {
+      Terrain.intersection(Workload.tire(k, w), Segments, Ids, Normals, Context);
+      contacts += !Segments.empty();
+    }
+    for (integer i = 0; i < Workload.rays(); ++i)
+      hits += Terrain.intersection(Workload.sensor(k, i), id, Point, Context);
+  }
+  std::cout
+      << "Workload:\tframes " << Workload.frames() << "\ttire contacts " << contacts << "/" << 4 * Workload.frames()
+      << "\tsensor hits " << hits << "/" << Workload.rays() * Workload.frames() << std::endl;
+  if (contacts < 4 * Workload.frames() * 97 / 100 || hits < Workload.rays() * Workload.frames() * 97 / 100)
+    ++failed;
+
+  // Same seed, same workload
+  workload Replay;
+  Replay.generate(Road, 200, 16, 3);
+  integer replayed = 0;
+  for (integer k = 0; k < Workload.frames(); ++k)
+    replayed += Replay.tire(k, 0).center() == Workload.tire(k, 0).center() &&
+                Replay.sensor(k, 5).direction() == Workload.sensor(k, 5).direction();
+  std::cout << "Replay:\tidentical frames " << replayed << "/" << Workload.frames() << std::endl;
+  if (replayed != Workload.frames())
+    ++failed;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 34: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+// TEST 35 - INSTRUMENTATION
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_instrumentation.hh"
+#include "acme_utils.hh"
+#include "acme_workload.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 35 - INSTRUMENTATION" << std::endl;
+
+  integer failed = 0;
+
+  road Road(35, 200.0, 7.0, 0.5);
+  collection Terrain;
+  Road.generate(Terrain);
+  Terrain.buildAABBtree();
+
+  // Run some queries inside a user scope
+  instrumentation::reset();
+  context Context;
+  integer id;
+  point Point;
+  integer hits = 0;
+  std::vector<segment> Segments;
+  std::vector<integer> Ids;
+  std::vector<vec3> Normals;
+  {
+    instrumentation::scope Section("road section");
+    for (integer i = 0; i < 100; ++i)
+    {
+      real x = 1.0 + 1.9 * i;
+      hits += Terrain.intersection(ray(point(x, Road.centerline(x), 100.0), vec3(0.0, 0.0, -1.0)), id, Point, Context);
+    }
+    Terrain.intersection(disk(0.3, point(50.0, Road.centerline(50.0), Road.height(50.0, Road.centerline(50.0)) + 0.29),
+                              vec3(0.0, 1.0, 0.0)),
+                         Segments, Ids, Normals, Context);
+  }
+
+  instrumentation::statistics Ray = instrumentation::snapshot(instrumentation::PROBE_RAY);
+  instrumentation::statistics Disk = instrumentation::snapshot(instrumentation::PROBE_DISK);
+  instrumentation::statistics Scope = instrumentation::snapshot(instrumentation::PROBE_SCOPE);
+  uint64_t binned = 0;
+  for (integer i = 0; i < instrumentation::BINS; ++i)
+    binned += Ray.histogram[i];
+  std::cout
+      << "Enabled:\t" << instrumentation::isEnabled() << std::endl
+      << instrumentation::name(instrumentation::PROBE_RAY)
+      << ":\tcalls " << Ray.calls << "\thits " << Ray.hits << "/" << hits
+      << "\tnodes " << (Ray.nodes > 0) << "\tprimitives " << (Ray.primitives > 0)
+      << "\thistogram " << binned << std::endl
+      << instrumentation::name(instrumentation::PROBE_DISK)
+      << ":\tcalls " << Disk.calls << "\thits " << Disk.hits << "/" << Segments.size() << std::endl
+      << instrumentation::name(instrumentation::PROBE_SCOPE)
+      << ":\tcalls " << Scope.calls << "\tencloses queries " << (Scope.time >= Ray.time) << std::endl;
+
+  if (instrumentation::isEnabled())
+  {
+    if (Ray.calls != 100 || Ray.hits != uint64_t(hits) || Ray.nodes == 0 || Ray.primitives == 0 || binned != 100)
+      ++failed;
+    if (Disk.calls != 1 || Disk.hits != Segments.size() || Scope.calls != 1 || Scope.time < Ray.time)
+      ++failed;
+
+    // Chrome trace export
+    std::string file("acme-test35.json");
+    bool exported = instrumentation::exportTrace(file);
+    std::ifstream Trace(file.c_str());
+    std::stringstream Content;
+    Content << Trace.rdbuf();
+    Trace.close();
+    std::remove(file.c_str());
+    std::string json(Content.str());
+    std::cout
+        << "Trace:\texported " << exported
+        << "\tscope event " << (json.find("\"name\":\"road section\"") != std::string::npos)
+        << "\tray event " << (json.find("\"name\":\"collection/ray\"") != std::string::npos) << std::endl;
+    if (!exported || json.find("\"traceEvents\"") != 1 || json.find("\"road section\"") == std::string::npos)
+      ++failed;
+
+    // Reset
+    instrumentation::reset();
+    Ray = instrumentation::snapshot(instrumentation::PROBE_RAY);
+    std::cout << "Reset:\tcalls " << Ray.calls << "\ttime " << Ray.time << std::endl;
+    if (Ray.calls != 0 || Ray.time != 0)
+      ++failed;
+  }
+  else if (Ray.calls != 0 || Disk.calls != 0)
+    ++failed;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 35: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
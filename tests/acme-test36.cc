@@ -0,0 +1,147 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+// TEST 36 - QUERY TRACE RECORDING AND REPLAY
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_recorder.hh"
+#include "acme_utils.hh"
+#include "acme_workload.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 36 - QUERY TRACE RECORDING AND REPLAY" << std::endl;
+
+  integer failed = 0;
+
+  road Road(36, 200.0, 7.0, 0.5);
+  Road.features(10, 0);
+  collection Terrain;
+  Road.generate(Terrain);
+  Terrain.buildAABBtree(true);
+  workload Workload;
+  Workload.generate(Road, 50, 8, 36);
+
+  // Record the vehicle queries
+  std::string file("acme-test36.trace");
+  recorder Recorder;
+  bool opened = Recorder.open(file, Terrain);
+  Terrain.setRecorder(&Recorder);
+  context Context;
+  integer id;
+  point Point;
+  vec3 Normal;
+  real depth, time;
+  std::vector<segment> Segments;
+  std::vector<integer> Ids;
+  std::vector<vec3> Normals;
+  integer hits = 0;
+  for (integer k = 0; k < Workload.frames(); ++k)
+  {
+    for (integer i = 0; i < Workload.rays(); ++i)
+      hits += Terrain.intersection(Workload.sensor(k, i), id, Point, Context);
+    ray const &Ray = Workload.sensor(k, 0);
+    hits += Terrain.intersection(segment(Ray.origin(), Ray.origin() + 40.0 * Ray.direction().normalized()), id, Point);
+    disk const &Tire = Workload.tire(k, 0);
+    hits += Terrain.intersection(Tire, Segments, Ids, Normals, Context);
+    hits += Terrain.intersection(ball(Tire.radius(), Tire.center()), depth, Normal, Ids, Point, Context);
+    hits += Terrain.intersection(ball(0.3, Tire.center() + vec3(0.0, 0.0, 0.2)), vec3(0.0, 0.0, -0.5),
+                                 time, id, Normal, Point, Context);
+    disk Lifted(Tire);
+    Lifted.center().z() += 0.1;
+    hits += Terrain.intersection(Lifted, vec3(0.1, 0.0, -0.2), 0.2 * Lifted.normal(), 0.01,
+                                 time, id, Normal, Point, Context);
+  }
+  Terrain.setRecorder(nullptr);
+  Terrain.intersection(Workload.sensor(0, 0), id, Point, Context);
+  integer recorded = Recorder.size();
+  bool closed = Recorder.close();
+  integer queries = Workload.frames() * (Workload.rays() + 5);
+  std::cout
+      << "Record:\topened " << opened << "\tclosed " << closed
+      << "\tqueries " << recorded << "/" << queries << "\thits " << hits << std::endl;
+  if (!opened || !closed || recorded != queries)
+    ++failed;
+
+  // Load the snapshot and replay the queries
+  collection Snapshot;
+  std::vector<recorder::entry> Entries;
+  bool loaded = recorder::load(file, Snapshot, Entries);
+  std::remove(file.c_str());
+  integer recorded_hits = 0;
+  integer mismatches = 0;
+  integer kinds[recorder::QUERIES] = {0};
+  for (size_t i = 0; i < Entries.size(); ++i)
+  {
+    recorder::entry Result;
+    recorder::execute(Snapshot, Entries[i], Result, Context);
+    recorded_hits += Entries[i].hit;
+    mismatches += !recorder::compare(Entries[i], Result);
+    ++kinds[Entries[i].kind];
+  }
+  std::cout
+      << "Replay:\tloaded " << loaded << "\tentities " << Snapshot.size() << "/" << Terrain.size()
+      << "\trecords " << Snapshot.hasRecords() << "\tqueries " << Entries.size()
+      << "\thits " << recorded_hits << "\tmismatches " << mismatches << std::endl;
+  for (integer q = 0; q < recorder::QUERIES; ++q)
+    std::cout << recorder::name(static_cast<recorder::query>(q)) << ":\t" << kinds[q] << std::endl;
+  if (!loaded || Snapshot.size() != Terrain.size() || !Snapshot.hasRecords() ||
+      integer(Entries.size()) != queries || recorded_hits != hits || mismatches != 0)
+    ++failed;
+
+  // Replay on a modified scene detects the differences
+  Snapshot.translate(vec3(0.0, 0.0, 0.05));
+  Snapshot.buildAABBtree(true);
+  mismatches = 0;
+  for (size_t i = 0; i < Entries.size(); ++i)
+  {
+    recorder::entry Result;
+    recorder::execute(Snapshot, Entries[i], Result, Context);
+    mismatches += !recorder::compare(Entries[i], Result);
+  }
+  std::cout << "Modified:\tmismatches " << (mismatches > 0) << std::endl;
+  if (mismatches == 0)
+    ++failed;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 36: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+// TEST 37 - MEMORY FOOTPRINT
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_scene.hh"
+#include "acme_utils.hh"
+#include "acme_workload.hh"
+
+using namespace acme;
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 37 - MEMORY FOOTPRINT" << std::endl;
+
+  integer failed = 0;
+
+  // Bytes per triangle of road meshes of growing size
+  real per_triangle[2];
+  integer sizes[2] = {10000, 40000};
+  for (integer k = 0; k < 2; ++k)
+  {
+    road Road(37, 1000.0);
+    Road.features(20, 1);
+    Road.fit(sizes[k]);
+    collection Terrain;
+    Road.generate(Terrain);
+    Terrain.buildAABBtree();
+    footprint Usage(Terrain.memoryUsage());
+    size_t n = Terrain.size();
+    per_triangle[k] = real(Usage.total()) / n;
+
+    std::cout << "Road mesh of " << n << " triangles" << std::endl;
+    std::map<std::string, size_t>::const_iterator it;
+    for (it = Usage.components().begin(); it != Usage.components().end(); ++it)
+      std::cout << "\t" << it->first << ":\t" << it->second << std::endl;
+    std::cout
+        << "\ttotal:\t" << Usage.total() << "\tbytes per triangle " << per_triangle[k] << std::endl;
+
+    if (Usage.bytes("entities/triangle") != n * (sizeof(triangle) - sizeof(void *)) ||
+        Usage.bytes("overhead/vtable pointers") != n * sizeof(void *) ||
+        Usage.bytes("tree/leaf boxes") != n * sizeof(aabb) ||
+        Usage.bytes("entities/") + Usage.bytes("collection/") + Usage.bytes("tree/") +
+                Usage.bytes("blocks tree/") + Usage.bytes("overhead/") !=
+            Usage.total())
+      ++failed;
+
+    // Triangle records and blocks
+    Terrain.buildRecords();
+    Terrain.buildBlocks();
+    footprint Built(Terrain.memoryUsage());
+    std::cout
+        << "\twith records and blocks:\t" << Built.total()
+        << "\tbytes per triangle " << real(Built.total()) / n << std::endl;
+    if (Built.bytes("collection/records") != n * sizeof(triangleRecord) ||
+        Built.bytes("collection/blocks") == 0 || Built.bytes("blocks tree/") == 0)
+      ++failed;
+  }
+  std::cout
+      << "Scaling:\tbytes per triangle ratio within 10% "
+      << (std::abs(per_triangle[1] / per_triangle[0] - 1.0) < 0.1) << std::endl;
+  if (std::abs(per_triangle[1] / per_triangle[0] - 1.0) >= 0.1)
+    ++failed;
+
+  // Scene instances share their geometry
+  road Road(37, 200.0);
+  std::shared_ptr<collection> Track(new collection());
+  Road.generate(*Track);
+  Track->buildAABBtree();
+  scene Scene;
+  for (integer i = 0; i < 3; ++i)
+    Scene.push_back(Track, affine(translate(vec3(0.0, 100.0 * i, 0.0))));
+  Scene.buildAABBtree();
+  footprint Geometry(Track->memoryUsage());
+  footprint Instances(Scene.memoryUsage());
+  std::cout
+      << "Scene:\tgeometry " << Geometry.total() << "\tthree instances " << Instances.total()
+      << "\tinstance overhead " << Instances.total() - Geometry.total() << std::endl;
+  if (Instances.bytes("entities/") != Geometry.bytes("entities/") ||
+      Instances.total() - Geometry.total() > 4096)
+    ++failed;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 37: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}
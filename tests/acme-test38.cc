@@ -0,0 +1,189 @@
+/*
+(***********************************************************************)
+(*                                                                     *)
+(* The ACME project                                                    *)
+(*                                                                     *)
+(* Copyright (c) 2020-2021, Davide Stocco and Enrico Bertolazzi.       *)
+(*                                                                     *)
+(* The ACME project and its components are supplied under the terms of *)
+(* the open source BSD 2-Clause License. The contents of the ACME      *)
+(* project and its components may not be copied or disclosed except in *)
+(* accordance with the terms of the BSD 2-Clause License.              *)
+(*                                                                     *)
+(* URL: https://opensource.org/licenses/BSD-2-Clause                   *)
+(*                                                                     *)
+(*    Davide Stocco                                                    *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: davide.stocco@unitn.it                                   *)
+(*                                                                     *)
+(*    Enrico Bertolazzi                                                *)
+(*    Department of Industrial Engineering                             *)
+(*    University of Trento                                             *)
+(*    e-mail: enrico.bertolazzi@unitn.it                               *)
+(*                                                                     *)
+(***********************************************************************)
+*/
+
+
+// TEST 38 - CACHED BOXES AND DIRTY TRACKING
+
+#include <chrono>
+#include <iostream>
+
+#include "acme.hh"
+#include "acme_collection.hh"
+#include "acme_utils.hh"
+#include "acme_workload.hh"
+
+using namespace acme;
+
+// Count the moved triangles not hit first (at their centroid) by a vertical ray
+integer
+misses(
+    collection const &terrain,
+    std::vector<integer> const &moved,
+    context &scratch)
+{
+  integer missed = 0;
+  integer id;
+  point Point;
+  for (size_t i = 0; i < moved.size(); ++i)
+  {
+    triangle const &Triangle = *std::dynamic_pointer_cast<triangle>(terrain[moved[i]]);
+    point Origin(Triangle.centroid() + vec3(0.0, 0.0, 100.0));
+    if (!terrain.intersection(ray(Origin, vec3(0.0, 0.0, -1.0)), id, Point, scratch) || id != moved[i] ||
+        !Point.isApprox(Triangle.centroid(), EPSILON_LOW))
+      ++missed;
+  }
+  return missed;
+}
+
+// Main function
+int main()
+{
+  std::cout
+      << "TEST 38 - CACHED BOXES AND DIRTY TRACKING" << std::endl;
+
+  integer failed = 0;
+
+  // Two identical roads
+  road Road(38, 200.0);
+  Road.features(10, 0);
+  collection Terrain;
+  collection Reference;
+  Road.generate(Terrain);
+  road(Road).generate(Reference);
+  Terrain.buildAABBtree(true);
+  Terrain.buildBlocks();
+  std::cout
+      << "Road:\ttriangles " << Terrain.size() << "\tdirty after build " << Terrain.countDirty() << std::endl;
+  if (Terrain.countDirty() != 0)
+    ++failed;
+
+  // Plain element access does not mark entities dirty
+  integer triangles = 0;
+  for (integer i = 0; i < Terrain.size(); ++i)
+    triangles += Terrain[i]->isTriangle();
+  std::cout << "Access:\ttriangles " << triangles << "\tdirty " << Terrain.countDirty() << std::endl;
+  if (triangles != Terrain.size() || Terrain.countDirty() != 0)
+    ++failed;
+
+  // Lift 1% of the triangles
+  std::vector<integer> moved;
+  for (integer i = 0; i < Terrain.size(); i += 100)
+  {
+    Terrain.modify(i)->translate(vec3(0.0, 0.0, 2.0));
+    Reference.modify(i)->translate(vec3(0.0, 0.0, 2.0));
+    moved.push_back(i);
+  }
+  integer dirty = Terrain.countDirty();
+  Terrain.refitAABBtree();
+  Reference.buildAABBtree(true);
+  Reference.buildBlocks();
+  context Context;
+  integer refit_misses = misses(Terrain, moved, Context);
+  integer build_misses = misses(Reference, moved, Context);
+  std::cout
+      << "Refit:\tmoved " << moved.size() << "\tdirty " << dirty << "\tdirty after refit " << Terrain.countDirty()
+      << "\tmisses " << refit_misses << "\trebuilt misses " << build_misses
+      << "\tsame root box " << Terrain.ptrAABBtree()->box().isApprox(Reference.ptrAABBtree()->box())
+      << "\trecords " << Terrain.hasRecords() << "\tblocks " << Terrain.hasBlocks() << std::endl;
+  if (dirty != integer(moved.size()) || Terrain.countDirty() != 0 || refit_misses != 0 || build_misses != 0 ||
+      !Terrain.ptrAABBtree()->box().isApprox(Reference.ptrAABBtree()->box()) ||
+      !Terrain.hasRecords() || !Terrain.hasBlocks())
+    ++failed;
+
+  // Entity modified through a kept pointer: boxes are computed fresh by clamp, the
+  // AABB tree is refitted once the entity is marked
+  entity::ptr Kept = Terrain[50];
+  Kept->translate(vec3(0.0, 0.0, 2.0));
+  bool unmarked = Terrain.isDirty(50);
+  aabb::vecptr boxes;
+  Terrain.clamp(boxes);
+  integer different = integer(boxes.size()) != Terrain.size();
+  vec3 min;
+  vec3 max;
+  for (integer i = 0; !different && i < Terrain.size(); ++i)
+  {
+    Terrain[i]->clamp(min, max);
+    different += !boxes[i]->isApprox(aabb(min, max, i, 0));
+  }
+  Terrain.markDirty(50);
+  bool marked = Terrain.isDirty(50);
+  Terrain.refitAABBtree();
+  moved.push_back(50);
+  refit_misses = misses(Terrain, moved, Context);
+  std::cout
+      << "Kept pointer:\tdirty before mark " << unmarked << "\tclamp different " << different
+      << "\tafter mark " << marked << "\tmisses " << refit_misses << "\tblocks " << Terrain.hasBlocks() << std::endl;
+  if (unmarked || different != 0 || !marked || refit_misses != 0 || !Terrain.hasBlocks())
+    ++failed;
+
+  // New entities trigger a full rebuild
+  Terrain.emplace_back<triangle>(point(1.0, 0.0, 50.0), point(1.0, 1.0, 50.0), point(0.0, 0.0, 50.0));
+  dirty = Terrain.countDirty();
+  Terrain.refitAABBtree();
+  moved.assign(1, Terrain.size() - 1);
+  refit_misses = misses(Terrain, moved, Context);
+  std::cout
+      << "New entity:\tdirty " << dirty << "\tdirty after refit " << Terrain.countDirty()
+      << "\tmisses " << refit_misses << "\trecords " << Terrain.hasRecords() << std::endl;
+  if (dirty != 1 || Terrain.countDirty() != 0 || refit_misses != 0 || !Terrain.hasRecords())
+    ++failed;
+
+  // Entity modified through element access without marking: a full build still sees it
+  Terrain[75]->translate(vec3(0.0, 300.0, 0.0));
+  Terrain.buildAABBtree(true);
+  moved.assign(1, 75);
+  integer rebuilt_misses = misses(Terrain, moved, Context);
+  std::cout
+      << "Unmarked rebuild:	misses " << rebuilt_misses << "	dirty after build " << Terrain.countDirty() << std::endl;
+  if (rebuilt_misses != 0 || Terrain.countDirty() != 0)
+    ++failed;
+
+  // Refit of 1% against a full rebuild (AABB tree, records and blocks)
+  Terrain.buildBlocks();
+  for (integer i = 25; i < Terrain.size(); i += 100)
+    Terrain.modify(i)->translate(vec3(0.0, 0.0, 0.1));
+  context::timepoint start = context::clock::now();
+  Terrain.refitAABBtree();
+  real refit = std::chrono::duration<real>(context::clock::now() - start).count();
+  Reference.markDirty();
+  start = context::clock::now();
+  Reference.buildAABBtree(true);
+  Reference.buildBlocks();
+  real rebuild = std::chrono::duration<real>(context::clock::now() - start).count();
+  std::cout
+      << "Timing:\trefit faster than rebuild " << (refit < rebuild) << "\tblocks " << Terrain.hasBlocks() << std::endl;
+  if (refit >= rebuild || !Terrain.hasBlocks())
+    ++failed;
+
+  std::cout
+      << "Failed checks: " << failed << std::endl
+      << std::endl
+      << "TEST 38: Completed" << std::endl;
+
+  // Exit the program
+  return failed == 0 ? 0 : 1;
+}